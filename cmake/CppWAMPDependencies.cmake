@@ -47,7 +47,7 @@ endif()
 set(CPPWAMP_VENDORIZED_JSONCONS_GIT_TAG
     "8940235dd7ff1b08230197002ab31aee03a5ac73")
 
-set(CPPWAMP_MINIMUM_CATCH2_VERSION "2.3.0")
+set(CPPWAMP_MINIMUM_CATCH2_VERSION "2.9.0") # For BENCHMARK
 set(CPPWAMP_VENDORIZED_CATCH2_VERSION "2.13.9")
 set(CPPWAMP_VENDORIZED_CATCH2_GIT_TAG "v${CPPWAMP_VENDORIZED_CATCH2_VERSION}")
 
@@ -13,6 +13,7 @@
 //------------------------------------------------------------------------------
 
 #include <cassert>
+#include <cstddef>
 #include <istream>
 #include <functional>
 #include <memory>
@@ -318,9 +319,40 @@ public:
         return decoder_.decode(source, variant);
     }
 
+    /** Decodes a WAMP message from the given input source, leaving its
+        payload arguments empty.
+        Falls back to decoding the entire message if the decoder does not
+        support this operation, in which case `payloadSkipped` is false.
+        @see @ref CodecDecoder */
+    CPPWAMP_NODISCARD std::error_code decodeHeader(Source source,
+                                                   Variant& variant,
+                                                   bool& payloadSkipped)
+    {
+        return decodeHeaderWith(decoder_, source, variant, payloadSkipped, 0);
+    }
+
 private:
+    using Decoder = SourceDecoder<Format, Source>;
+
+    template <typename D>
+    static auto decodeHeaderWith(D& decoder, Source source, Variant& variant,
+                                 bool& payloadSkipped, int)
+        -> decltype(decoder.decodeHeader(source, variant, payloadSkipped))
+    {
+        return decoder.decodeHeader(source, variant, payloadSkipped);
+    }
+
+    template <typename D>
+    static std::error_code decodeHeaderWith(D& decoder, Source source,
+                                            Variant& variant,
+                                            bool& payloadSkipped, long)
+    {
+        payloadSkipped = false;
+        return decoder.decode(source, variant);
+    }
+
     SinkEncoder<Format, Sink> encoder_;
-    SourceDecoder<Format, Source> decoder_;
+    Decoder decoder_;
 };
 
 //------------------------------------------------------------------------------
@@ -344,6 +376,24 @@ public:
     /** Decodes a variant from the given input source. */
     CPPWAMP_NODISCARD virtual std::error_code decode(Source source,
                                                      Variant& variant) = 0;
+
+    /** Decodes a WAMP message from the given input source, leaving its
+        payload arguments empty.
+        The default implementation decodes the entire message. */
+    CPPWAMP_NODISCARD virtual std::error_code decodeHeader(
+        Source source, Variant& variant, bool& payloadSkipped)
+    {
+        payloadSkipped = false;
+        return decode(source, variant);
+    }
+
+    /** Creates a new, independent codec instance of the same format.
+        The default implementation returns nullptr, meaning that cloning
+        is not supported. */
+    virtual std::shared_ptr<PolymorphicCodecInterface> clone() const
+    {
+        return nullptr;
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -374,10 +424,191 @@ public:
         return codec_.decode(source, variant);
     }
 
+    /** Decodes a WAMP message from the given input source, leaving its
+        payload arguments empty. */
+    CPPWAMP_NODISCARD std::error_code decodeHeader(
+        Source source, Variant& variant, bool& payloadSkipped) override
+    {
+        return codec_.decodeHeader(source, variant, payloadSkipped);
+    }
+
+    /** Creates a new, independent codec instance of the same format. */
+    std::shared_ptr<PolymorphicCodecInterface<Sink, Source>>
+    clone() const override
+    {
+        return std::make_shared<PolymorphicCodec>();
+    }
+
 private:
     Codec<Format, Sink, Source> codec_;
 };
 
+//------------------------------------------------------------------------------
+/** Usage statistics of a thread's pooled codec.
+    @see wamp::CodecPool */
+//------------------------------------------------------------------------------
+struct CPPWAMP_API CodecPoolStats
+{
+    /// Number of encoding operations performed.
+    std::size_t encodeCount = 0;
+
+    /// Number of decoding operations, including header-only ones.
+    std::size_t decodeCount = 0;
+
+    /// Largest number of bytes produced by a single encoding operation.
+    /// Not tracked for stream sinks.
+    std::size_t encodedBytesHighWater = 0;
+
+    /// Largest number of bytes consumed by a single decoding operation.
+    /// Not tracked for stream sources.
+    std::size_t decodedBytesHighWater = 0;
+};
+
+namespace internal
+{
+
+inline std::size_t codecByteCount(const StringSink& s)
+{
+    return s.output().size();
+}
+
+inline std::size_t codecByteCount(const BufferSink& s)
+{
+    return s.output().size();
+}
+
+inline std::size_t codecByteCount(const StringSource& s)
+{
+    return s.input().size();
+}
+
+inline std::size_t codecByteCount(const BufferSource& s)
+{
+    return s.input().size();
+}
+
+inline std::size_t codecByteCount(const StreamSink&) {return 0;}
+
+inline std::size_t codecByteCount(const StreamSource&) {return 0;}
+
+inline void raiseHighWaterMark(std::size_t& mark, std::size_t n)
+{
+    if (n > mark)
+        mark = n;
+}
+
+} // namespace internal
+
+//------------------------------------------------------------------------------
+/** Provides a single codec instance per thread, for a given serialization
+    format and source/sink combination.
+    Pooled codecs, obtained via AnyCodec::pooled, all share the calling
+    thread's instance, so that sessions running on the same executor thread
+    do not each hold their own parser/encoder state and buffers. As encoding
+    and decoding operations run to completion, an instance is never used
+    concurrently.
+    @tparam TFormat Serialization format tag (e.g. Json).
+    @tparam TSink Output sink type, a specialization of OutputSink.
+    @tparam TSource Input source type, a specialization of InputSource. */
+//------------------------------------------------------------------------------
+template <typename TFormat, typename TSink, typename TSource>
+class CPPWAMP_API CodecPool
+{
+public:
+    /// The codec type that is pooled.
+    using CodecType = Codec<TFormat, TSink, TSource>;
+
+    /** Obtains the calling thread's codec instance. */
+    static CodecType& local()
+    {
+        static thread_local CodecType codec;
+        return codec;
+    }
+
+    /** Obtains the usage statistics of the calling thread's codec
+        instance. */
+    static CodecPoolStats stats() {return localStats();}
+
+    /** Resets the usage statistics of the calling thread's codec
+        instance. */
+    static void resetStats() {localStats() = CodecPoolStats{};}
+
+private:
+    static CodecPoolStats& localStats()
+    {
+        static thread_local CodecPoolStats stats;
+        return stats;
+    }
+
+    template <typename, typename, typename> friend class PooledCodec;
+};
+
+//------------------------------------------------------------------------------
+/** Polymorphic codec that delegates to the calling thread's CodecPool
+    instance.
+    @tparam TFormat Serialization format tag (e.g. Json).
+    @tparam TSink Output sink type, a specialization of OutputSink.
+    @tparam TSource Input source type, a specialization of InputSource. */
+//------------------------------------------------------------------------------
+template <typename TFormat, typename TSink, typename TSource>
+class CPPWAMP_API PooledCodec
+    : public PolymorphicCodecInterface<TSink, TSource>
+{
+public:
+    using Format = TFormat; ///< The encoding/decoding format (e.g. Json).
+    using Sink = TSink;     ///< Output sink type in which to encode.
+    using Source = TSource; ///< Input source type from which to decode.
+
+    /** Encodes the given variant to the given output sink. */
+    void encode(const Variant& variant, Sink sink) override
+    {
+        auto& stats = Pool::localStats();
+        auto before = internal::codecByteCount(sink);
+        Pool::local().encode(variant, sink);
+        auto after = internal::codecByteCount(sink);
+        ++stats.encodeCount;
+        if (after > before)
+            internal::raiseHighWaterMark(stats.encodedBytesHighWater,
+                                         after - before);
+    }
+
+    /** Decodes a variant from the given input source. */
+    CPPWAMP_NODISCARD std::error_code decode(Source source,
+                                             Variant& variant) override
+    {
+        noteDecode(source);
+        return Pool::local().decode(source, variant);
+    }
+
+    /** Decodes a WAMP message from the given input source, leaving its
+        payload arguments empty. */
+    CPPWAMP_NODISCARD std::error_code decodeHeader(
+        Source source, Variant& variant, bool& payloadSkipped) override
+    {
+        noteDecode(source);
+        return Pool::local().decodeHeader(source, variant, payloadSkipped);
+    }
+
+    /** Creates another pooled codec of the same format. The clone uses
+        the instance of whichever thread it is called from. */
+    std::shared_ptr<PolymorphicCodecInterface<Sink, Source>>
+    clone() const override
+    {
+        return std::make_shared<PooledCodec>();
+    }
+
+private:
+    using Pool = CodecPool<Format, Sink, Source>;
+
+    static void noteDecode(const Source& source)
+    {
+        auto& stats = Pool::localStats();
+        ++stats.decodeCount;
+        internal::raiseHighWaterMark(stats.decodedBytesHighWater,
+                                     internal::codecByteCount(source));
+    }
+};
+
 //------------------------------------------------------------------------------
 /** Wrapper that type-erases a polymorphic codec.
     @tparam TSink Output sink type, a specialization of OutputSink.
@@ -399,6 +630,17 @@ public:
         : codec_(std::make_shared<PolymorphicCodec<TFormat, Sink, Source>>())
     {}
 
+    /** Creates a codec that shares the calling thread's CodecPool instance
+        for the given serialization format, instead of owning its own.
+        @see wamp::CodecPool */
+    template <typename TFormat>
+    static AnyCodec pooled(TFormat)
+    {
+        using Pooled = PooledCodec<TFormat, Sink, Source>;
+        std::shared_ptr<Interface> codec = std::make_shared<Pooled>();
+        return AnyCodec(std::move(codec));
+    }
+
     /** Returns false if the AnyCodec is empty. */
     explicit operator bool() const {return codec_ != nullptr;}
 
@@ -416,8 +658,33 @@ public:
         return codec_->decode(source, variant);
     }
 
+    /** Decodes a WAMP message from the given input source, leaving its
+        payload arguments empty.
+        @see @ref CodecDecoder */
+    CPPWAMP_NODISCARD std::error_code decodeHeader(Source source,
+                                                   Variant& variant,
+                                                   bool& payloadSkipped)
+    {
+        assert(codec_ != nullptr);
+        return codec_->decodeHeader(source, variant, payloadSkipped);
+    }
+
+    /** Creates a new, independent codec instance of the same format.
+        Unlike copies of an AnyCodec, which share the same underlying codec,
+        the returned codec can be used concurrently with this one. The
+        returned codec is empty if the underlying codec cannot be cloned. */
+    AnyCodec clone() const
+    {
+        assert(codec_ != nullptr);
+        return AnyCodec(codec_->clone());
+    }
+
 private:
     using Interface = PolymorphicCodecInterface<Sink, Source>;
+
+    explicit AnyCodec(std::shared_ptr<Interface> codec)
+        : codec_(std::move(codec))
+    {}
     std::shared_ptr<Interface> codec_;
 };
 
@@ -445,19 +712,36 @@ public:
     /** Constructor taking a serialization format tag. */
     template <typename TFormat>
     explicit CodecBuilder(TFormat)
-        : builder_([]() -> AnyCodecType {return AnyCodecType(TFormat{});}),
+        : builder_(
+            [](bool pooled) -> AnyCodecType
+            {
+                return pooled ? AnyCodecType::pooled(TFormat{})
+                              : AnyCodecType(TFormat{});
+            }),
           id_(TFormat::id())
     {}
 
+    /** Enables or disables the building of pooled codecs.
+        @see AnyCodec::pooled */
+    CodecBuilder& withPooling(bool enabled = true)
+    {
+        pooled_ = enabled;
+        return *this;
+    }
+
     int id() const {return id_;}
 
+    /** Returns true if pooled codecs are to be built. */
+    bool pooling() const {return pooled_;}
+
     /** Builds and returns a codec for the serialzation format that was given
         during construction. */
-    AnyCodecType operator()() const {return builder_();}
+    AnyCodecType operator()() const {return builder_(pooled_);}
 
 private:
-    std::function<AnyCodecType ()> builder_;
+    std::function<AnyCodecType (bool)> builder_;
     int id_;
+    bool pooled_ = false;
 };
 
 /// Builds a type-erased codec for string sources/sinks.
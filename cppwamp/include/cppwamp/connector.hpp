@@ -148,6 +148,12 @@ public:
     /** Constructor taking a LegacyConnector. */
     explicit ConnectionWish(const LegacyConnector& c);
 
+    /** Enables or disables codec state pooling, where sessions on the same
+        thread share a single encoder/decoder instance for the desired
+        serialization format.
+        @see AnyCodec::pooled */
+    ConnectionWish& withCodecPooling(bool enabled = true);
+
     /** Obtains the numeric codec ID of the desired serialization format. */
     int codecId() const;
 
@@ -380,7 +380,8 @@ enum class TransportErrc
     aborted     = 1, ///< Operation aborted
     failed      = 2, ///< Operation failed
     badTxLength = 3, ///< Outgoing message exceeds maximum length
-    badRxLength = 4  ///< Incoming message exceeds maximum length
+    badRxLength = 4, ///< Incoming message exceeds maximum length
+    wouldBlock  = 5  ///< Transmit queue is above its high watermark
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,505 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_FLATMAP_HPP
+#define CPPWAMP_FLATMAP_HPP
+
+//------------------------------------------------------------------------------
+/** @file
+    @brief Contains the FlatMap associative container. */
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace wamp
+{
+
+//------------------------------------------------------------------------------
+/** Associative container that keeps its key-value pairs sorted in contiguous
+    storage.
+
+    FlatMap offers the same interface as `std::map` for lookup, insertion,
+    erasure, iteration and comparison, but stores its elements in a single
+    `std::vector`. For the small dictionaries typically found in WAMP messages,
+    this avoids one allocation per element and improves locality, at the cost
+    of linear-time insertion and erasure.
+
+    Differences with `std::map`:
+    - Insertion and erasure invalidate all iterators and references.
+    - `value_type` is `std::pair<Key, T>` instead of `std::pair<const Key, T>`.
+      Keys must not be modified via iterators.
+
+    @tparam TKey     The key type
+    @tparam TValue   The mapped type
+    @tparam TCompare Strict weak ordering used to sort keys */
+//------------------------------------------------------------------------------
+template <typename TKey, typename TValue, typename TCompare = std::less<TKey>>
+class FlatMap
+{
+private:
+    using Storage = std::vector<std::pair<TKey, TValue>>;
+
+public:
+    using key_type               = TKey;
+    using mapped_type            = TValue;
+    using value_type             = std::pair<TKey, TValue>;
+    using size_type              = typename Storage::size_type;
+    using difference_type        = typename Storage::difference_type;
+    using key_compare            = TCompare;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using pointer                = value_type*;
+    using const_pointer          = const value_type*;
+    using iterator               = typename Storage::iterator;
+    using const_iterator         = typename Storage::const_iterator;
+    using reverse_iterator       = typename Storage::reverse_iterator;
+    using const_reverse_iterator = typename Storage::const_reverse_iterator;
+
+    /** Function object for comparing elements by their keys. */
+    class value_compare
+    {
+    public:
+        bool operator()(const value_type& lhs, const value_type& rhs) const
+        {
+            return comp(lhs.first, rhs.first);
+        }
+
+    protected:
+        explicit value_compare(TCompare c) : comp(std::move(c)) {}
+
+        TCompare comp;
+
+        friend class FlatMap;
+    };
+
+    /// @name Construction
+    /// @{
+
+    /** Default constructor. */
+    FlatMap() = default;
+
+    /** Constructs using the given key comparison function. */
+    explicit FlatMap(const TCompare& comp) : comp_(comp) {}
+
+    /** Constructs from a range of elements. When there are elements with
+        equivalent keys, only the first one is kept. */
+    template <typename TInputIt>
+    FlatMap(TInputIt first, TInputIt last, const TCompare& comp = TCompare())
+        : comp_(comp)
+    {
+        insert(first, last);
+    }
+
+    /** Constructs from an initializer list. When there are elements with
+        equivalent keys, only the first one is kept. */
+    FlatMap(std::initializer_list<value_type> list,
+            const TCompare& comp = TCompare())
+        : FlatMap(list.begin(), list.end(), comp)
+    {}
+
+    /** Replaces the contents with the elements of an initializer list. */
+    FlatMap& operator=(std::initializer_list<value_type> list)
+    {
+        clear();
+        insert(list.begin(), list.end());
+        return *this;
+    }
+    /// @}
+
+    /// @name Element Access
+    /// @{
+
+    /** Accesses the element with the given key, with bounds checking.
+        @throws std::out_of_range if there is no such element. */
+    TValue& at(const TKey& key)
+    {
+        auto iter = find(key);
+        if (iter == end())
+            throw std::out_of_range("wamp::FlatMap::at: key not found");
+        return iter->second;
+    }
+
+    /** Accesses the element with the given key, with bounds checking.
+        @throws std::out_of_range if there is no such element. */
+    const TValue& at(const TKey& key) const
+    {
+        auto iter = find(key);
+        if (iter == end())
+            throw std::out_of_range("wamp::FlatMap::at: key not found");
+        return iter->second;
+    }
+
+    /** Accesses or inserts the element with the given key. */
+    TValue& operator[](const TKey& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    /** Accesses or inserts the element with the given key. */
+    TValue& operator[](TKey&& key)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+    /// @}
+
+    /// @name Iterators
+    /// @{
+
+    iterator begin() noexcept {return elements_.begin();}
+
+    const_iterator begin() const noexcept {return elements_.begin();}
+
+    const_iterator cbegin() const noexcept {return elements_.cbegin();}
+
+    iterator end() noexcept {return elements_.end();}
+
+    const_iterator end() const noexcept {return elements_.end();}
+
+    const_iterator cend() const noexcept {return elements_.cend();}
+
+    reverse_iterator rbegin() noexcept {return elements_.rbegin();}
+
+    const_reverse_iterator rbegin() const noexcept {return elements_.rbegin();}
+
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return elements_.crbegin();
+    }
+
+    reverse_iterator rend() noexcept {return elements_.rend();}
+
+    const_reverse_iterator rend() const noexcept {return elements_.rend();}
+
+    const_reverse_iterator crend() const noexcept {return elements_.crend();}
+    /// @}
+
+    /// @name Capacity
+    /// @{
+
+    bool empty() const noexcept {return elements_.empty();}
+
+    size_type size() const noexcept {return elements_.size();}
+
+    size_type max_size() const noexcept {return elements_.max_size();}
+
+    /** Returns the number of elements that can be held without
+        reallocating. */
+    size_type capacity() const noexcept {return elements_.capacity();}
+
+    /** Preallocates storage for the given number of elements. */
+    void reserve(size_type n) {elements_.reserve(n);}
+
+    /** Releases unused storage. */
+    void shrink_to_fit() {elements_.shrink_to_fit();}
+    /// @}
+
+    /// @name Modifiers
+    /// @{
+
+    void clear() noexcept {elements_.clear();}
+
+    /** Inserts the given element if its key is not already present. */
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return emplaceKeyed(value.first, value);
+    }
+
+    /** Inserts the given element if its key is not already present. */
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return emplaceKeyed(value.first, std::move(value));
+    }
+
+    /** Inserts an element convertible to value_type if its key is not
+        already present. */
+    template <typename P,
+              typename std::enable_if<
+                  std::is_constructible<value_type, P&&>::value, int>::type = 0>
+    std::pair<iterator, bool> insert(P&& value)
+    {
+        return emplace(std::forward<P>(value));
+    }
+
+    /** Inserts the given element, using the hint if it is the correct
+        insertion point. */
+    iterator insert(const_iterator hint, const value_type& value)
+    {
+        return emplace_hint(hint, value);
+    }
+
+    /** Inserts the given element, using the hint if it is the correct
+        insertion point. */
+    iterator insert(const_iterator hint, value_type&& value)
+    {
+        return emplace_hint(hint, std::move(value));
+    }
+
+    /** Inserts an element convertible to value_type, using the hint if it
+        is the correct insertion point. */
+    template <typename P,
+              typename std::enable_if<
+                  std::is_constructible<value_type, P&&>::value, int>::type = 0>
+    iterator insert(const_iterator hint, P&& value)
+    {
+        return emplace_hint(hint, std::forward<P>(value));
+    }
+
+    /** Inserts the elements of the given range whose keys are not already
+        present. */
+    template <typename TInputIt>
+    void insert(TInputIt first, TInputIt last)
+    {
+        for (; first != last; ++first)
+            emplace_hint(cend(), *first);
+    }
+
+    /** Inserts the elements of the given initializer list whose keys are not
+        already present. */
+    void insert(std::initializer_list<value_type> list)
+    {
+        insert(list.begin(), list.end());
+    }
+
+    /** Inserts an element constructed from the given arguments if its key is
+        not already present. */
+    template <typename... TArgs>
+    std::pair<iterator, bool> emplace(TArgs&&... args)
+    {
+        value_type value(std::forward<TArgs>(args)...);
+        return emplaceKeyed(value.first, std::move(value));
+    }
+
+    /** Inserts an element constructed from the given arguments if its key is
+        not already present, using the hint if it is the correct insertion
+        point. Appending elements in key order with an end() hint takes
+        amortized constant time. */
+    template <typename... TArgs>
+    iterator emplace_hint(const_iterator hint, TArgs&&... args)
+    {
+        value_type value(std::forward<TArgs>(args)...);
+        const auto& key = value.first;
+        bool fitsBefore = hint == cend() || comp_(key, hint->first);
+        bool fitsAfter = hint == cbegin() || comp_(std::prev(hint)->first, key);
+        if (fitsBefore && fitsAfter)
+            return insertAt(hint, std::move(value));
+        return emplaceKeyed(key, std::move(value)).first;
+    }
+
+    /** Inserts an element with the given key and a mapped value constructed
+        from the given arguments, if the key is not already present. */
+    template <typename... TArgs>
+    std::pair<iterator, bool> try_emplace(const TKey& key, TArgs&&... args)
+    {
+        auto pos = lower_bound(key);
+        if (pos != end() && !comp_(key, pos->first))
+            return {pos, false};
+        pos = insertAt(
+            pos, std::piecewise_construct, std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<TArgs>(args)...));
+        return {pos, true};
+    }
+
+    /** Inserts an element with the given key and a mapped value constructed
+        from the given arguments, if the key is not already present. */
+    template <typename... TArgs>
+    std::pair<iterator, bool> try_emplace(TKey&& key, TArgs&&... args)
+    {
+        auto pos = lower_bound(key);
+        if (pos != end() && !comp_(key, pos->first))
+            return {pos, false};
+        pos = insertAt(
+            pos, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)),
+            std::forward_as_tuple(std::forward<TArgs>(args)...));
+        return {pos, true};
+    }
+
+    /** Erases the element at the given position.
+        @returns An iterator following the erased element. */
+    iterator erase(const_iterator pos) {return elements_.erase(pos);}
+
+    /** Erases the element at the given position.
+        @returns An iterator following the erased element. */
+    iterator erase(iterator pos) {return elements_.erase(pos);}
+
+    /** Erases the elements in the given range.
+        @returns An iterator following the last erased element. */
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        return elements_.erase(first, last);
+    }
+
+    /** Erases the element with the given key, if any.
+        @returns The number of elements erased. */
+    size_type erase(const TKey& key)
+    {
+        auto pos = find(key);
+        if (pos == end())
+            return 0;
+        elements_.erase(pos);
+        return 1;
+    }
+
+    void swap(FlatMap& other) noexcept
+    {
+        using std::swap;
+        swap(elements_, other.elements_);
+        swap(comp_, other.comp_);
+    }
+    /// @}
+
+    /// @name Lookup
+    /// @{
+
+    size_type count(const TKey& key) const {return find(key) != end() ? 1 : 0;}
+
+    iterator find(const TKey& key)
+    {
+        auto pos = lower_bound(key);
+        return (pos != end() && !comp_(key, pos->first)) ? pos : end();
+    }
+
+    const_iterator find(const TKey& key) const
+    {
+        auto pos = lower_bound(key);
+        return (pos != end() && !comp_(key, pos->first)) ? pos : end();
+    }
+
+    std::pair<iterator, iterator> equal_range(const TKey& key)
+    {
+        auto pos = find(key);
+        return {pos, pos == end() ? pos : std::next(pos)};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const TKey& key) const
+    {
+        auto pos = find(key);
+        return {pos, pos == end() ? pos : std::next(pos)};
+    }
+
+    iterator lower_bound(const TKey& key)
+    {
+        return std::lower_bound(begin(), end(), key, KeyLess{comp_});
+    }
+
+    const_iterator lower_bound(const TKey& key) const
+    {
+        return std::lower_bound(begin(), end(), key, KeyLess{comp_});
+    }
+
+    iterator upper_bound(const TKey& key)
+    {
+        return std::upper_bound(begin(), end(), key, KeyLess{comp_});
+    }
+
+    const_iterator upper_bound(const TKey& key) const
+    {
+        return std::upper_bound(begin(), end(), key, KeyLess{comp_});
+    }
+    /// @}
+
+    /// @name Observers
+    /// @{
+
+    key_compare key_comp() const {return comp_;}
+
+    value_compare value_comp() const {return value_compare(comp_);}
+    /// @}
+
+    /// @name Comparison
+    /// @{
+
+    friend bool operator==(const FlatMap& lhs, const FlatMap& rhs)
+    {
+        return lhs.elements_ == rhs.elements_;
+    }
+
+    friend bool operator!=(const FlatMap& lhs, const FlatMap& rhs)
+    {
+        return lhs.elements_ != rhs.elements_;
+    }
+
+    friend bool operator<(const FlatMap& lhs, const FlatMap& rhs)
+    {
+        return lhs.elements_ < rhs.elements_;
+    }
+
+    friend bool operator<=(const FlatMap& lhs, const FlatMap& rhs)
+    {
+        return lhs.elements_ <= rhs.elements_;
+    }
+
+    friend bool operator>(const FlatMap& lhs, const FlatMap& rhs)
+    {
+        return lhs.elements_ > rhs.elements_;
+    }
+
+    friend bool operator>=(const FlatMap& lhs, const FlatMap& rhs)
+    {
+        return lhs.elements_ >= rhs.elements_;
+    }
+
+    friend void swap(FlatMap& lhs, FlatMap& rhs) noexcept {lhs.swap(rhs);}
+    /// @}
+
+private:
+    static constexpr size_type minCapacity = 4;
+
+    // Compares elements with keys, for use with std::lower_bound and
+    // std::upper_bound.
+    struct KeyLess
+    {
+        bool operator()(const value_type& elem, const TKey& key) const
+        {
+            return comp(elem.first, key);
+        }
+
+        bool operator()(const TKey& key, const value_type& elem) const
+        {
+            return comp(key, elem.first);
+        }
+
+        const TCompare& comp;
+    };
+
+    template <typename... TArgs>
+    iterator insertAt(const_iterator pos, TArgs&&... args)
+    {
+        // Skip the smallest reallocation steps, as most dictionaries in WAMP
+        // messages have a handful of entries.
+        if (elements_.capacity() == 0)
+        {
+            elements_.reserve(minCapacity);
+            pos = elements_.cbegin();
+        }
+        return elements_.emplace(pos, std::forward<TArgs>(args)...);
+    }
+
+    template <typename TArg>
+    std::pair<iterator, bool> emplaceKeyed(const TKey& key, TArg&& value)
+    {
+        auto pos = lower_bound(key);
+        if (pos != end() && !comp_(key, pos->first))
+            return {pos, false};
+        pos = insertAt(pos, std::forward<TArg>(value));
+        return {pos, true};
+    }
+
+    Storage elements_;
+    TCompare comp_;
+};
+
+} // namespace wamp
+
+#endif // CPPWAMP_FLATMAP_HPP
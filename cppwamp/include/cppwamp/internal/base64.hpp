@@ -7,12 +7,14 @@
 #ifndef CPPWAMP_BASE64_HPP
 #define CPPWAMP_BASE64_HPP
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
 #include <vector>
 #include "../config.hpp"
 #include "../erroror.hpp"
+#include "base64simd.hpp"
 
 namespace wamp
 {
@@ -20,6 +22,9 @@ namespace wamp
 namespace internal
 {
 
+//------------------------------------------------------------------------------
+// Base64 codec, which uses vectorized kernels for the bulk of the data when
+// the CPU supports them.
 //------------------------------------------------------------------------------
 class Base64
 {
@@ -27,75 +32,94 @@ public:
     template <typename TSink>
     static void encode(const void* data, std::size_t size, TSink& sink)
     {
-        Quad quad;
-        Byte sextet;
+        encode(data, size, sink, Base64Kernels::detect());
+    }
+
+    // Encodes using the given kernels, which must be supported by the CPU.
+    template <typename TSink>
+    static void encode(const void* data, std::size_t size, TSink& sink,
+                       Base64Simd simd)
+    {
+        // Whole triplets are encoded a chunk at a time into a local buffer,
+        // to amortize the cost of appending to the sink.
+        using SinkByte = typename TSink::value_type;
+        std::array<char, chunkQuads * 4> chunk;
+        const std::size_t maxTriplets = chunkQuads;
         auto byte = static_cast<const Byte*>(data);
-        auto end = byte + size;
-        while (byte != end)
+        while (size >= 3)
+        {
+            auto count = std::min(size / 3, maxTriplets) * 3;
+            auto length = encodeTriplets(byte, count, chunk.data(), simd);
+            sink.append(reinterpret_cast<const SinkByte*>(chunk.data()),
+                        length);
+            byte += count;
+            size -= count;
+        }
+
+        if (size == 0)
+            return;
+
+        Quad quad;
+        quad[0] = charFromSextet( (byte[0] >> 2) & 0x3f );
+        Byte sextet = (byte[0] << 4) & 0x30;
+        if (size == 2)
         {
-            quad[0] = charFromSextet( (*byte >> 2) & 0x3f );
-            sextet = (*byte << 4) & 0x30;
-            ++byte;
-
-            if (byte != end)
-            {
-                sextet |= (*byte >> 4) & 0x0f;
-                quad[1] = charFromSextet(sextet);
-                sextet = (*byte << 2) & 0x3c;
-                ++byte;
-
-                if (byte != end)
-                {
-                    sextet |= (*byte >> 6) & 0x03;
-                    quad[2] = charFromSextet(sextet);
-                    quad[3] = charFromSextet( *byte & 0x3f );
-                    ++byte;
-                }
-                else
-                {
-                    quad[2] = charFromSextet(sextet);
-                    quad[3] = pad;
-                }
-            }
-            else
-            {
-                quad[1] = charFromSextet(sextet);
-                quad[2] = pad;
-                quad[3] = pad;
-            }
-
-            using SinkByte = typename TSink::value_type;
-            auto ptr = reinterpret_cast<const SinkByte*>(quad.data());
-            sink.append(ptr, quad.size());
+            sextet |= (byte[1] >> 4) & 0x0f;
+            quad[1] = charFromSextet(sextet);
+            quad[2] = charFromSextet( (byte[1] << 2) & 0x3c );
         }
+        else
+        {
+            quad[1] = charFromSextet(sextet);
+            quad[2] = pad;
+        }
+        quad[3] = pad;
+        sink.append(reinterpret_cast<const SinkByte*>(quad.data()),
+                    quad.size());
     }
 
     template <typename TOutputByteContainer>
     CPPWAMP_NODISCARD static std::error_code
     decode(const void* data, size_t length, TOutputByteContainer& output)
+    {
+        return decode(data, length, output, Base64Kernels::detect());
+    }
+
+    // Decodes using the given kernels, which must be supported by the CPU.
+    template <typename TOutputByteContainer>
+    CPPWAMP_NODISCARD static std::error_code
+    decode(const void* data, size_t length, TOutputByteContainer& output,
+           Base64Simd simd)
     {
         if (length == 0)
             return {};
         if (length % 4 != 0)
             return make_error_code(DecodingErrc::badBase64Length);
 
-        ErrorOr<Triplet> triplet;
         auto str = static_cast<const char*>(data);
-        const char* quad = str;
-        auto end = str + length - 4;
-        assert(end >= str);
-        for (; quad < end; quad += 4)
+        auto bodyLength = length - 4;
+        output.reserve(output.size() + (length / 4) * 3);
+
+        // All quads but the last cannot contain padding, and are decoded
+        // a chunk at a time into a local buffer.
+        std::array<Byte, chunkQuads * 3 + Base64Kernels::decodeSlack> chunk;
+        std::size_t offset = 0;
+        while (offset < bodyLength)
         {
-            triplet = tripletFromQuad(quad, false);
-            if (!triplet)
-                return triplet.error();
-            append(*triplet, output);
+            auto count = std::min<std::size_t>(bodyLength - offset,
+                                               chunkQuads * 4);
+            std::size_t size = 0;
+            auto ec = decodeQuads(str + offset, count, chunk.data(), size,
+                                  simd);
+            append(chunk.data(), size, output);
+            if (ec)
+                return ec;
+            offset += count;
         }
 
-        assert((quad + 4) == (str + length));
-
+        const char* quad = str + bodyLength;
         unsigned lastTripletCount = 1;
-        triplet = tripletFromQuad(quad, true);
+        auto triplet = tripletFromQuad(quad, true);
         if (!triplet)
             return triplet.error();
         if (quad[0] == pad || quad[1] == pad)
@@ -109,10 +133,7 @@ public:
         else
             lastTripletCount = (quad[3] == pad) ? 2 : 3;
 
-        triplet = tripletFromQuad(quad, true);
-        if (!triplet)
-            return triplet.error();
-        append(*triplet, lastTripletCount, output);
+        append(triplet->data(), lastTripletCount, output);
 
         return {};
     }
@@ -124,6 +145,9 @@ private:
 
     static constexpr char pad = '=';
 
+    // Number of quads per chunk of encoded or decoded data.
+    static constexpr std::size_t chunkQuads = 256;
+
     static char charFromSextet(uint8_t sextet)
     {
         static const char alphabet[] =
@@ -229,19 +253,51 @@ private:
         return sextet;
     }
 
-    template <typename TOutputByteContainer>
-    static void append(Triplet triplet, size_t length,
-                       TOutputByteContainer& output)
+    // Encodes the given whole number of triplets, returning the number of
+    // characters written.
+    static std::size_t encodeTriplets(const Byte* in, std::size_t size,
+                                      char* out, Base64Simd simd)
     {
-        using OutputByte = typename TOutputByteContainer::value_type;
-        auto data = reinterpret_cast<const OutputByte*>(triplet.data());
-        output.insert(output.end(), data, data + length);
+        auto done = Base64Kernels::encode(simd, in, size, out);
+        auto chars = out + (done / 3) * 4;
+        for (auto byte = in + done; byte != in + size; byte += 3)
+        {
+            *chars++ = charFromSextet( (byte[0] >> 2) & 0x3f );
+            *chars++ = charFromSextet( ((byte[0] << 4) & 0x30) |
+                                       ((byte[1] >> 4) & 0x0f) );
+            *chars++ = charFromSextet( ((byte[1] << 2) & 0x3c) |
+                                       ((byte[2] >> 6) & 0x03) );
+            *chars++ = charFromSextet( byte[2] & 0x3f );
+        }
+        return (size / 3) * 4;
+    }
+
+    // Decodes the given whole number of unpadded quads, reporting the number
+    // of bytes written, which stops short upon an error.
+    static std::error_code decodeQuads(const char* in, std::size_t length,
+                                       Byte* out, std::size_t& size,
+                                       Base64Simd simd)
+    {
+        auto done = Base64Kernels::decode(simd, in, length, out);
+        size = (done / 4) * 3;
+        for (auto quad = in + done; quad != in + length; quad += 4)
+        {
+            auto triplet = tripletFromQuad(quad, false);
+            if (!triplet)
+                return triplet.error();
+            std::copy(triplet->begin(), triplet->end(), out + size);
+            size += 3;
+        }
+        return {};
     }
 
     template <typename TOutputByteContainer>
-    static void append(Triplet triplet, TOutputByteContainer& output)
+    static void append(const Byte* data, size_t length,
+                       TOutputByteContainer& output)
     {
-        append(triplet, triplet.size(), output);
+        using OutputByte = typename TOutputByteContainer::value_type;
+        auto bytes = reinterpret_cast<const OutputByte*>(data);
+        output.insert(output.end(), bytes, bytes + length);
     }
 }; // class Base64
 
@@ -0,0 +1,352 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_BASE64SIMD_HPP
+#define CPPWAMP_BASE64SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Vectorized kernels are only provided for x86 targets built with GCC or
+// Clang, where function-level target attributes allow selecting the
+// instruction set at runtime without special compiler flags. Defining
+// CPPWAMP_NO_SIMD_BASE64 forces the scalar implementation everywhere.
+#if !defined(CPPWAMP_NO_SIMD_BASE64) \
+    && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define CPPWAMP_HAS_SIMD_BASE64 1
+#include <immintrin.h>
+#define CPPWAMP_BASE64_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CPPWAMP_HAS_SIMD_BASE64 0
+#endif
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Instruction sets for which vectorized Base64 kernels are available.
+//------------------------------------------------------------------------------
+enum class Base64Simd
+{
+    none,
+    ssse3,
+    avx2
+};
+
+//------------------------------------------------------------------------------
+// Vectorized Base64 kernels, based on the techniques described by
+// Wojciech Muła and Daniel Lemire in "Faster Base64 Encoding and Decoding
+// using AVX2 Instructions" (ACM TWEB, 2018).
+//
+// The kernels only process whole blocks, and leave the remaining input, as
+// well as any invalid input, for the scalar implementation to handle. They
+// return the number of input bytes that were consumed.
+//------------------------------------------------------------------------------
+class Base64Kernels
+{
+public:
+    // Output bytes that may be written past the end of the decoded data.
+    static constexpr std::size_t decodeSlack = 8;
+
+    static Base64Simd detect()
+    {
+#if CPPWAMP_HAS_SIMD_BASE64
+        static const Base64Simd level = []() -> Base64Simd
+        {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return Base64Simd::avx2;
+            if (__builtin_cpu_supports("ssse3"))
+                return Base64Simd::ssse3;
+            return Base64Simd::none;
+        }();
+        return level;
+#else
+        return Base64Simd::none;
+#endif
+    }
+
+    static std::size_t encode(Base64Simd level, const uint8_t* in,
+                              std::size_t size, char* out)
+    {
+#if CPPWAMP_HAS_SIMD_BASE64
+        switch (level)
+        {
+        case Base64Simd::avx2:  return encodeAvx2(in, size, out);
+        case Base64Simd::ssse3: return encodeSsse3(in, size, out);
+        default: break;
+        }
+#else
+        (void)level; (void)in; (void)size; (void)out;
+#endif
+        return 0;
+    }
+
+    static std::size_t decode(Base64Simd level, const char* in,
+                              std::size_t length, uint8_t* out)
+    {
+#if CPPWAMP_HAS_SIMD_BASE64
+        switch (level)
+        {
+        case Base64Simd::avx2:  return decodeAvx2(in, length, out);
+        case Base64Simd::ssse3: return decodeSsse3(in, length, out);
+        default: break;
+        }
+#else
+        (void)level; (void)in; (void)length; (void)out;
+#endif
+        return 0;
+    }
+
+#if CPPWAMP_HAS_SIMD_BASE64
+private:
+    //--------------------------------------------------------------------------
+    // SSSE3 kernels: 12 bytes <-> 16 characters per iteration
+    //--------------------------------------------------------------------------
+    CPPWAMP_BASE64_TARGET("ssse3")
+    static __m128i sextetsFromBytes(__m128i in)
+    {
+        // Each 32-bit lane receives the 3 bytes it encodes, arranged so that
+        // the multiplications below shift every sextet into its own byte.
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11,  9, 10,
+                                                7,  8,  6,  7,
+                                                4,  5,  3,  4,
+                                                1,  2,  0,  1));
+        auto t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        auto t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        return _mm_or_si128(t1, t3);
+    }
+
+    CPPWAMP_BASE64_TARGET("ssse3")
+    static __m128i charsFromSextets(__m128i sextets)
+    {
+        // Maps each sextet range to the offset to be added to it:
+        // 0..25 -> 'A', 26..51 -> 'a' - 26, 52..61 -> '0' - 52,
+        // 62 -> '+' - 62, 63 -> '/' - 63
+        auto index = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+        auto isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+        index = _mm_or_si128(index, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+        auto offsets = _mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+            '/' - 63, 'A', 0, 0);
+        return _mm_add_epi8(_mm_shuffle_epi8(offsets, index), sextets);
+    }
+
+    // Bytes >= 0x80 compare as negative and fall outside every range.
+    CPPWAMP_BASE64_TARGET("ssse3")
+    static __m128i inRange(__m128i c, char lo, char hi)
+    {
+        return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8(lo - 1)),
+                             _mm_cmpgt_epi8(_mm_set1_epi8(hi + 1), c));
+    }
+
+    // Returns false if any character is not part of the Base64 alphabet.
+    CPPWAMP_BASE64_TARGET("ssse3")
+    static bool sextetsFromChars(__m128i chars, __m128i& sextets)
+    {
+        auto upper = inRange(chars, 'A', 'Z');
+        auto lower = inRange(chars, 'a', 'z');
+        auto digit = inRange(chars, '0', '9');
+        auto plus = _mm_cmpeq_epi8(chars, _mm_set1_epi8('+'));
+        auto slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+        auto valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                  _mm_or_si128(digit,
+                                               _mm_or_si128(plus, slash)));
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+            return false;
+
+        auto shift = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-65)),
+                         _mm_and_si128(lower, _mm_set1_epi8(-71))),
+            _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(4)),
+                         _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(19)),
+                                      _mm_and_si128(slash,
+                                                    _mm_set1_epi8(16)))));
+        sextets = _mm_add_epi8(chars, shift);
+        return true;
+    }
+
+    CPPWAMP_BASE64_TARGET("ssse3")
+    static __m128i bytesFromSextets(__m128i sextets)
+    {
+        // Merges pairs of sextets into 12-bit values, then pairs of those into
+        // 24-bit values, and finally gathers the 3 bytes of each 32-bit lane.
+        auto pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+        auto triplets = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        return _mm_shuffle_epi8(triplets,
+                                _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                              14, 13, 12, -1, -1, -1, -1));
+    }
+
+    CPPWAMP_BASE64_TARGET("ssse3")
+    static std::size_t encodeSsse3(const uint8_t* in, std::size_t size,
+                                   char* out)
+    {
+        std::size_t i = 0;
+        for (; size - i >= 16; i += 12, out += 16)
+        {
+            auto bytes = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(in + i));
+            auto chars = charsFromSextets(sextetsFromBytes(bytes));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+        }
+        return i;
+    }
+
+    CPPWAMP_BASE64_TARGET("ssse3")
+    static std::size_t decodeSsse3(const char* in, std::size_t length,
+                                   uint8_t* out)
+    {
+        std::size_t i = 0;
+        for (; length - i >= 16; i += 16, out += 12)
+        {
+            auto chars = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(in + i));
+            __m128i sextets;
+            if (!sextetsFromChars(chars, sextets))
+                break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                             bytesFromSextets(sextets));
+        }
+        return i;
+    }
+
+    //--------------------------------------------------------------------------
+    // AVX2 kernels: 24 bytes <-> 32 characters per iteration, processed as
+    // two independent 128-bit lanes using the same steps as above.
+    //--------------------------------------------------------------------------
+    CPPWAMP_BASE64_TARGET("avx2")
+    static __m256i sextetsFromBytes(__m256i in)
+    {
+        in = _mm256_shuffle_epi8(in, _mm256_set_epi8(
+            10, 11,  9, 10,  7,  8,  6,  7,  4,  5,  3,  4,  1,  2,  0,  1,
+            10, 11,  9, 10,  7,  8,  6,  7,  4,  5,  3,  4,  1,  2,  0,  1));
+        auto t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        auto t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        auto t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        auto t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        return _mm256_or_si256(t1, t3);
+    }
+
+    CPPWAMP_BASE64_TARGET("avx2")
+    static __m256i charsFromSextets(__m256i sextets)
+    {
+        auto index = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+        auto isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets);
+        index = _mm256_or_si256(index,
+                                _mm256_and_si256(isUpper,
+                                                 _mm256_set1_epi8(13)));
+        auto offsets = _mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+            '/' - 63, 'A', 0, 0,
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+            '/' - 63, 'A', 0, 0);
+        return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, index), sextets);
+    }
+
+    CPPWAMP_BASE64_TARGET("avx2")
+    static __m256i inRange(__m256i c, char lo, char hi)
+    {
+        return _mm256_and_si256(
+            _mm256_cmpgt_epi8(c, _mm256_set1_epi8(lo - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), c));
+    }
+
+    CPPWAMP_BASE64_TARGET("avx2")
+    static bool sextetsFromChars(__m256i chars, __m256i& sextets)
+    {
+        auto upper = inRange(chars, 'A', 'Z');
+        auto lower = inRange(chars, 'a', 'z');
+        auto digit = inRange(chars, '0', '9');
+        auto plus = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('+'));
+        auto slash = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/'));
+        auto valid = _mm256_or_si256(
+            _mm256_or_si256(upper, lower),
+            _mm256_or_si256(digit, _mm256_or_si256(plus, slash)));
+        if (_mm256_movemask_epi8(valid) != -1)
+            return false;
+
+        auto shift = _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-65)),
+                            _mm256_and_si256(lower, _mm256_set1_epi8(-71))),
+            _mm256_or_si256(
+                _mm256_and_si256(digit, _mm256_set1_epi8(4)),
+                _mm256_or_si256(_mm256_and_si256(plus, _mm256_set1_epi8(19)),
+                                _mm256_and_si256(slash,
+                                                 _mm256_set1_epi8(16)))));
+        sextets = _mm256_add_epi8(chars, shift);
+        return true;
+    }
+
+    CPPWAMP_BASE64_TARGET("avx2")
+    static __m256i bytesFromSextets(__m256i sextets)
+    {
+        auto pairs = _mm256_maddubs_epi16(sextets,
+                                          _mm256_set1_epi32(0x01400140));
+        auto triplets = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        auto packed = _mm256_shuffle_epi8(triplets, _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        // Brings the 12 bytes of each lane together.
+        return _mm256_permutevar8x32_epi32(
+            packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    }
+
+    CPPWAMP_BASE64_TARGET("avx2")
+    static std::size_t encodeAvx2(const uint8_t* in, std::size_t size,
+                                  char* out)
+    {
+        // Each lane loads 16 bytes of which it encodes the first 12, so the
+        // upper lane's load must not run past the end of the input.
+        std::size_t i = 0;
+        for (; size - i >= 28; i += 24, out += 32)
+        {
+            auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            auto hi = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(in + i + 12));
+            auto bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(lo),
+                                                 hi, 1);
+            auto chars = charsFromSextets(sextetsFromBytes(bytes));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+        }
+        return i + encodeSsse3(in + i, size - i, out);
+    }
+
+    CPPWAMP_BASE64_TARGET("avx2")
+    static std::size_t decodeAvx2(const char* in, std::size_t length,
+                                  uint8_t* out)
+    {
+        std::size_t i = 0;
+        for (; length - i >= 32; i += 32, out += 24)
+        {
+            auto chars = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(in + i));
+            __m256i sextets;
+            if (!sextetsFromChars(chars, sextets))
+                return i;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                                bytesFromSextets(sextets));
+        }
+        return i + decodeSsse3(in + i, length - i, out);
+    }
+#endif // CPPWAMP_HAS_SIMD_BASE64
+};
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_BASE64SIMD_HPP
@@ -7,14 +7,18 @@
 #ifndef CPPWAMP_INTERNAL_CALLER_TIMEOUT_HPP
 #define CPPWAMP_INTERNAL_CALLER_TIMEOUT_HPP
 
+#include <cassert>
 #include <chrono>
+#include <cstddef>
+#include <functional>
 #include <memory>
-#include <set>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 #include "../asiodefs.hpp"
-#include "../peerdata.hpp"
+#include "../wampdefs.hpp"
 
 namespace wamp
 {
@@ -45,6 +49,125 @@ struct CallerTimeoutRecord
     RequestId requestId = 0;
 };
 
+//------------------------------------------------------------------------------
+// Binary min-heap of caller timeout records, ordered by deadline, which also
+// indexes each record's heap position by request ID. This allows a record
+// to be found in constant time and removed in logarithmic time when its call
+// completes before the deadline.
+//------------------------------------------------------------------------------
+class CallerTimeoutHeap
+{
+public:
+    using Record = CallerTimeoutRecord;
+
+    bool empty() const {return heap_.empty();}
+
+    std::size_t size() const {return heap_.size();}
+
+    const Record& top() const
+    {
+        assert(!heap_.empty());
+        return heap_.front();
+    }
+
+    bool contains(RequestId rid) const {return positions_.count(rid) != 0;}
+
+    // Replaces any existing record having the same request ID.
+    void push(Record rec)
+    {
+        erase(rec.requestId);
+        heap_.push_back(rec);
+        auto pos = heap_.size() - 1;
+        positions_[rec.requestId] = pos;
+        siftUp(pos);
+    }
+
+    void pop()
+    {
+        assert(!heap_.empty());
+        removeAt(0);
+    }
+
+    bool erase(RequestId rid)
+    {
+        auto found = positions_.find(rid);
+        if (found == positions_.end())
+            return false;
+        removeAt(found->second);
+        return true;
+    }
+
+    void clear()
+    {
+        heap_.clear();
+        positions_.clear();
+    }
+
+private:
+    static std::size_t parentOf(std::size_t pos) {return (pos - 1) / 2;}
+
+    void removeAt(std::size_t pos)
+    {
+        positions_.erase(heap_[pos].requestId);
+        auto last = heap_.size() - 1;
+        if (pos != last)
+        {
+            place(pos, heap_[last]);
+            heap_.pop_back();
+            if (pos > 0 && heap_[pos] < heap_[parentOf(pos)])
+                siftUp(pos);
+            else
+                siftDown(pos);
+        }
+        else
+        {
+            heap_.pop_back();
+        }
+    }
+
+    void siftUp(std::size_t pos)
+    {
+        auto rec = heap_[pos];
+        while (pos > 0)
+        {
+            auto parent = parentOf(pos);
+            if (!(rec < heap_[parent]))
+                break;
+            place(pos, heap_[parent]);
+            pos = parent;
+        }
+        place(pos, rec);
+    }
+
+    void siftDown(std::size_t pos)
+    {
+        auto rec = heap_[pos];
+        auto count = heap_.size();
+        while (true)
+        {
+            auto child = 2*pos + 1;
+            if (child >= count)
+                break;
+            if (child + 1 < count && heap_[child + 1] < heap_[child])
+                ++child;
+            if (!(heap_[child] < rec))
+                break;
+            place(pos, heap_[child]);
+            pos = child;
+        }
+        place(pos, rec);
+    }
+
+    void place(std::size_t pos, const Record& rec)
+    {
+        heap_[pos] = rec;
+        positions_[rec.requestId] = pos;
+    }
+
+    std::vector<Record> heap_;
+    std::unordered_map<RequestId, std::size_t> positions_;
+};
+
 //------------------------------------------------------------------------------
 class CallerTimeoutScheduler :
     public std::enable_shared_from_this<CallerTimeoutScheduler>
@@ -73,9 +196,9 @@ public:
         CallerTimeoutRecord rec{timeout, rid};
         bool wasIdle = deadlines_.empty();
         bool preemptsCurrentDeadline =
-            !wasIdle && (rec < *deadlines_.begin());
+            !wasIdle && (rec < deadlines_.top());
 
-        deadlines_.insert(rec);
+        deadlines_.push(rec);
         if (wasIdle)
             processNextDeadline();
         else if (preemptsCurrentDeadline)
@@ -87,26 +210,13 @@ public:
         if (deadlines_.empty())
             return;
 
-        auto rec = deadlines_.begin();
-        if (rec->requestId == rid)
-        {
-            deadlines_.erase(rec);
+        bool isCurrentDeadline = deadlines_.top().requestId == rid;
+        if (deadlines_.erase(rid) && isCurrentDeadline)
             timer_.cancel();
-            return;
-        }
-
-        // The set should be small, so just do a linear search.
-        auto end = deadlines_.end();
-        for (; rec != end; ++rec)
-        {
-            if (rec->requestId == rid)
-            {
-                deadlines_.erase(rec);
-                return;
-            }
-        }
     }
 
+    std::size_t size() const {return deadlines_.size();}
+
     void clear()
     {
         timeoutHandler_ = nullptr;
@@ -123,8 +233,8 @@ private:
 
     void processNextDeadline()
     {
-        auto deadline = deadlines_.begin()->deadline;
-        auto requestId = deadlines_.begin()->requestId;
+        auto deadline = deadlines_.top().deadline;
+        auto requestId = deadlines_.top().requestId;
         timer_.expires_at(deadline);
         WeakPtr self(shared_from_this());
         timer_.async_wait([self, requestId](boost::system::error_code ec)
@@ -139,20 +249,19 @@ private:
     {
         if (!deadlines_.empty())
         {
-            auto top = deadlines_.begin();
-            bool preempted = top->requestId != requestId;
+            bool preempted = deadlines_.top().requestId != requestId;
             if (!preempted)
             {
                 if (!ec && timeoutHandler_)
-                    timeoutHandler_(top->requestId);
-                deadlines_.erase(top);
+                    timeoutHandler_(requestId);
+                deadlines_.erase(requestId);
             }
             if (!deadlines_.empty())
                 processNextDeadline();
         }
     }
 
-    std::set<CallerTimeoutRecord> deadlines_;
+    CallerTimeoutHeap deadlines_;
     boost::asio::steady_timer timer_;
     TimeoutHandler timeoutHandler_;
 };
@@ -9,6 +9,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <exception>
 #include <future>
 #include <map>
@@ -17,6 +18,7 @@
 #include <string>
 #include <system_error>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <boost/asio/post.hpp>
 #include "../anyhandler.hpp"
@@ -33,6 +35,7 @@
 #include "caller.hpp"
 #include "callertimeout.hpp"
 #include "challengee.hpp"
+#include "connectionrace.hpp"
 #include "subscriber.hpp"
 #include "peer.hpp"
 
@@ -125,6 +128,19 @@ public:
 
     void setLogLevel(LogLevel level) {peer_.setLogLevel(level);}
 
+    void setLazyPayloads(bool enabled) {peer_.setLazyPayloads(enabled);}
+
+    void setTxWatermarks(TxWatermarks watermarks)
+    {
+        peer_.setTxWatermarks(watermarks);
+    }
+
+    void setConnectionRacing(bool enabled, ConnectionRace::Duration stagger)
+    {
+        connectionRacing_ = enabled;
+        connectionRaceStagger_ = stagger;
+    }
+
     void safeSetLogHandler(LogHandler f)
     {
         struct Dispatched
@@ -217,13 +233,17 @@ public:
         peer_.setTerminating(false);
         peer_.setState(State::connecting);
         currentConnector_ = nullptr;
+        connectionRace_ = nullptr;
 
         // This makes it easier to transport the move-only completion handler
         // through the gauntlet of intermediary handler functions.
         auto sharedHandler =
             std::make_shared<CompletionHandler<size_t>>(std::move(handler));
 
-        doConnect(std::move(wishes), 0, std::move(sharedHandler));
+        if (connectionRacing_ && wishes.size() > 1)
+            raceConnect(std::move(wishes), std::move(sharedHandler));
+        else
+            doConnect(std::move(wishes), 0, std::move(sharedHandler));
     }
 
     void safeConnect(ConnectionWishList&& w, CompletionHandler<size_t>&& f)
@@ -546,6 +566,8 @@ public:
     {
         if (state() != State::established)
             return makeUnexpectedError(SessionErrc::invalidState);
+        if (peer_.isTxBlocked())
+            return makeUnexpectedError(TransportErrc::wouldBlock);
         return peer_.send(pub.message({}));
     }
 
@@ -598,6 +620,13 @@ public:
         if (!checkState(State::established, handler))
             return;
 
+        if (peer_.isTxBlocked())
+        {
+            postUserHandler(handler,
+                            makeUnexpectedError(TransportErrc::wouldBlock));
+            return;
+        }
+
         pub.withOption("acknowledge", true);
         peer_.request(pub.message({}),
                       Requested{shared_from_this(), std::move(handler)});
@@ -616,6 +645,44 @@ public:
         safelyDispatch<Dispatched>(std::move(p), std::move(f));
     }
 
+    void awaitTxSpace(CompletionHandler<bool>&& handler)
+    {
+        struct Awaited
+        {
+            Ptr self;
+            std::shared_ptr<CompletionHandler<bool>> handler;
+
+            void operator()(std::error_code ec)
+            {
+                auto& me = *self;
+                if (ec)
+                    me.dispatchUserHandler(*handler, UnexpectedError(ec));
+                else
+                    me.dispatchUserHandler(*handler, true);
+            }
+        };
+
+        if (!checkState(State::established, handler))
+            return;
+
+        // Transporting::TxSpaceHandler must be copyable
+        auto shared =
+            std::make_shared<CompletionHandler<bool>>(std::move(handler));
+        peer_.awaitTxSpace(Awaited{shared_from_this(), std::move(shared)});
+    }
+
+    void safeAwaitTxSpace(CompletionHandler<bool>&& f)
+    {
+        struct Dispatched
+        {
+            Ptr self;
+            CompletionHandler<bool> f;
+            void operator()() {self->awaitTxSpace(std::move(f));}
+        };
+
+        safelyDispatch<Dispatched>(std::move(f));
+    }
+
     void enroll(Procedure&& procedure, CallSlot&& callSlot,
                 InterruptSlot&& interruptSlot,
                 CompletionHandler<Registration>&& handler)
@@ -771,6 +838,8 @@ public:
             void operator()(ErrorOr<Message> reply)
             {
                 auto& me = *self;
+                if (reply)
+                    me.timeoutScheduler_->remove(reply->requestId());
                 if (me.checkReply(reply, WampMsgType::result,
                                   SessionErrc::callError, handler, errorPtr))
                 {
@@ -833,6 +902,8 @@ public:
             void operator()(ErrorOr<Message> reply)
             {
                 auto& me = *self;
+                if (reply && !reply->isProgressiveResponse())
+                    me.timeoutScheduler_->remove(reply->requestId());
                 if (me.checkReply(reply, WampMsgType::result,
                                   SessionErrc::callError, handler, errorPtr))
                 {
@@ -1021,10 +1092,11 @@ private:
     using Message        = internal::WampMessage;
     using SlotId         = uint64_t;
     using LocalSubs      = std::map<SlotId, SubscriptionRecord>;
-    using Readership     = std::map<SubscriptionId, LocalSubs>;
-    using TopicMap       = std::map<std::string, SubscriptionId>;
-    using Registry       = std::map<RegistrationId, RegistrationRecord>;
-    using InvocationMap  = std::map<RequestId, RegistrationId>;
+    using Readership     = std::unordered_map<SubscriptionId, LocalSubs>;
+    using TopicMap       = std::unordered_map<std::string, SubscriptionId>;
+    using Registry       = std::unordered_map<RegistrationId,
+                                              RegistrationRecord>;
+    using InvocationMap  = std::unordered_map<RequestId, RegistrationId>;
     using CallerTimeoutDuration = typename Rpc::CallerTimeoutDuration;
 
     Client(AnyIoExecutor exec)
@@ -1108,6 +1180,65 @@ private:
             Established{shared_from_this(), move(wishes), index, move(handler)});
     }
 
+    void raceConnect(ConnectionWishList&& wishes,
+                     std::shared_ptr<CompletionHandler<size_t>> handler)
+    {
+        using std::move;
+        struct Finished
+        {
+            std::weak_ptr<Client> self;
+            ConnectionWishList wishes;
+            std::shared_ptr<CompletionHandler<size_t>> handler;
+
+            void operator()(ErrorOr<Transporting::Ptr> transport,
+                            size_t index)
+            {
+                auto locked = self.lock();
+                if (!locked)
+                {
+                    if (transport)
+                        (*transport)->close();
+                    return;
+                }
+
+                auto& me = *locked;
+                me.connectionRace_ = nullptr;
+                if (me.peer_.isTerminating())
+                    return;
+
+                if (!transport)
+                {
+                    auto ec = transport.error();
+                    if (ec != TransportErrc::aborted)
+                        me.peer_.setState(State::failed);
+                    me.dispatchUserHandler(*handler, UnexpectedError(ec));
+                }
+                else if (me.state() == State::connecting)
+                {
+                    auto codec = wishes.at(index).makeCodec();
+                    me.peer_.open(std::move(*transport), std::move(codec));
+                    me.dispatchUserHandler(*handler, index);
+                }
+                else
+                {
+                    (*transport)->close();
+                    auto ec = make_error_code(TransportErrc::aborted);
+                    me.postUserHandler(*handler, UnexpectedError(ec));
+                }
+            }
+        };
+
+        ConnectionRace::Connectors connectors;
+        connectors.reserve(wishes.size());
+        for (const auto& wish: wishes)
+            connectors.push_back(wish.makeConnector(strand()));
+
+        connectionRace_ = ConnectionRace::create(strand(), move(connectors),
+                                                 connectionRaceStagger_);
+        connectionRace_->start(
+            Finished{shared_from_this(), move(wishes), move(handler)});
+    }
+
     void onConnectFailure(ConnectionWishList&& wishes, size_t index,
                           std::error_code ec,
                           std::shared_ptr<CompletionHandler<size_t>> handler)
@@ -1136,7 +1267,12 @@ private:
     void doDisconnect()
     {
         if (state() == State::connecting)
-            currentConnector_->cancel();
+        {
+            if (connectionRace_)
+                connectionRace_->cancel();
+            else if (currentConnector_)
+                currentConnector_->cancel();
+        }
 
         topics_.clear();
         readership_.clear();
@@ -1296,6 +1432,8 @@ private:
         {
             const auto& localSubs = kv->second;
             assert(!localSubs.empty());
+            // Copies of the event share the same underlying message, so
+            // fanning out to several slots does not copy the payload.
             Event event({}, userExecutor(), std::move(eventMsg));
             for (const auto& subKv: localSubs)
                 postEvent(subKv.second, event);
@@ -1585,6 +1723,7 @@ private:
 
     Peer peer_;
     Connecting::Ptr currentConnector_;
+    ConnectionRace::Ptr connectionRace_;
     TopicMap topics_;
     Readership readership_;
     Registry registry_;
@@ -1592,6 +1731,9 @@ private:
     CallerTimeoutScheduler::Ptr timeoutScheduler_;
     ChallengeHandler challengeHandler_;
     SlotId nextSlotId_ = 0;
+    ConnectionRace::Duration connectionRaceStagger_ =
+        std::chrono::milliseconds(250);
+    bool connectionRacing_ = false;
 };
 
 } // namespace internal
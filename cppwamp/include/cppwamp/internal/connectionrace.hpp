@@ -0,0 +1,189 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_CONNECTIONRACE_HPP
+#define CPPWAMP_INTERNAL_CONNECTIONRACE_HPP
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <boost/asio/steady_timer.hpp>
+#include "../asiodefs.hpp"
+#include "../connector.hpp"
+#include "../error.hpp"
+#include "../erroror.hpp"
+#include "../transport.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Races connection attempts in the manner of Happy Eyeballs (RFC 8305).
+// Attempts are started in order, each one after the given stagger delay or
+// as soon as all previously started attempts have failed. The first transport
+// to be established wins, and the remaining attempts are cancelled.
+//------------------------------------------------------------------------------
+class ConnectionRace : public std::enable_shared_from_this<ConnectionRace>
+{
+public:
+    using Ptr = std::shared_ptr<ConnectionRace>;
+    using Duration = std::chrono::steady_clock::duration;
+    using Connectors = std::vector<Connecting::Ptr>;
+
+    // Emits the winning transport and the index of its connector.
+    using Handler = std::function<void (ErrorOr<Transporting::Ptr>,
+                                        std::size_t)>;
+
+    static Ptr create(IoStrand strand, Connectors connectors,
+                      Duration stagger)
+    {
+        assert(!connectors.empty());
+        return Ptr(new ConnectionRace(std::move(strand), std::move(connectors),
+                                      stagger));
+    }
+
+    void start(Handler handler)
+    {
+        assert(!handler_ && "Connection race already started");
+        handler_ = std::move(handler);
+        launchNext();
+    }
+
+    // Aborts all attempts in progress, emitting TransportErrc::aborted.
+    void cancel()
+    {
+        if (!handler_)
+            return;
+        finish(makeUnexpectedError(TransportErrc::aborted), 0);
+    }
+
+    std::size_t startedCount() const {return nextIndex_;}
+
+private:
+    using WeakPtr = std::weak_ptr<ConnectionRace>;
+
+    ConnectionRace(IoStrand strand, Connectors&& connectors, Duration stagger)
+        : connectors_(std::move(connectors)),
+          settled_(connectors_.size(), false),
+          timer_(std::move(strand)),
+          stagger_(stagger)
+    {}
+
+    void launchNext()
+    {
+        assert(nextIndex_ < connectors_.size());
+        auto index = nextIndex_++;
+        ++pendingCount_;
+        WeakPtr self(shared_from_this());
+        connectors_[index]->establish(
+            [self, index](ErrorOr<Transporting::Ptr> transport)
+            {
+                auto ptr = self.lock();
+                if (ptr)
+                    ptr->onAttempt(index, std::move(transport));
+                else if (transport)
+                    (*transport)->close();
+            });
+
+        if (nextIndex_ < connectors_.size())
+            armTimer();
+    }
+
+    void armTimer()
+    {
+        timer_.expires_after(stagger_);
+        WeakPtr self(shared_from_this());
+        auto index = nextIndex_;
+        timer_.async_wait([self, index](boost::system::error_code ec)
+        {
+            auto ptr = self.lock();
+            if (ptr)
+                ptr->onTimer(ec, index);
+        });
+    }
+
+    void onTimer(boost::system::error_code ec, std::size_t index)
+    {
+        // A stale timer may fire after an attempt failure launched the
+        // next attempt early.
+        if (!ec && handler_ && (index == nextIndex_))
+            launchNext();
+    }
+
+    void onAttempt(std::size_t index, ErrorOr<Transporting::Ptr> transport)
+    {
+        --pendingCount_;
+        settled_[index] = true;
+        if (!handler_)
+        {
+            // Lost the race, or the race was cancelled.
+            if (transport)
+                (*transport)->close();
+            return;
+        }
+
+        if (transport)
+            return finish(std::move(transport), index);
+
+        lastError_ = transport.error();
+        ++failedCount_;
+        if (nextIndex_ < connectors_.size())
+        {
+            // Don't wait for the stagger delay if nothing else is pending.
+            if (pendingCount_ == 0)
+            {
+                timer_.cancel();
+                launchNext();
+            }
+        }
+        else if (failedCount_ == connectors_.size())
+        {
+            auto ec = lastError_;
+            if (connectors_.size() > 1)
+                ec = make_error_code(SessionErrc::allTransportsFailed);
+            finish(UnexpectedError(ec), index);
+        }
+    }
+
+    void finish(ErrorOr<Transporting::Ptr> result, std::size_t index)
+    {
+        // The handler may release the last reference to this race.
+        auto self = shared_from_this();
+        timer_.cancel();
+        auto handler = std::move(handler_);
+        handler_ = nullptr;
+        for (std::size_t i = 0; i < nextIndex_; ++i)
+        {
+            if (!settled_[i])
+                connectors_[i]->cancel();
+        }
+        handler(std::move(result), index);
+    }
+
+    Connectors connectors_;
+    std::vector<bool> settled_;
+    boost::asio::steady_timer timer_;
+    Handler handler_;
+    std::error_code lastError_;
+    Duration stagger_;
+    std::size_t nextIndex_ = 0;
+    std::size_t pendingCount_ = 0;
+    std::size_t failedCount_ = 0;
+};
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_CONNECTIONRACE_HPP
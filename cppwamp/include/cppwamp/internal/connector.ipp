@@ -38,6 +38,12 @@ CPPWAMP_INLINE ConnectionWish::ConnectionWish(const LegacyConnector& c)
       codecBuilder_(c.codecBuilder())
 {}
 
+CPPWAMP_INLINE ConnectionWish& ConnectionWish::withCodecPooling(bool enabled)
+{
+    codecBuilder_.withPooling(enabled);
+    return *this;
+}
+
 CPPWAMP_INLINE int ConnectionWish::codecId() const {return codecBuilder_.id();}
 
 CPPWAMP_INLINE Connecting::Ptr ConnectionWish::makeConnector(IoStrand s) const
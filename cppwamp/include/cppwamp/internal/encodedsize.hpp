@@ -0,0 +1,92 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_ENCODEDSIZE_HPP
+#define CPPWAMP_INTERNAL_ENCODEDSIZE_HPP
+
+#include <cstddef>
+#include "../variant.hpp"
+#include "../visitor.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Accumulates a lower bound of a variant's serialized size that holds for all
+// of the supported codecs, stopping as soon as the given budget is exceeded.
+// This allows oversized payloads to be rejected without first having to
+// encode them in full.
+//------------------------------------------------------------------------------
+class EncodedSizeFloor : public Visitor<>
+{
+public:
+    explicit EncodedSizeFloor(std::size_t budget) : budget_(budget) {}
+
+    bool exceeded() const {return floor_ > budget_;}
+
+    std::size_t floor() const {return floor_;}
+
+    template <typename TField>
+    void operator()(const TField&) {floor_ += 1;}
+
+    void operator()(const String& s) {floor_ += s.size() + 1;}
+
+    void operator()(const Blob& b) {floor_ += b.data().size() + 1;}
+
+    void operator()(const Array& a)
+    {
+        floor_ += 1;
+        for (const auto& elem: a)
+        {
+            if (exceeded())
+                return;
+            wamp::apply(*this, elem);
+        }
+    }
+
+    void operator()(const Object& o)
+    {
+        floor_ += 1;
+        for (const auto& kv: o)
+        {
+            if (exceeded())
+                return;
+            floor_ += kv.first.size() + 1;
+            wamp::apply(*this, kv.second);
+        }
+    }
+
+private:
+    std::size_t budget_ = 0;
+    std::size_t floor_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Returns true if the given variant is certain to exceed the given number
+// of bytes once serialized.
+//------------------------------------------------------------------------------
+inline bool encodedSizeExceeds(const Variant& variant, std::size_t budget)
+{
+    EncodedSizeFloor visitor(budget);
+    wamp::apply(visitor, variant);
+    return visitor.exceeded();
+}
+
+inline bool encodedSizeExceeds(const Array& fields, std::size_t budget)
+{
+    EncodedSizeFloor visitor(budget);
+    visitor(fields);
+    return visitor.exceeded();
+}
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_ENCODEDSIZE_HPP
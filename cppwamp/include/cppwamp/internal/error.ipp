@@ -430,7 +430,8 @@ CPPWAMP_INLINE std::string TransportCategory::message(int ev) const
         /* aborted */     "Operation aborted",
         /* failed */      "Operation failed",
         /* badTxLength */ "Outgoing message exceeds maximum length",
-        /* badRxLength */ "Incoming message exceeds maximum length"
+        /* badRxLength */ "Incoming message exceeds maximum length",
+        /* wouldBlock */  "Transmit queue is above its high watermark"
     };
 
     if (ev >= 0 && ev < (int)std::extent<decltype(msg)>::value)
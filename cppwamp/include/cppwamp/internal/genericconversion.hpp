@@ -0,0 +1,121 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_GENERICCONVERSION_HPP
+#define CPPWAMP_INTERNAL_GENERICCONVERSION_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "../conversionaccess.hpp"
+#include "../traits.hpp"
+#include "../variant.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Used to detect whether a custom type's `convert` function is a template
+// accepting any converter type, so that it can be applied to the converters
+// used by typed encoding and decoding. The hidden friend below is more
+// specialized than the catch-all wamp::convert, but is ambiguous with
+// user-provided overloads of the form `template <typename C> void convert(C&,
+// T&)`. Variant is used as the template argument so that the `wamp` namespace
+// is searched by ADL, as it is for the typed converters.
+//------------------------------------------------------------------------------
+struct ConversionProbeResult {};
+
+struct ConversionProbeAmbiguity {};
+
+template <typename>
+struct ConversionProbe
+{
+    static constexpr bool convertingToVariant = true;
+
+    template <typename T>
+    friend ConversionProbeResult convert(ConversionProbe&, T&) {return {};}
+};
+
+template <typename T>
+auto probeConversion(int)
+    -> decltype(convert(std::declval<ConversionProbe<Variant>&>(),
+                        std::declval<T&>()));
+
+template <typename T>
+ConversionProbeAmbiguity probeConversion(long);
+
+CPPWAMP_GENERATE_HAS_MEMBER(convert)
+
+template <typename T>
+constexpr bool hasGenericConversion()
+{
+    using HasMember = typename std::conditional<std::is_class<T>::value,
+                                                has_member_convert<T>,
+                                                FalseType>::type;
+    using Probed = decltype(probeConversion<T>(0));
+    return HasMember::value || !isSameType<Probed, ConversionProbeResult>();
+}
+
+//------------------------------------------------------------------------------
+// Records how a custom type's `convert` function accesses its converter, so
+// that container sizes can be announced to encoders beforehand, and so that
+// decoders can tell if the type is represented as an object.
+//------------------------------------------------------------------------------
+class ConversionShape
+{
+public:
+    enum class Kind {none, scalar, array, object, mixed};
+
+    Kind kind() const {return kind_;}
+
+    std::size_t count() const {return count_;}
+
+    void noteScalar() {note(Kind::scalar, true);}
+
+    void noteSize() {note(Kind::array, false);}
+
+    void noteElement() {note(Kind::array, true);}
+
+    void noteMember() {note(Kind::object, true);}
+
+private:
+    void note(Kind kind, bool counted)
+    {
+        // Mixing kinds, or assigning more than one scalar, has replacement
+        // semantics with ToVariantConverter that cannot be streamed.
+        if (kind_ == Kind::none)
+            kind_ = kind;
+        else if (kind_ != kind || kind == Kind::scalar)
+            kind_ = Kind::mixed;
+        if (counted)
+            ++count_;
+    }
+
+    Kind kind_ = Kind::none;
+    std::size_t count_ = 0;
+};
+
+//------------------------------------------------------------------------------
+struct ConverterKey
+{
+    ConverterKey(const char* s) : data(s), size(std::strlen(s)) {}
+
+    ConverterKey(const std::string& s) : data(s.data()), size(s.size()) {}
+
+    const char* data;
+    std::size_t size;
+};
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_GENERICCONVERSION_HPP
@@ -31,13 +31,41 @@ public:
     JsonDecoderImpl() : parser_(jsoncons::strict_json_parsing{}) {}
 
     std::error_code decode(const TInput& input, Variant& variant)
+    {
+        bool payloadSkipped = false;
+        return decodeAs(false, input, variant, payloadSkipped);
+    }
+
+    std::error_code decodeHeader(const TInput& input, Variant& variant,
+                                 bool& payloadSkipped)
+    {
+        return decodeAs(true, input, variant, payloadSkipped);
+    }
+
+protected:
+    void startParsing(bool headerOnly)
     {
         parser_.reinitialize();
-        parser_.update(reinterpret_cast<const char*>(input.data()),
-                       input.size());
         visitor_.reset();
-        std::error_code ec;
-        parser_.finish_parse(visitor_, ec);
+        visitor_.setHeaderOnly(headerOnly);
+    }
+
+    // Parses the given chunk of a larger input, returning true if the parser
+    // expects more. The parser retains any partially parsed token, so the
+    // chunk's storage may be reused afterwards.
+    bool parseChunk(const char* data, std::size_t length, std::error_code& ec)
+    {
+        parser_.update(data, length);
+        parser_.parse_some(visitor_, ec);
+        return !ec && !parser_.finished();
+    }
+
+    std::error_code finishParsing(std::error_code ec, Variant& variant,
+                                  bool& payloadSkipped)
+    {
+        if (!ec)
+            parser_.finish_parse(visitor_, ec);
+        payloadSkipped = false;
 
         if (!ec)
         {
@@ -46,7 +74,10 @@ public:
             if (visitor_.empty())
                 ec = make_error_code(DecodingErrc::emptyInput);
             else
+            {
+                payloadSkipped = visitor_.payloadSkipped();
                 variant = std::move(visitor_).variant();
+            }
         }
         parser_.reset();
         visitor_.reset();
@@ -55,12 +86,25 @@ public:
     }
 
 private:
+    std::error_code decodeAs(bool headerOnly, const TInput& input,
+                             Variant& variant, bool& payloadSkipped)
+    {
+        startParsing(headerOnly);
+        parser_.update(reinterpret_cast<const char*>(input.data()),
+                       input.size());
+        return finishParsing({}, variant, payloadSkipped);
+    }
+
     using Parser = jsoncons::basic_json_parser<char>;
     using Visitor = internal::VariantJsonDecodingVisitor;
     Parser parser_;
     Visitor visitor_;
 };
 
+//------------------------------------------------------------------------------
+// Feeds the parser one chunk at a time as it is read from the stream, so that
+// memory usage is bounded by the decoded variant instead of also having to
+// hold the entire serialized input.
 //------------------------------------------------------------------------------
 template <>
 class JsonDecoderImpl<std::istream> : public JsonDecoderImpl<std::string>
@@ -68,20 +112,34 @@ class JsonDecoderImpl<std::istream> : public JsonDecoderImpl<std::string>
 public:
     std::error_code decode(std::istream& in, Variant& variant)
     {
-        bytes_.clear();
-        char buffer[4096];
-        while (in.read(buffer, sizeof(buffer)))
-            bytes_.append(buffer, sizeof(buffer));
-        bytes_.append(buffer, in.gcount());
-        auto ec = Base::decode(bytes_, variant);
-        bytes_.clear();
-        return ec;
+        bool payloadSkipped = false;
+        return decodeAs(false, in, variant, payloadSkipped);
     }
 
-private:
-    using Base = JsonDecoderImpl<std::string>;
+    std::error_code decodeHeader(std::istream& in, Variant& variant,
+                                 bool& payloadSkipped)
+    {
+        return decodeAs(true, in, variant, payloadSkipped);
+    }
 
-    std::string bytes_;
+private:
+    std::error_code decodeAs(bool headerOnly, std::istream& in,
+                             Variant& variant, bool& payloadSkipped)
+    {
+        startParsing(headerOnly);
+        std::error_code ec;
+        char chunk[streamChunkSize];
+        bool expectsMore = true;
+        while (expectsMore)
+        {
+            in.read(chunk, sizeof(chunk));
+            auto length = static_cast<std::size_t>(in.gcount());
+            if (length == 0)
+                break;
+            expectsMore = parseChunk(chunk, length, ec);
+        }
+        return finishParsing(ec, variant, payloadSkipped);
+    }
 };
 
 } // namespace internal
@@ -153,6 +211,13 @@ public:
         return decoderImpl_.decode(source.input(), variant);
     }
 
+    std::error_code decodeHeader(Source source, Variant& variant,
+                                 bool& payloadSkipped)
+    {
+        return decoderImpl_.decodeHeader(source.input(), variant,
+                                         payloadSkipped);
+    }
+
 private:
     internal::JsonDecoderImpl<typename TSource::Input> decoderImpl_;
 };
@@ -175,6 +240,14 @@ std::error_code SourceDecoder<Json, TSource>::decode(Source source,
     return impl_->decode(source.input(), variant);
 }
 
+//------------------------------------------------------------------------------
+template <typename TSource>
+std::error_code SourceDecoder<Json, TSource>::decodeHeader(
+    Source source, Variant& variant, bool& payloadSkipped)
+{
+    return impl_->decodeHeader(source.input(), variant, payloadSkipped);
+}
+
 //------------------------------------------------------------------------------
 // Explicit template instantiations
 //------------------------------------------------------------------------------
@@ -96,6 +96,21 @@ public:
 
     template <typename TVariant>
     void operator()(const std::map<String, TVariant>& object)
+    {
+        encodeObject(object);
+    }
+
+#ifdef CPPWAMP_FLAT_OBJECT
+    template <typename TVariant>
+    void operator()(const FlatMap<String, TVariant>& object)
+    {
+        encodeObject(object);
+    }
+#endif
+
+private:
+    template <typename TObject>
+    void encodeObject(const TObject& object)
     {
         enter();
         encoder_.begin_object(object.size());
@@ -110,7 +125,6 @@ public:
         next();
     }
 
-private:
     struct Context
     {
         Context(bool isArray = false) : isArray(isArray), isPopulated(false) {}
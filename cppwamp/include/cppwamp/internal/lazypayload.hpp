@@ -0,0 +1,147 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_LAZYPAYLOAD_HPP
+#define CPPWAMP_INTERNAL_LAZYPAYLOAD_HPP
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <utility>
+#include "../codec.hpp"
+#include "../error.hpp"
+#include "../messagebuffer.hpp"
+#include "../variant.hpp"
+#include "payloadsplicing.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Keeps the raw bytes of a received message whose payload arguments were
+// skipped while decoding its header, and decodes them on first access.
+// Decoding is performed at most once, using the calling thread's clone of the
+// codec that decoded the header, so that it can safely happen in any thread.
+// That clone is kept for decoding further payloads of the same format. The raw
+// bytes are retained so that the still-encoded arguments can be spliced into
+// other messages encoded in the same format.
+//------------------------------------------------------------------------------
+class LazyPayload
+{
+public:
+    LazyPayload(MessageBuffer bytes, AnyBufferCodec codec, int codecId,
+                std::size_t payloadPos, std::size_t fieldCount)
+        : bytes_(std::move(bytes)),
+          codec_(std::move(codec)),
+          codecId_(codecId),
+          payloadPos_(payloadPos),
+          fieldCount_(fieldCount)
+    {}
+
+    int codecId() const {return codecId_;}
+
+    // Position of the positional arguments within the original message.
+    std::size_t payloadPosition() const {return payloadPos_;}
+
+    // Number of argument fields (positional, then keyword) in the original
+    // message.
+    std::size_t fieldCount() const {return fieldCount_;}
+
+    const MessageBuffer& bytes() const {return bytes_;}
+
+    // Finds the still-encoded argument fields within the raw bytes.
+    bool locateEncoded(EncodedSlice& slice) const
+    {
+        slice.count = fieldCount_;
+        return locateEncodedPayload(codecId_, bytes_, payloadPos_, slice);
+    }
+
+    // Returns the fields of the fully decoded message. They are empty if
+    // decoding failed.
+    const Array& fields() const
+    {
+        std::call_once(once_, [this]() {load();});
+        return fields_;
+    }
+
+    // Returns the error that occurred while decoding the fields, if any.
+    std::error_code error() const
+    {
+        fields();
+        return error_;
+    }
+
+    const Array& args() const {return field<Array>(payloadPos_);}
+
+    const Object& kwargs() const {return field<Object>(payloadPos_ + 1);}
+
+    // Moves out the decoded message fields. Must only be called by the sole
+    // owner of this object.
+    Array releaseFields()
+    {
+        fields();
+        return std::move(fields_);
+    }
+
+private:
+    void load() const
+    {
+        Variant message;
+        auto& codec = localCodec();
+        if (!codec)
+            error_ = make_error_code(DecodingErrc::failure);
+        else
+            error_ = codec.decode(bytes_, message);
+
+        if (!error_ && !message.is<Array>())
+            error_ = make_error_code(DecodingErrc::failure);
+        if (!error_)
+            fields_ = std::move(message.as<Array>());
+        codec_ = AnyBufferCodec{};
+    }
+
+    // Obtains the calling thread's codec for this payload's format, cloning
+    // the one that decoded the header if there is none yet.
+    AnyBufferCodec& localCodec() const
+    {
+        static thread_local std::map<int, AnyBufferCodec> codecs;
+        auto& codec = codecs[codecId_];
+        if (!codec && codec_)
+            codec = codec_.clone();
+        return codec;
+    }
+
+    // Returns the given decoded message field, or an empty one if it's
+    // missing or not of the expected type.
+    template <typename T>
+    const T& field(std::size_t pos) const
+    {
+        static const T empty;
+        const auto& fields = this->fields();
+        if (pos < fields.size() && fields[pos].template is<T>())
+            return fields[pos].template as<T>();
+        return empty;
+    }
+
+    MessageBuffer bytes_;
+    mutable AnyBufferCodec codec_;
+    mutable Array fields_;
+    mutable std::error_code error_;
+    mutable std::once_flag once_;
+    int codecId_;
+    std::size_t payloadPos_;
+    std::size_t fieldCount_;
+};
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_LAZYPAYLOAD_HPP
@@ -0,0 +1,58 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include "../loopback.hpp"
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+namespace wamp
+{
+
+//------------------------------------------------------------------------------
+struct Connector<Loopback>::Impl
+{
+    Impl(IoStrand i, Settings s, int codecId)
+        : strand(std::move(i)),
+          settings(std::move(s)),
+          codecId(codecId)
+    {}
+
+    IoStrand strand;
+    Settings settings;
+    int codecId;
+    std::uint64_t requestId = 0;
+};
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE Connector<Loopback>::Connector(IoStrand i, Settings s,
+                                              int codecId)
+    : impl_(new Impl(std::move(i), std::move(s), codecId))
+{}
+
+//------------------------------------------------------------------------------
+// Needed to avoid incomplete type errors.
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE Connector<Loopback>::~Connector() {}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void Connector<Loopback>::establish(Handler&& handler)
+{
+    const auto& listener = impl_->settings.listener();
+    assert(listener != nullptr);
+    impl_->requestId = listener->connect(impl_->strand, impl_->codecId,
+                                         impl_->settings.maxRxLength(),
+                                         std::move(handler));
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void Connector<Loopback>::cancel()
+{
+    if (impl_->requestId != 0)
+        impl_->settings.listener()->cancelConnect(impl_->requestId);
+}
+
+} // namespace wamp
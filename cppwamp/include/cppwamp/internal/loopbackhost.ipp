@@ -0,0 +1,191 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include "../loopbackhost.hpp"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <boost/asio/post.hpp>
+#include "../api.hpp"
+#include "../error.hpp"
+#include "loopbacktransport.hpp"
+#include "rawsockhandshake.hpp"
+
+namespace wamp
+{
+
+//******************************************************************************
+// LoopbackListener
+//******************************************************************************
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE LoopbackListener::Ptr LoopbackListener::create(
+    IoStrand strand, CodecIds codecIds, RawsockMaxLength maxRxLength)
+{
+    return Ptr(new LoopbackListener(std::move(strand), std::move(codecIds),
+                                    maxRxLength));
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void LoopbackListener::establish(Handler&& handler)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    assert(!handler_ &&
+           "LoopbackListener establishment already in progress");
+    if (requests_.empty())
+    {
+        handler_ = std::move(handler);
+        return;
+    }
+
+    auto request = std::move(requests_.front());
+    requests_.pop_front();
+    lock.unlock();
+    pair(std::move(request), std::move(handler));
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void LoopbackListener::cancel()
+{
+    Handler handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handler = std::move(handler_);
+        handler_ = nullptr;
+    }
+
+    if (handler)
+    {
+        boost::asio::post(strand_, [handler]()
+        {
+            handler(makeUnexpectedError(TransportErrc::aborted));
+        });
+    }
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE LoopbackListener::LoopbackListener(
+    IoStrand strand, CodecIds codecIds, RawsockMaxLength maxRxLength)
+    : strand_(std::move(strand)),
+      codecIds_(std::move(codecIds)),
+      maxRxLength_(internal::RawsockHandshake::byteLengthOf(maxRxLength))
+{}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE std::uint64_t LoopbackListener::connect(
+    IoStrand strand, int codecId, RawsockMaxLength maxRxLength,
+    Handler&& handler)
+{
+    auto maxRxBytes = internal::RawsockHandshake::byteLengthOf(maxRxLength);
+    Request request{std::move(strand), std::move(handler), 0, codecId,
+                    maxRxBytes};
+
+    if (codecIds_.count(codecId) == 0)
+    {
+        auto h = std::move(request.handler);
+        boost::asio::post(request.strand, [h]()
+        {
+            h(makeUnexpectedError(RawsockErrc::badSerializer));
+        });
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    request.id = ++nextRequestId_;
+    auto id = request.id;
+    if (!handler_)
+    {
+        requests_.push_back(std::move(request));
+        return id;
+    }
+
+    auto acceptHandler = std::move(handler_);
+    handler_ = nullptr;
+    lock.unlock();
+    pair(std::move(request), std::move(acceptHandler));
+    return id;
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void LoopbackListener::cancelConnect(std::uint64_t requestId)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto found = std::find_if(
+        requests_.begin(), requests_.end(),
+        [requestId](const Request& r) {return r.id == requestId;});
+    if (found == requests_.end())
+        return;
+
+    auto request = std::move(*found);
+    requests_.erase(found);
+    lock.unlock();
+
+    auto h = std::move(request.handler);
+    boost::asio::post(request.strand, [h]()
+    {
+        h(makeUnexpectedError(TransportErrc::aborted));
+    });
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void LoopbackListener::pair(Request&& request,
+                                           Handler&& acceptHandler)
+{
+    using Transport = internal::LoopbackTransport;
+
+    TransportInfo clientInfo{request.codecId, maxRxLength_,
+                             request.maxRxLength};
+    TransportInfo serverInfo{request.codecId, request.maxRxLength,
+                             maxRxLength_};
+    auto ends = Transport::createPair(request.strand, clientInfo,
+                                      strand_, serverInfo);
+
+    Transporting::Ptr client = std::move(ends.first);
+    auto clientHandler = std::move(request.handler);
+    boost::asio::post(request.strand, [clientHandler, client]()
+    {
+        clientHandler(client);
+    });
+
+    Transporting::Ptr server = std::move(ends.second);
+    boost::asio::post(strand_, [acceptHandler, server]()
+    {
+        acceptHandler(server);
+    });
+}
+
+//******************************************************************************
+// LoopbackHost
+//******************************************************************************
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE LoopbackHost::LoopbackHost(LoopbackListener::Ptr listener,
+                                          RawsockMaxLength maxRxLength)
+    : listener_(std::move(listener)),
+      maxRxLength_(maxRxLength)
+{}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE LoopbackHost& LoopbackHost::withMaxRxLength(
+    RawsockMaxLength length)
+{
+    maxRxLength_ = length;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE const LoopbackListener::Ptr& LoopbackHost::listener() const
+{
+    return listener_;
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE RawsockMaxLength LoopbackHost::maxRxLength() const
+{
+    return maxRxLength_;
+}
+
+} // namespace wamp
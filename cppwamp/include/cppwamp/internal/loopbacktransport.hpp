@@ -0,0 +1,235 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_LOOPBACKTRANSPORT_HPP
+#define CPPWAMP_INTERNAL_LOOPBACKTRANSPORT_HPP
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <system_error>
+#include <utility>
+#include <boost/asio/post.hpp>
+#include "../asiodefs.hpp"
+#include "../error.hpp"
+#include "../erroror.hpp"
+#include "../messagebuffer.hpp"
+#include "../transport.hpp"
+#include "mpscqueue.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// State shared by both ends of a loopback connection.
+//------------------------------------------------------------------------------
+struct LoopbackLink
+{
+    struct Pipe
+    {
+        MpscQueue<MessageBuffer> queue;
+        std::atomic<bool> drainPending{false};
+    };
+
+    std::array<Pipe, 2> pipes; // Indexed by receiving side
+    std::atomic<bool> closed{false};
+};
+
+//------------------------------------------------------------------------------
+// Transport that hands message buffers to its peer within the same process.
+// Each end has its own strand, and sent buffers are moved to the peer via a
+// lock-free queue. A drain of the peer's queue is posted only when one is
+// not already pending, so that bursts of messages are delivered in batches.
+//------------------------------------------------------------------------------
+class LoopbackTransport : public Transporting
+{
+public:
+    using Ptr = std::shared_ptr<LoopbackTransport>;
+    using Pair = std::pair<Ptr, Ptr>;
+
+    using Transporting::send;
+
+    static Pair createPair(IoStrand strandA, TransportInfo infoA,
+                           IoStrand strandB, TransportInfo infoB)
+    {
+        auto link = std::make_shared<LoopbackLink>();
+        Ptr a(new LoopbackTransport(strandA, infoA, link, 0));
+        Ptr b(new LoopbackTransport(strandB, infoB, link, 1));
+        a->peer_ = b;
+        a->peerStrand_.reset(new IoStrand(std::move(strandB)));
+        b->peer_ = a;
+        b->peerStrand_.reset(new IoStrand(std::move(strandA)));
+        return {std::move(a), std::move(b)};
+    }
+
+    ~LoopbackTransport() override {hangUp();}
+
+    TransportInfo info() const override {return info_;}
+
+    bool isStarted() const override {return running_;}
+
+    void start(RxHandler rxHandler, TxErrorHandler txErrorHandler) override
+    {
+        assert(!running_);
+        rxHandler_ = std::move(rxHandler);
+        txErrorHandler_ = std::move(txErrorHandler);
+        running_ = true;
+
+        // Deliver messages that were sent before this end was started.
+        if (!inbound().queue.empty() || link_->closed.load())
+            post(&LoopbackTransport::drain);
+    }
+
+    void send(MessageBuffer message) override
+    {
+        assert(running_);
+        if (link_->closed.load())
+            return;
+
+        if (message.size() > info_.maxTxLength)
+        {
+            if (txErrorHandler_)
+            {
+                auto handler = txErrorHandler_;
+                boost::asio::post(
+                    strand_,
+                    [handler]()
+                    {
+                        handler(make_error_code(TransportErrc::badTxLength));
+                    });
+            }
+            return;
+        }
+
+        auto& pipe = outbound();
+        pipe.queue.push(std::move(message));
+        if (!pipe.drainPending.exchange(true, std::memory_order_acq_rel))
+            postToPeer(&LoopbackTransport::drain);
+    }
+
+    void close() override
+    {
+        rxHandler_ = nullptr;
+        txErrorHandler_ = nullptr;
+        running_ = false;
+        hangUp();
+    }
+
+    void ping(MessageBuffer, PingHandler handler) override
+    {
+        assert(running_);
+
+        // Measures the round trip through the peer's strand.
+        auto start = std::chrono::high_resolution_clock::now();
+        auto self = std::static_pointer_cast<LoopbackTransport>(
+            shared_from_this());
+        boost::asio::post(
+            *peerStrand_,
+            [self, handler, start]()
+            {
+                boost::asio::post(
+                    self->strand_,
+                    [self, handler, start]()
+                    {
+                        if (!self->running_)
+                            return;
+                        using Ms = std::chrono::duration<float, std::milli>;
+                        auto now = std::chrono::high_resolution_clock::now();
+                        handler(Ms(now - start).count());
+                    });
+            });
+    }
+
+private:
+    using Pipe = LoopbackLink::Pipe;
+    using WeakPtr = std::weak_ptr<LoopbackTransport>;
+    using Member = void (LoopbackTransport::*)();
+
+    LoopbackTransport(IoStrand strand, TransportInfo info,
+                      std::shared_ptr<LoopbackLink> link, unsigned side)
+        : strand_(std::move(strand)),
+          info_(info),
+          link_(std::move(link)),
+          side_(side)
+    {}
+
+    Pipe& inbound() {return link_->pipes[side_];}
+
+    Pipe& outbound() {return link_->pipes[1 - side_];}
+
+    void post(Member member)
+    {
+        WeakPtr self = std::static_pointer_cast<LoopbackTransport>(
+            shared_from_this());
+        boost::asio::post(strand_, [self, member]()
+        {
+            auto ptr = self.lock();
+            if (ptr)
+                ((*ptr).*member)();
+        });
+    }
+
+    void postToPeer(Member member)
+    {
+        WeakPtr peer = peer_;
+        boost::asio::post(*peerStrand_, [peer, member]()
+        {
+            auto ptr = peer.lock();
+            if (ptr)
+                ((*ptr).*member)();
+        });
+    }
+
+    void hangUp()
+    {
+        if (!link_->closed.exchange(true))
+            postToPeer(&LoopbackTransport::drain);
+    }
+
+    void drain()
+    {
+        // Clearing the flag before popping ensures that a message pushed
+        // concurrently is either popped here or triggers another drain.
+        auto& pipe = inbound();
+        pipe.drainPending.exchange(false, std::memory_order_acq_rel);
+        if (!rxHandler_)
+            return;
+
+        auto handler = rxHandler_;
+        MessageBuffer message;
+        while (rxHandler_ && pipe.queue.pop(message))
+            handler(std::move(message));
+
+        if (rxHandler_ && link_->closed.load() && pipe.queue.empty())
+        {
+            rxHandler_ = nullptr;
+            txErrorHandler_ = nullptr;
+            running_ = false;
+            handler(makeUnexpectedError(std::errc::connection_reset));
+        }
+    }
+
+    IoStrand strand_;
+    TransportInfo info_;
+    std::shared_ptr<LoopbackLink> link_;
+    WeakPtr peer_;
+    std::unique_ptr<IoStrand> peerStrand_;
+    RxHandler rxHandler_;
+    TxErrorHandler txErrorHandler_;
+    unsigned side_ = 0;
+    bool running_ = false;
+};
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_LOOPBACKTRANSPORT_HPP
@@ -0,0 +1,104 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_MESSAGEHOLDER_HPP
+#define CPPWAMP_INTERNAL_MESSAGEHOLDER_HPP
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Specialize this to std::true_type for message types whose wrappers should
+// share a single immutable copy of the message until one of them modifies it.
+//------------------------------------------------------------------------------
+template <typename TMessage>
+struct IsSharedMessage : std::false_type {};
+
+//------------------------------------------------------------------------------
+struct InPlaceMessage {};
+
+//------------------------------------------------------------------------------
+// Holds a message by value.
+//------------------------------------------------------------------------------
+template <typename TMessage, bool = IsSharedMessage<TMessage>::value>
+class MessageHolder
+{
+public:
+    MessageHolder() = default;
+
+    template <typename... TArgs>
+    explicit MessageHolder(InPlaceMessage, TArgs&&... args)
+        : message_(std::forward<TArgs>(args)...)
+    {}
+
+    TMessage& get() {return message_;}
+
+    const TMessage& get() const {return message_;}
+
+private:
+    TMessage message_;
+};
+
+//------------------------------------------------------------------------------
+// Holds a reference-counted message that is copied on first modification,
+// so that copying the holder (e.g. to fan out an event to several handlers)
+// does not copy the message's payload.
+//------------------------------------------------------------------------------
+template <typename TMessage>
+class MessageHolder<TMessage, true>
+{
+public:
+    MessageHolder() = default;
+
+    template <typename... TArgs>
+    explicit MessageHolder(InPlaceMessage, TArgs&&... args)
+        : message_(std::make_shared<TMessage>(std::forward<TArgs>(args)...))
+    {}
+
+    TMessage& get()
+    {
+        if (!message_)
+        {
+            message_ = std::make_shared<TMessage>();
+        }
+        else if (message_.use_count() > 1)
+        {
+            message_ = std::make_shared<TMessage>(*message_);
+        }
+        else
+        {
+            // Synchronizes with other holders that were reading the message
+            // before they released their reference on another thread.
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *message_;
+    }
+
+    const TMessage& get() const {return message_ ? *message_ : empty();}
+
+private:
+    static const TMessage& empty()
+    {
+        static const TMessage message;
+        return message;
+    }
+
+    std::shared_ptr<TMessage> message_;
+};
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_MESSAGEHOLDER_HPP
@@ -0,0 +1,97 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_MPSCQUEUE_HPP
+#define CPPWAMP_INTERNAL_MPSCQUEUE_HPP
+
+#include <atomic>
+#include <utility>
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Unbounded lock-free queue allowing multiple producers and a single consumer
+// (Dmitry Vyukov's intrusive MPSC node-based queue). Pushing is wait-free.
+// Popping may transiently fail while a push is in progress; producers must
+// therefore notify the consumer after pushing, rather than before.
+//------------------------------------------------------------------------------
+template <typename T>
+class MpscQueue
+{
+public:
+    using value_type = T;
+
+    MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    // Noncopyable
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue()
+    {
+        T discarded;
+        while (pop(discarded)) {}
+        if (tail_ != &stub_)
+            delete tail_;
+    }
+
+    // May be called concurrently from any thread.
+    void push(T value)
+    {
+        auto node = new Node(std::move(value));
+        auto prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Must only be called from the consumer.
+    bool pop(T& value)
+    {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+
+        value = std::move(next->value);
+        next->value = T{};
+        tail_ = next;
+
+        // The popped value's node becomes the new stub.
+        if (tail != &stub_)
+            delete tail;
+        return true;
+    }
+
+    // Must only be called from the consumer.
+    bool empty() const
+    {
+        return tail_->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node
+    {
+        Node() = default;
+
+        explicit Node(T&& v) : value(std::move(v)) {}
+
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    Node stub_;
+    std::atomic<Node*> head_;
+    Node* tail_;
+};
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_MPSCQUEUE_HPP
@@ -77,6 +77,12 @@ public:
         return decoder_.decode(source.input(), variant);
     }
 
+    std::error_code decodeHeader(Source source, Variant& variant,
+                                 bool& payloadSkipped)
+    {
+        return decoder_.decodeHeader(source.input(), variant, payloadSkipped);
+    }
+
 private:
     struct Config
     {
@@ -107,6 +113,14 @@ std::error_code SourceDecoder<Msgpack, TSource>::decode(Source source,
     return impl_->decode(source, variant);
 }
 
+//------------------------------------------------------------------------------
+template <typename TSource>
+std::error_code SourceDecoder<Msgpack, TSource>::decodeHeader(
+    Source source, Variant& variant, bool& payloadSkipped)
+{
+    return impl_->decodeHeader(source, variant, payloadSkipped);
+}
+
 //------------------------------------------------------------------------------
 // Explicit template instantiations
 //------------------------------------------------------------------------------
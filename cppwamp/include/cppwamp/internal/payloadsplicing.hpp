@@ -0,0 +1,570 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_PAYLOADSPLICING_HPP
+#define CPPWAMP_INTERNAL_PAYLOADSPLICING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "../codec.hpp"
+#include "../messagebuffer.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Location of the trailing elements of an encoded WAMP message array, which
+// are its positional and keyword arguments.
+//------------------------------------------------------------------------------
+struct EncodedSlice
+{
+    std::size_t offset = 0;
+    std::size_t length = 0;
+    std::size_t count = 0;
+};
+
+//------------------------------------------------------------------------------
+class JsonSplicer
+{
+public:
+    // Finds the elements of the given message array starting from the given
+    // position, without decoding them.
+    static bool locate(const MessageBuffer& message, std::size_t pos,
+                       EncodedSlice& slice)
+    {
+        const auto* data = message.data();
+        auto size = message.size();
+        std::size_t i = skipSpace(data, size, 0);
+        if (i == size || data[i] != '[')
+            return false;
+        ++i;
+
+        std::size_t index = 0;
+        std::size_t depth = 0;
+        bool inString = false;
+        while (index < pos)
+        {
+            if (i >= size)
+                return false;
+            char c = static_cast<char>(data[i++]);
+            if (inString)
+            {
+                if (c == '\\')
+                    ++i;
+                else if (c == '"')
+                    inString = false;
+                continue;
+            }
+
+            switch (c)
+            {
+            case '"': inString = true; break;
+            case '[': case '{': ++depth; break;
+            case ']': case '}':
+                if (depth == 0)
+                    return false;
+                --depth;
+                break;
+            case ',': if (depth == 0) ++index; break;
+            default: break;
+            }
+        }
+        i = skipSpace(data, size, i);
+
+        // The elements end just before the closing bracket of the message.
+        auto end = trimSpace(data, i, size);
+        if (end == i || data[end - 1] != ']')
+            return false;
+        end = trimSpace(data, i, end - 1);
+        if (end == i)
+            return false;
+
+        slice.offset = i;
+        slice.length = end - i;
+        return true;
+    }
+
+    // Appends the given encoded elements to an encoded message array.
+    static bool append(MessageBuffer& message, const MessageBuffer& source,
+                       const EncodedSlice& slice)
+    {
+        auto end = trimSpace(message.data(), 0, message.size());
+        if (end < 2 || message[end - 1] != ']')
+            return false;
+        message.resize(trimSpace(message.data(), 0, end - 1));
+        if (message.empty())
+            return false;
+        if (message.back() != '[')
+            message.push_back(',');
+        auto first = source.begin() + slice.offset;
+        message.insert(message.end(), first, first + slice.length);
+        message.push_back(']');
+        return true;
+    }
+
+private:
+    static bool isSpace(uint8_t c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static std::size_t skipSpace(const uint8_t* data, std::size_t size,
+                                 std::size_t pos)
+    {
+        while (pos < size && isSpace(data[pos]))
+            ++pos;
+        return pos;
+    }
+
+    static std::size_t trimSpace(const uint8_t* data, std::size_t begin,
+                                 std::size_t end)
+    {
+        while (end > begin && isSpace(data[end - 1]))
+            --end;
+        return end;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Common parsing of big-endian binary formats.
+//------------------------------------------------------------------------------
+class BinaryCursor
+{
+public:
+    BinaryCursor(const MessageBuffer& buffer, std::size_t pos = 0)
+        : data_(buffer.data()),
+          size_(buffer.size()),
+          pos_(pos)
+    {}
+
+    std::size_t position() const {return pos_;}
+
+    std::size_t size() const {return size_;}
+
+    bool atEnd() const {return pos_ >= size_;}
+
+    bool peek(uint8_t& byte) const
+    {
+        if (atEnd())
+            return false;
+        byte = data_[pos_];
+        return true;
+    }
+
+    bool read(uint8_t& byte)
+    {
+        if (!peek(byte))
+            return false;
+        ++pos_;
+        return true;
+    }
+
+    bool readBigEndian(std::size_t byteCount, uint64_t& value)
+    {
+        if (size_ - pos_ < byteCount)
+            return false;
+        value = 0;
+        for (std::size_t i=0; i<byteCount; ++i)
+            value = (value << 8) | data_[pos_++];
+        return true;
+    }
+
+    bool skip(uint64_t byteCount)
+    {
+        if (size_ - pos_ < byteCount)
+            return false;
+        pos_ += static_cast<std::size_t>(byteCount);
+        return true;
+    }
+
+    static void writeBigEndian(MessageBuffer& out, std::size_t byteCount,
+                               uint64_t value)
+    {
+        for (std::size_t i=byteCount; i>0; --i)
+            out.push_back(static_cast<uint8_t>(value >> ((i - 1) * 8)));
+    }
+
+private:
+    const uint8_t* data_;
+    std::size_t size_;
+    std::size_t pos_;
+};
+
+//------------------------------------------------------------------------------
+class MsgpackSplicer
+{
+public:
+    static bool locate(const MessageBuffer& message, std::size_t pos,
+                       EncodedSlice& slice)
+    {
+        BinaryCursor cursor(message);
+        uint64_t count = 0;
+        if (!readArrayHeader(cursor, count) || count != pos + slice.count)
+            return false;
+
+        // Elements are skipped iteratively by tracking how many are pending.
+        uint64_t pending = pos;
+        while (pending != 0)
+        {
+            --pending;
+            uint64_t children = 0;
+            if (!skipElement(cursor, children))
+                return false;
+            pending += children;
+        }
+
+        slice.offset = cursor.position();
+        slice.length = message.size() - slice.offset;
+        return slice.length != 0;
+    }
+
+    static bool append(MessageBuffer& message, const MessageBuffer& source,
+                       const EncodedSlice& slice)
+    {
+        BinaryCursor cursor(message);
+        uint64_t count = 0;
+        if (!readArrayHeader(cursor, count))
+            return false;
+
+        MessageBuffer header;
+        count += slice.count;
+        if (count < 16)
+        {
+            header.push_back(static_cast<uint8_t>(0x90 | count));
+        }
+        else if (count <= 0xFFFF)
+        {
+            header.push_back(0xdc);
+            BinaryCursor::writeBigEndian(header, 2, count);
+        }
+        else
+        {
+            header.push_back(0xdd);
+            BinaryCursor::writeBigEndian(header, 4, count);
+        }
+
+        auto oldHeaderEnd = message.begin() + cursor.position();
+        message.erase(message.begin(), oldHeaderEnd);
+        message.insert(message.begin(), header.begin(), header.end());
+        auto first = source.begin() + slice.offset;
+        message.insert(message.end(), first, first + slice.length);
+        return true;
+    }
+
+private:
+    static bool readArrayHeader(BinaryCursor& cursor, uint64_t& count)
+    {
+        uint8_t byte = 0;
+        if (!cursor.read(byte))
+            return false;
+        if ((byte & 0xF0) == 0x90)
+        {
+            count = byte & 0x0F;
+            return true;
+        }
+        if (byte == 0xdc)
+            return cursor.readBigEndian(2, count);
+        if (byte == 0xdd)
+            return cursor.readBigEndian(4, count);
+        return false;
+    }
+
+    // Skips the element at the cursor, except for the children of arrays and
+    // maps, whose number is returned instead.
+    static bool skipElement(BinaryCursor& cursor, uint64_t& children)
+    {
+        uint8_t byte = 0;
+        if (!cursor.read(byte))
+            return false;
+
+        uint64_t n = 0;
+        if (byte <= 0x7f || byte >= 0xe0)
+            return true;
+        if (byte <= 0x8f)
+        {
+            children = 2 * (byte & 0x0F);
+            return true;
+        }
+        if (byte <= 0x9f)
+        {
+            children = byte & 0x0F;
+            return true;
+        }
+        if (byte <= 0xbf)
+            return cursor.skip(byte & 0x1F);
+
+        switch (byte)
+        {
+        case 0xc0: case 0xc2: case 0xc3: return true;
+        case 0xc4: case 0xd9:
+            return cursor.readBigEndian(1, n) && cursor.skip(n);
+        case 0xc5: case 0xda:
+            return cursor.readBigEndian(2, n) && cursor.skip(n);
+        case 0xc6: case 0xdb:
+            return cursor.readBigEndian(4, n) && cursor.skip(n);
+        case 0xc7: return cursor.readBigEndian(1, n) && cursor.skip(n + 1);
+        case 0xc8: return cursor.readBigEndian(2, n) && cursor.skip(n + 1);
+        case 0xc9: return cursor.readBigEndian(4, n) && cursor.skip(n + 1);
+        case 0xca: return cursor.skip(4);
+        case 0xcb: return cursor.skip(8);
+        case 0xcc: case 0xd0: return cursor.skip(1);
+        case 0xcd: case 0xd1: return cursor.skip(2);
+        case 0xce: case 0xd2: return cursor.skip(4);
+        case 0xcf: case 0xd3: return cursor.skip(8);
+        case 0xd4: return cursor.skip(2);
+        case 0xd5: return cursor.skip(3);
+        case 0xd6: return cursor.skip(5);
+        case 0xd7: return cursor.skip(9);
+        case 0xd8: return cursor.skip(17);
+        case 0xdc:
+            return cursor.readBigEndian(2, children);
+        case 0xdd:
+            return cursor.readBigEndian(4, children);
+        case 0xde:
+            if (!cursor.readBigEndian(2, n))
+                return false;
+            children = 2 * n;
+            return true;
+        case 0xdf:
+            if (!cursor.readBigEndian(4, n))
+                return false;
+            children = 2 * n;
+            return true;
+        default: break;
+        }
+        return false;
+    }
+};
+
+//------------------------------------------------------------------------------
+class CborSplicer
+{
+public:
+    static bool locate(const MessageBuffer& message, std::size_t pos,
+                       EncodedSlice& slice)
+    {
+        BinaryCursor cursor(message);
+        uint64_t count = 0;
+        bool indefinite = false;
+        if (!readArrayHeader(cursor, count, indefinite))
+            return false;
+        if (!indefinite && count != pos + slice.count)
+            return false;
+
+        for (std::size_t i=0; i<pos; ++i)
+        {
+            if (!skipItem(cursor))
+                return false;
+        }
+
+        auto end = message.size();
+        if (indefinite)
+        {
+            if (end == 0 || message[end - 1] != breakCode)
+                return false;
+            --end;
+        }
+
+        slice.offset = cursor.position();
+        if (end <= slice.offset)
+            return false;
+        slice.length = end - slice.offset;
+        return true;
+    }
+
+    static bool append(MessageBuffer& message, const MessageBuffer& source,
+                       const EncodedSlice& slice)
+    {
+        BinaryCursor cursor(message);
+        uint64_t count = 0;
+        bool indefinite = false;
+        if (!readArrayHeader(cursor, count, indefinite))
+            return false;
+
+        auto first = source.begin() + slice.offset;
+        if (indefinite)
+        {
+            if (message.back() != breakCode)
+                return false;
+            message.pop_back();
+            message.insert(message.end(), first, first + slice.length);
+            message.push_back(uint8_t(breakCode));
+            return true;
+        }
+
+        MessageBuffer header;
+        writeHead(header, 4, count + slice.count);
+        message.erase(message.begin(), message.begin() + cursor.position());
+        message.insert(message.begin(), header.begin(), header.end());
+        message.insert(message.end(), first, first + slice.length);
+        return true;
+    }
+
+private:
+    static constexpr unsigned indefiniteInfo = 31;
+    static constexpr uint8_t breakCode = 0xFF;
+
+    static bool readHead(BinaryCursor& cursor, unsigned& major,
+                         uint64_t& argument, bool& indefinite)
+    {
+        uint8_t byte = 0;
+        if (!cursor.read(byte))
+            return false;
+        major = byte >> 5;
+        unsigned info = byte & 0x1F;
+        indefinite = false;
+        argument = 0;
+
+        if (info < 24)
+        {
+            argument = info;
+            return true;
+        }
+
+        switch (info)
+        {
+        case 24: return cursor.readBigEndian(1, argument);
+        case 25: return cursor.readBigEndian(2, argument);
+        case 26: return cursor.readBigEndian(4, argument);
+        case 27: return cursor.readBigEndian(8, argument);
+        case indefiniteInfo:
+            indefinite = true;
+            return major >= 2 && major <= 5;
+        default: break;
+        }
+        return false;
+    }
+
+    static void writeHead(MessageBuffer& out, unsigned major, uint64_t arg)
+    {
+        auto type = static_cast<uint8_t>(major << 5);
+        if (arg < 24)
+        {
+            out.push_back(static_cast<uint8_t>(type | arg));
+        }
+        else if (arg <= 0xFF)
+        {
+            out.push_back(type | 24);
+            BinaryCursor::writeBigEndian(out, 1, arg);
+        }
+        else if (arg <= 0xFFFF)
+        {
+            out.push_back(type | 25);
+            BinaryCursor::writeBigEndian(out, 2, arg);
+        }
+        else if (arg <= 0xFFFFFFFF)
+        {
+            out.push_back(type | 26);
+            BinaryCursor::writeBigEndian(out, 4, arg);
+        }
+        else
+        {
+            out.push_back(type | 27);
+            BinaryCursor::writeBigEndian(out, 8, arg);
+        }
+    }
+
+    static bool readArrayHeader(BinaryCursor& cursor, uint64_t& count,
+                                bool& indefinite)
+    {
+        unsigned major = 0;
+        return readHead(cursor, major, count, indefinite) && major == 4;
+    }
+
+    static bool skipItem(BinaryCursor& cursor)
+    {
+        unsigned major = 0;
+        uint64_t arg = 0;
+        bool indefinite = false;
+        uint8_t byte = 0;
+        if (!cursor.peek(byte) || byte == breakCode)
+            return false;
+        if (!readHead(cursor, major, arg, indefinite))
+            return false;
+
+        if (indefinite)
+        {
+            // Strings are split into chunks, and containers have their
+            // elements, all terminated by a break code.
+            while (cursor.peek(byte) && byte != breakCode)
+            {
+                if (!skipItem(cursor))
+                    return false;
+            }
+            uint8_t terminator = 0;
+            return cursor.read(terminator);
+        }
+
+        switch (major)
+        {
+        case 2: case 3: return cursor.skip(arg);
+        case 4:
+            for (uint64_t i=0; i<arg; ++i)
+                if (!skipItem(cursor))
+                    return false;
+            return true;
+        case 5:
+            for (uint64_t i=0; i<2*arg; ++i)
+                if (!skipItem(cursor))
+                    return false;
+            return true;
+        case 6: return skipItem(cursor);
+        default: break;
+        }
+        return true;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Finds the encoded positional and keyword arguments of the given raw message
+// that was encoded in the given format. The slice's count must be set
+// beforehand to the number of argument fields in the message.
+//------------------------------------------------------------------------------
+inline bool locateEncodedPayload(int codecId, const MessageBuffer& message,
+                                 std::size_t payloadPos, EncodedSlice& slice)
+{
+    switch (codecId)
+    {
+    case KnownCodecIds::json():
+        return JsonSplicer::locate(message, payloadPos, slice);
+    case KnownCodecIds::msgpack():
+        return MsgpackSplicer::locate(message, payloadPos, slice);
+    case KnownCodecIds::cbor():
+        return CborSplicer::locate(message, payloadPos, slice);
+    default: break;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+// Appends the encoded arguments located in a source message to a message
+// array that was encoded in the same format without its arguments.
+//------------------------------------------------------------------------------
+inline bool appendEncodedPayload(int codecId, MessageBuffer& message,
+                                 const MessageBuffer& source,
+                                 const EncodedSlice& slice)
+{
+    switch (codecId)
+    {
+    case KnownCodecIds::json():
+        return JsonSplicer::append(message, source, slice);
+    case KnownCodecIds::msgpack():
+        return MsgpackSplicer::append(message, source, slice);
+    case KnownCodecIds::cbor():
+        return CborSplicer::append(message, source, slice);
+    default: break;
+    }
+    return false;
+}
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_PAYLOADSPLICING_HPP
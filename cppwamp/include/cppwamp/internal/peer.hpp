@@ -10,7 +10,6 @@
 #include <atomic>
 #include <cassert>
 #include <functional>
-#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -24,6 +23,10 @@
 #include "../transport.hpp"
 #include "../variant.hpp"
 #include "../wampdefs.hpp"
+#include "encodedsize.hpp"
+#include "lazypayload.hpp"
+#include "payloadsplicing.hpp"
+#include "requesttable.hpp"
 #include "wampmessage.hpp"
 
 namespace wamp
@@ -46,6 +49,7 @@ public:
     using LogHandler            = AnyReusableHandler<void (LogEntry)>;
     using LogStringHandler      = AnyReusableHandler<void (std::string)>; // TODO: Remove
     using StateChangeHandler    = AnyReusableHandler<void (State)>;
+    using TxSpaceHandler        = Transporting::TxSpaceHandler;
 
     explicit Peer(bool isRouter, AnyIoExecutor exec)
         : strand_(boost::asio::make_strand(exec)),
@@ -53,6 +57,7 @@ public:
           state_(State::disconnected),
           logLevel_(LogLevel::warning),
           isTerminating_(false),
+          lazyPayloads_(false),
           isRouter_(isRouter)
     {}
 
@@ -69,6 +74,7 @@ public:
           state_(State::disconnected),
           logLevel_(LogLevel::warning),
           isTerminating_(false),
+          lazyPayloads_(false),
           isRouter_(isRouter)
     {}
 
@@ -157,15 +163,38 @@ public:
 
     void setTerminating(bool terminating) {isTerminating_.store(terminating);}
 
+    void setLazyPayloads(bool enabled) {lazyPayloads_.store(enabled);}
+
     bool isTerminating() const {return isTerminating_.load();}
 
+    void setTxWatermarks(TxWatermarks watermarks)
+    {
+        txWatermarks_ = watermarks;
+        if (transport_)
+            transport_->setTxWatermarks(watermarks);
+    }
+
+    bool isTxBlocked() const {return transport_ && transport_->isTxBlocked();}
+
+    void awaitTxSpace(TxSpaceHandler handler)
+    {
+        if (transport_)
+            transport_->awaitTxSpace(std::move(handler));
+        else
+            post(std::move(handler),
+                 make_error_code(SessionErrc::invalidState));
+    }
+
     void open(Transporting::Ptr transport, AnyBufferCodec codec)
     {
         assert(state() == State::connecting);
         transport_ = std::move(transport);
         codec_ = std::move(codec);
         setState(State::closed);
-        maxTxLength_ = transport_->info().maxTxLength;
+        transport_->setTxWatermarks(txWatermarks_);
+        auto info = transport_->info();
+        maxTxLength_ = info.maxTxLength;
+        codecId_ = info.codecId;
     }
 
     void start()
@@ -321,8 +350,8 @@ private:
     static constexpr unsigned progressiveResponseFlag_ = 0x01;
 
     using RequestKey = typename Message::RequestKey;
-    using OneShotRequestMap = std::map<RequestKey, OneShotHandler>;
-    using MultiShotRequestMap = std::map<RequestKey, MultiShotHandler>;
+    using OneShotRequestMap = RequestTable<RequestKey, OneShotHandler>;
+    using MultiShotRequestMap = RequestTable<RequestKey, MultiShotHandler>;
 
     template <typename TFunctor, typename... TArgs>
     void post(TFunctor&& fn, TArgs&&... args)
@@ -332,20 +361,53 @@ private:
                                     std::forward<TArgs>(args)...));
     }
 
+    static TxPriority txPriorityOf(WampMsgType type)
+    {
+        // CANCEL shares the lane of the CALL it cancels, and GOODBYE is
+        // queued behind everything else, so that neither can overtake the
+        // messages they must follow.
+        using W = WampMsgType;
+        switch (type)
+        {
+        case W::hello:
+        case W::welcome:
+        case W::abort:
+        case W::challenge:
+        case W::authenticate:
+            return TxPriority::control;
+
+        case W::publish:
+        case W::event:
+        case W::goodbye:
+            return TxPriority::bulk;
+
+        default:
+            return TxPriority::rpc;
+        }
+    }
+
     ErrorOr<RequestId> sendMessage(Message& msg)
     {
         assert(msg.type() != WampMsgType::none);
 
         auto requestId = setMessageRequestId(msg);
 
-        MessageBuffer buffer;
-        codec_.encode(msg.fields(), buffer);
+        // Reject payloads that are certain to be too big without having
+        // to encode them first.
+        if (encodedSizeExceeds(msg.fields(), maxTxLength_))
+            return makeUnexpectedError(SessionErrc::payloadSizeExceeded);
+
+        assert(transport_ != nullptr);
+        auto buffer = transport_->acquireBuffer();
+        encode(msg, buffer);
         if (buffer.size() > maxTxLength_)
+        {
+            transport_->recycle(std::move(buffer));
             return makeUnexpectedError(SessionErrc::payloadSizeExceeded);
+        }
 
         traceTx(msg);
-        assert(transport_ != nullptr);
-        transport_->send(std::move(buffer));
+        transport_->send(std::move(buffer), txPriorityOf(msg.type()));
         return requestId;
     }
 
@@ -356,11 +418,20 @@ private:
         assert(msg.type() != WampMsgType::none);
 
         auto requestId = setMessageRequestId(msg);
-        MessageBuffer buffer;
-        codec_.encode(msg.fields(), buffer);
+        if (encodedSizeExceeds(msg.fields(), maxTxLength_))
+        {
+            post(std::move(handler),
+                 makeUnexpectedError(SessionErrc::payloadSizeExceeded));
+            return requestId;
+        }
+
+        assert(transport_ != nullptr);
+        auto buffer = transport_->acquireBuffer();
+        encode(msg, buffer);
 
         if (buffer.size() > maxTxLength_)
         {
+            transport_->recycle(std::move(buffer));
             post(std::move(handler),
                  makeUnexpectedError(SessionErrc::payloadSizeExceeded));
             return requestId;
@@ -380,11 +451,40 @@ private:
 
         requests.emplace(msg.requestKey(), std::move(handler));
         traceTx(msg);
-        assert(transport_ != nullptr);
-        transport_->send(std::move(buffer));
+        transport_->send(std::move(buffer), txPriorityOf(msg.type()));
         return requestId;
     }
 
+    void encode(Message& msg, MessageBuffer& buffer)
+    {
+        if (msg.hasLazyPayload())
+        {
+            if (encodeSpliced(msg, buffer))
+                return;
+            buffer.clear();
+            msg.loadPayload();
+        }
+        codec_.encode(msg.fields(), buffer);
+    }
+
+    // Encodes the message without its arguments, and then appends the
+    // arguments still encoded within the received message they came from.
+    bool encodeSpliced(const Message& msg, MessageBuffer& buffer)
+    {
+        const auto& payload = *msg.lazyPayload();
+        if (payload.codecId() != codecId_ || logLevel() <= LogLevel::trace)
+            return false;
+
+        EncodedSlice slice;
+        if (!payload.locateEncoded(slice))
+            return false;
+
+        auto first = msg.fields().begin();
+        Array header(first, first + msg.payloadPosition());
+        codec_.encode(header, buffer);
+        return appendEncodedPayload(codecId_, buffer, payload.bytes(), slice);
+    }
+
     RequestId setMessageRequestId(Message& msg)
     {
         RequestId requestId = nullRequestId();
@@ -420,7 +520,19 @@ private:
         }
 
         Variant v;
-        auto ec = codec_.decode(buffer, v);
+        std::error_code ec;
+        bool payloadSkipped = false;
+        if (decodesLazily())
+            ec = codec_.decodeHeader(buffer, v, payloadSkipped);
+        else
+            ec = codec_.decode(buffer, v);
+
+        // The decoded variant no longer refers to the raw bytes, so the buffer
+        // can be handed back for the transport's next received message.
+        // Skipped payload arguments are instead decoded from the raw bytes if
+        // and when they are accessed.
+        if (transport_ && !payloadSkipped)
+            transport_->recycle(std::move(buffer));
         if (ec)
             return fail(ec, "Error deserializing received WAMP message");
 
@@ -440,9 +552,22 @@ private:
         if (!msg->traits().isValidRx(state(), isRouter_))
             return fail(errc, "Received invalid WAMP message for peer role");
 
+        if (payloadSkipped)
+        {
+            auto pos = msg->payloadPosition();
+            auto count = msg->fields().size() - pos;
+            msg->setLazyPayload(std::make_shared<LazyPayload>(
+                std::move(buffer), codec_, codecId_, pos, count));
+        }
         processMessage(std::move(*msg));
     }
 
+    bool decodesLazily() const
+    {
+        // Traces of received messages should show their entire payload.
+        return lazyPayloads_.load() && logLevel() > LogLevel::trace;
+    }
+
     void processMessage(Message&& msg)
     {
         if (msg.repliesTo() != WampMsgType::none)
@@ -509,7 +634,9 @@ private:
             {
                 if (msg.isProgressiveResponse())
                 {
-                    const auto& handler = kv->second;
+                    // The handler is copied, as it may issue new requests
+                    // that relocate the table entries.
+                    auto handler = kv->second;
                     handler(std::move(msg));
                 }
                 else
@@ -699,11 +826,14 @@ private:
     StateChangeHandler stateChangeHandler_;
     OneShotRequestMap oneShotRequestMap_;
     MultiShotRequestMap multiShotRequestMap_;
+    TxWatermarks txWatermarks_;
     std::atomic<State> state_;
     std::atomic<LogLevel> logLevel_;
     std::atomic<bool> isTerminating_;
+    std::atomic<bool> lazyPayloads_;
     RequestId nextRequestId_ = nullRequestId();
     std::size_t maxTxLength_ = 0;
+    int codecId_ = 0;
     bool isRouter_ = false;
 
     static constexpr RequestId maxRequestId_ = 9007199254740992ull;
@@ -94,6 +94,7 @@ private:
     RawsockConnector(IoStrand i, Settings s, int codecId)
         : codecId_(codecId),
           maxRxLength_(s.maxRxLength()),
+          rawsockOptions_(s.rawsockOptions()),
           opener_(std::move(i), std::move(s))
     {}
 
@@ -158,7 +159,8 @@ private:
         TransportInfo i{codecId_,
                         hs.maxLengthInBytes(),
                         Handshake::byteLengthOf(maxRxLength_)};
-        Transporting::Ptr transport{Transport::create(std::move(socket_), i)};
+        Transporting::Ptr transport{Transport::create(std::move(socket_), i,
+                                                      rawsockOptions_)};
         socket_.reset();
         dispatchHandler(std::move(transport));
     }
@@ -181,6 +183,7 @@ private:
     Handler handler_;
     int codecId_;
     RawsockMaxLength maxRxLength_;
+    RawsockOptions rawsockOptions_;
     uint32_t handshake_;
     Opener opener_;
 };
@@ -96,6 +96,7 @@ private:
     RawsockListener(IoStrand i, Settings s, CodecIds codecIds)
         : codecIds_(std::move(codecIds)),
           maxRxLength_(s.maxRxLength()),
+          rawsockOptions_(s.rawsockOptions()),
           acceptor_(std::move(i), std::move(s))
     {}
 
@@ -169,7 +170,8 @@ private:
         TransportInfo i{hs.codecId(),
                         Handshake::byteLengthOf(maxTxLength_),
                         Handshake::byteLengthOf(maxRxLength_)};
-        Transporting::Ptr transport{Transport::create(std::move(socket_), i)};
+        Transporting::Ptr transport{Transport::create(std::move(socket_), i,
+                                                      rawsockOptions_)};
         socket_.reset();
         dispatchHandler(std::move(transport));
     }
@@ -193,6 +195,7 @@ private:
     CodecIds codecIds_;
     RawsockMaxLength maxTxLength_;
     RawsockMaxLength maxRxLength_;
+    RawsockOptions rawsockOptions_;
     uint32_t handshake_;
     Acceptor acceptor_;
 };
@@ -0,0 +1,45 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include "../rawsockoptions.hpp"
+#include "../api.hpp"
+
+namespace wamp
+{
+
+CPPWAMP_INLINE RawsockOptions&
+RawsockOptions::withTxBatching(std::size_t maxMessages, std::size_t maxBytes)
+{
+    txBatchMaxMessages_ = (maxMessages == 0) ? 1 : maxMessages;
+    txBatchMaxBytes_ = maxBytes;
+    return *this;
+}
+
+CPPWAMP_INLINE RawsockOptions&
+RawsockOptions::withRxBuffering(std::size_t bufferSize)
+{
+    if (bufferSize != 0 && bufferSize < minRxBufferSize)
+        bufferSize = minRxBufferSize;
+    rxBufferSize_ = bufferSize;
+    return *this;
+}
+
+CPPWAMP_INLINE std::size_t RawsockOptions::txBatchMaxMessages() const
+{
+    return txBatchMaxMessages_;
+}
+
+CPPWAMP_INLINE std::size_t RawsockOptions::txBatchMaxBytes() const
+{
+    return txBatchMaxBytes_;
+}
+
+CPPWAMP_INLINE std::size_t RawsockOptions::rxBufferSize() const
+{
+    return rxBufferSize_;
+}
+
+} // namespace wamp
@@ -7,9 +7,13 @@
 #ifndef CPPWAMP_INTERNAL_RAWSOCKTRANSPORT_HPP
 #define CPPWAMP_INTERNAL_RAWSOCKTRANSPORT_HPP
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <deque>
 #include <functional>
 #include <memory>
@@ -26,6 +30,7 @@
 #include "../asiodefs.hpp"
 #include "../error.hpp"
 #include "../messagebuffer.hpp"
+#include "../rawsockoptions.hpp"
 #include "../transport.hpp"
 #include "rawsockheader.hpp"
 
@@ -54,8 +59,19 @@ public:
 
     void clear() {header_ = 0; payload_.clear();}
 
+    void shrink() {MessageBuffer{}.swap(payload_);}
+
+    // Takes over the given storage for the payload, discarding its contents.
+    void adopt(MessageBuffer&& storage)
+    {
+        payload_ = std::move(storage);
+        payload_.clear();
+    }
+
     void resize(size_t length) {payload_.resize(length);}
 
+    std::size_t capacity() const {return payload_.capacity();}
+
     void prepare(RawsockMsgType type, MessageBuffer&& payload)
     {
         header_ = computeHeader(type, payload);
@@ -64,6 +80,9 @@ public:
 
     RawsockHeader header() const {return RawsockHeader::fromBigEndian(header_);}
 
+    // Number of bytes occupied by the frame on the wire.
+    std::size_t wireSize() const {return sizeof(header_) + payload_.size();}
+
     const MessageBuffer& payload() const & {return payload_;}
 
     MessageBuffer&& payload() && {return std::move(payload_);}
@@ -97,14 +116,149 @@ private:
     MessageBuffer payload_;
 };
 
+//------------------------------------------------------------------------------
+// Bounded pool of RawsockFrame objects, so that steady-state sends don't need
+// to allocate a new frame (and its shared_ptr control block) per message.
+//------------------------------------------------------------------------------
+class RawsockFramePool
+{
+public:
+    RawsockFramePool(std::size_t capacity, std::size_t maxRetainedPayload)
+        : capacity_(capacity),
+          maxRetainedPayload_(maxRetainedPayload)
+    {
+        idle_.reserve(capacity);
+    }
+
+    RawsockFrame::Ptr acquire()
+    {
+        if (idle_.empty())
+        {
+            ++allocationCount_;
+            return std::make_shared<RawsockFrame>();
+        }
+
+        auto frame = std::move(idle_.back());
+        idle_.pop_back();
+        return frame;
+    }
+
+    void release(RawsockFrame::Ptr&& frame)
+    {
+        // Frames still referenced elsewhere (e.g. an outstanding ping frame)
+        // are not recycled.
+        RawsockFrame::Ptr released(std::move(frame));
+        if (!released || released.use_count() != 1 ||
+            idle_.size() >= capacity_)
+        {
+            return;
+        }
+
+        released->clear();
+        if (released->capacity() > maxRetainedPayload_)
+            released->shrink();
+        idle_.push_back(std::move(released));
+    }
+
+    void clear() {idle_.clear();}
+
+    std::size_t capacity() const {return capacity_;}
+
+    std::size_t idleCount() const {return idle_.size();}
+
+    // Number of frames that had to be allocated because none were idle.
+    std::size_t allocationCount() const {return allocationCount_;}
+
+private:
+    std::vector<RawsockFrame::Ptr> idle_;
+    std::size_t capacity_ = 0;
+    std::size_t maxRetainedPayload_ = 0;
+    std::size_t allocationCount_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Queue of outbound frames segregated into priority lanes. Frames are taken
+// from the highest-priority lane that is not empty, in FIFO order within
+// each lane.
+//------------------------------------------------------------------------------
+class RawsockTxQueue
+{
+public:
+    void push(RawsockFrame::Ptr frame, TxPriority priority)
+    {
+        lanes_.at(static_cast<std::size_t>(priority)).push_back(
+            std::move(frame));
+    }
+
+    bool empty() const
+    {
+        return std::all_of(lanes_.begin(), lanes_.end(),
+                           [](const Lane& lane) {return lane.empty();});
+    }
+
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+        for (const auto& lane: lanes_)
+            n += lane.size();
+        return n;
+    }
+
+    // Number of bytes occupied on the wire by all queued frames.
+    std::size_t wireSize() const
+    {
+        std::size_t n = 0;
+        for (const auto& lane: lanes_)
+            for (const auto& frame: lane)
+                n += frame->wireSize();
+        return n;
+    }
+
+    // Precondition: !empty()
+    RawsockFrame::Ptr& front() {return frontLane().front();}
+
+    // Precondition: !empty()
+    void pop() {frontLane().pop_front();}
+
+    void clear()
+    {
+        for (auto& lane: lanes_)
+            lane.clear();
+    }
+
+private:
+    using Lane = std::deque<RawsockFrame::Ptr>;
+
+    Lane& frontLane()
+    {
+        auto found = std::find_if(lanes_.begin(), lanes_.end(),
+                                  [](const Lane& lane) {return !lane.empty();});
+        assert(found != lanes_.end());
+        return *found;
+    }
+
+    std::array<Lane, 3> lanes_;
+};
+
 //------------------------------------------------------------------------------
 struct DefaultRawsockTransportConfig
 {
-    static RawsockFrame::Ptr enframe(RawsockMsgType type,
-                                     MessageBuffer&& payload)
+    // Maximum number of idle frames kept by each transport for reuse.
+    static constexpr std::size_t framePoolCapacity() {return 16;}
+
+    // Idle frames with larger payload capacities have their storage released.
+    static constexpr std::size_t maxPooledPayloadCapacity() {return 64*1024;}
+
+    // Maximum number of recycled message buffers kept by each transport.
+    static constexpr std::size_t bufferPoolCapacity() {return 16;}
+
+    // Storage reserved in freshly allocated outbound message buffers.
+    static constexpr std::size_t initialTxBufferCapacity() {return 1024;}
+
+    static void enframe(RawsockFrame& frame, RawsockMsgType type,
+                        MessageBuffer&& payload)
     {
-        // TODO: Reuse frames somehow
-        return std::make_shared<RawsockFrame>(type, std::move(payload));
+        frame.prepare(type, std::move(payload));
     }
 };
 
@@ -120,10 +274,13 @@ public:
     using RxHandler      = typename Transporting::RxHandler;
     using TxErrorHandler = typename Transporting::TxErrorHandler;
     using PingHandler    = typename Transporting::PingHandler;
+    using TxSpaceHandler = typename Transporting::TxSpaceHandler;
 
-    static Ptr create(SocketPtr&& s, TransportInfo info)
+    static Ptr create(SocketPtr&& s, TransportInfo info,
+                      RawsockOptions options = {})
     {
-        return Ptr(new RawsockTransport(std::move(s), info));
+        return Ptr(new RawsockTransport(std::move(s), info,
+                                        std::move(options)));
     }
 
     TransportInfo info() const override {return info_;}
@@ -140,17 +297,22 @@ public:
     }
 
     void send(MessageBuffer message) override
+    {
+        send(std::move(message), TxPriority::rpc);
+    }
+
+    void send(MessageBuffer message, TxPriority priority) override
     {
         assert(running_);
         auto buf = enframe(RawsockMsgType::wamp, std::move(message));
-        sendFrame(std::move(buf));
+        sendFrame(std::move(buf), priority);
     }
 
     void close() override
     {
         rxHandler_ = nullptr;
         txErrorHandler_ = nullptr;
-        txQueue_.clear();
+        discardTxQueue(make_error_code(TransportErrc::aborted));
         running_ = false;
         if (socket_)
             socket_->close();
@@ -161,32 +323,108 @@ public:
         assert(running_);
         pingHandler_ = std::move(handler);
         pingFrame_ = enframe(RawsockMsgType::ping, std::move(message));
-        sendFrame(pingFrame_);
+        sendFrame(pingFrame_, TxPriority::control);
         pingStart_ = std::chrono::high_resolution_clock::now();
     }
 
+    MessageBuffer acquireBuffer() override
+    {
+        if (spareBuffers_.empty())
+        {
+            ++txAllocationCount_;
+            MessageBuffer buffer;
+            buffer.reserve((std::min)(Config::initialTxBufferCapacity(),
+                                      info_.maxTxLength));
+            return buffer;
+        }
+
+        auto buffer = takeSpareBuffer();
+        buffer.clear();
+        return buffer;
+    }
+
+    void recycle(MessageBuffer&& buffer) override
+    {
+        if (spareBuffers_.size() < Config::bufferPoolCapacity() &&
+            buffer.capacity() != 0 &&
+            buffer.capacity() <= Config::maxPooledPayloadCapacity())
+        {
+            spareBuffers_.push_back(std::move(buffer));
+        }
+    }
+
+    void setTxWatermarks(TxWatermarks watermarks) override
+    {
+        txWatermarks_ = watermarks;
+        updateTxBlocked();
+    }
+
+    bool isTxBlocked() const override {return txBlocked_;}
+
+    std::size_t txQueuedBytes() const override {return txBytes_;}
+
+    std::size_t txQueuedFrames() const override {return txFrames_;}
+
+    void awaitTxSpace(TxSpaceHandler handler) override
+    {
+        if (!socket_)
+            post(std::move(handler), make_error_code(TransportErrc::aborted));
+        else if (!txBlocked_)
+            post(std::move(handler), std::error_code{});
+        else
+            txSpaceHandlers_.push_back(std::move(handler));
+    }
+
+    const RawsockFramePool& framePool() const {return framePool_;}
+
+    // Number of received payloads that could not reuse a recycled buffer.
+    std::size_t rxAllocationCount() const {return rxAllocationCount_;}
+
+    // Number of outbound buffers that could not reuse a recycled buffer.
+    std::size_t txAllocationCount() const {return txAllocationCount_;}
+
+    // Number of socket writes issued, each carrying a batch of frames.
+    std::size_t txWriteCount() const {return txWriteCount_;}
+
+    // Largest number of frames carried by a single socket write.
+    std::size_t txBatchHighWater() const {return txBatchHighWater_;}
+
 private:
     using Base = Transporting;
-    using TransmitQueue = std::deque<RawsockFrame::Ptr>;
+    using TransmitBatch = std::vector<RawsockFrame::Ptr>;
+    using TxSpaceHandlers = std::vector<TxSpaceHandler>;
+    using GatherBuffers = std::vector<boost::asio::const_buffer>;
     using TimePoint     = std::chrono::high_resolution_clock::time_point;
 
-    RawsockTransport(SocketPtr&& socket, TransportInfo info)
+    RawsockTransport(SocketPtr&& socket, TransportInfo info,
+                     RawsockOptions options)
         : strand_(boost::asio::make_strand(socket->get_executor())),
         socket_(std::move(socket)),
-        info_(info)
-    {}
+        info_(info),
+        options_(std::move(options)),
+        framePool_(Config::framePoolCapacity(),
+                   Config::maxPooledPayloadCapacity())
+    {
+        rxBuffer_.resize(options_.rxBufferSize());
+        spareBuffers_.reserve(Config::bufferPoolCapacity());
+    }
 
     RawsockFrame::Ptr enframe(RawsockMsgType type, MessageBuffer&& payload)
     {
-        return Config::enframe(type, std::move(payload));
+        auto frame = framePool_.acquire();
+        Config::enframe(*frame, type, std::move(payload));
+        return frame;
     }
 
-    void sendFrame(RawsockFrame::Ptr frame)
+    void sendFrame(RawsockFrame::Ptr frame, TxPriority priority)
     {
         assert(socket_ && "Attempting to send on bad transport");
         assert((frame->payload().size() <= info_.maxTxLength) &&
                "Outgoing message is longer than allowed by peer");
-        txQueue_.push_back(std::move(frame));
+        txBytes_ += frame->wireSize();
+        ++txFrames_;
+        txQueue_.push(std::move(frame), priority);
+        updateTxBlocked();
         transmit();
     }
 
@@ -194,23 +432,23 @@ private:
     {
         if (isReadyToTransmit())
         {
-            txFrame_ = txQueue_.front();
-            txQueue_.pop_front();
+            gatherTxBatch();
+            ++txWriteCount_;
+            if (txBatch_.size() > txBatchHighWater_)
+                txBatchHighWater_ = txBatch_.size();
 
             auto self = this->shared_from_this();
-            boost::asio::async_write(*socket_, txFrame_->gatherBuffers(),
+            boost::asio::async_write(*socket_, txBuffers_,
                 [this, self](boost::system::error_code asioEc, size_t size)
                 {
-                    txFrame_.reset();
+                    releaseTxBatch();
                     if (asioEc)
                     {
-                        txQueue_.clear();
+                        auto ec = make_error_code(
+                            static_cast<std::errc>(asioEc.value()));
+                        discardTxQueue(ec);
                         if (txErrorHandler_)
-                        {
-                            auto ec = make_error_code(
-                                static_cast<std::errc>(asioEc.value()));
                             txErrorHandler_(ec);
-                        }
                         socket_.reset();
                     }
                     else
@@ -223,79 +461,267 @@ private:
 
     bool isReadyToTransmit() const
     {
-        return socket_ &&          // Socket is still open
-               !txFrame_ &&        // No async_write is in progress
-               !txQueue_.empty();  // One or more messages are enqueued
+        return socket_ &&           // Socket is still open
+               txBatch_.empty() &&  // No async_write is in progress
+               !txQueue_.empty();   // One or more messages are enqueued
     }
 
-    void receive()
+    void gatherTxBatch()
     {
-        if (socket_)
+        // Always sends at least one frame, even if it exceeds the byte limit.
+        // Higher-priority frames queued during the previous write are thus
+        // sent before any lower-priority ones still waiting.
+        const auto maxFrames = options_.txBatchMaxMessages();
+        const auto maxBytes = options_.txBatchMaxBytes();
+        std::size_t batchBytes = 0;
+        while (!txQueue_.empty() && txBatch_.size() < maxFrames)
         {
-            rxFrame_.clear();
-            auto self = this->shared_from_this();
-            boost::asio::async_read(*socket_, rxFrame_.headerBuffer(),
-                [this, self](boost::system::error_code ec, size_t)
-                {
-                    if (check(ec))
-                        processHeader();
-                });
+            auto& frame = txQueue_.front();
+            auto frameBytes = frame->wireSize();
+            if (!txBatch_.empty() && (batchBytes + frameBytes > maxBytes))
+                break;
+            batchBytes += frameBytes;
+            auto bufs = frame->gatherBuffers();
+            txBuffers_.insert(txBuffers_.end(), bufs.begin(), bufs.end());
+            txBatch_.push_back(std::move(frame));
+            txQueue_.pop();
+        }
+    }
+
+    void releaseTxBatch()
+    {
+        for (auto& frame: txBatch_)
+        {
+            txBytes_ -= frame->wireSize();
+            --txFrames_;
+
+            // Keep the payload storage for acquireBuffer, unless the frame
+            // is still needed elsewhere (e.g. an outstanding ping frame).
+            if (frame.use_count() == 1)
+                recycle(std::move(*frame).payload());
+            framePool_.release(std::move(frame));
+        }
+        txBatch_.clear();
+        txBuffers_.clear();
+        updateTxBlocked();
+    }
+
+    void updateTxBlocked()
+    {
+        if (!txBlocked_)
+        {
+            txBlocked_ = txWatermarks_.isAboveHigh(txBytes_, txFrames_);
+        }
+        else if (txWatermarks_.isAtOrBelowLow(txBytes_, txFrames_))
+        {
+            txBlocked_ = false;
+            notifyTxSpace(std::error_code{});
         }
     }
 
+    void notifyTxSpace(std::error_code ec)
+    {
+        TxSpaceHandlers handlers;
+        handlers.swap(txSpaceHandlers_);
+        for (auto& handler: handlers)
+            post(std::move(handler), ec);
+    }
+
+    void discardTxQueue(std::error_code ec)
+    {
+        // Frames of an in-progress batch are still counted until the
+        // write completes.
+        txBytes_ -= txQueue_.wireSize();
+        txFrames_ -= txQueue_.size();
+        txQueue_.clear();
+        txBlocked_ = false;
+        notifyTxSpace(ec);
+    }
+
+    void receive()
+    {
+        if (!socket_)
+            return;
+        if (rxBuffer_.empty())
+            receiveHeader();
+        else
+            receiveBuffered();
+    }
+
+    void receiveHeader()
+    {
+        rxFrame_.clear();
+        auto self = this->shared_from_this();
+        boost::asio::async_read(*socket_, rxFrame_.headerBuffer(),
+            [this, self](boost::system::error_code ec, size_t)
+            {
+                if (check(ec))
+                    processHeader();
+            });
+    }
+
     void processHeader()
     {
         auto hdr = rxFrame_.header();
-        auto len  = hdr.length();
-        bool ok = check(len <= info_.maxRxLength, TransportErrc::badRxLength)
-               && check(hdr.msgTypeIsValid(), RawsockErrc::badMessageType);
-        if (ok)
-            receivePayload(hdr.msgType(), len);
+        if (checkHeader(hdr))
+            receivePayload(hdr.msgType(), hdr.length());
     }
 
-    void receivePayload(RawsockMsgType msgType, size_t length)
+    bool checkHeader(RawsockHeader hdr)
     {
+        return check(hdr.length() <= info_.maxRxLength,
+                     TransportErrc::badRxLength) &&
+               check(hdr.msgTypeIsValid(), RawsockErrc::badMessageType);
+    }
+
+    MessageBuffer takeSpareBuffer()
+    {
+        auto buffer = std::move(spareBuffers_.back());
+        spareBuffers_.pop_back();
+        return buffer;
+    }
+
+    MessageBuffer takeRxPayload()
+    {
+        if (spareBuffers_.empty())
+        {
+            ++rxAllocationCount_;
+            return {};
+        }
+        return takeSpareBuffer();
+    }
+
+    void prepareRxFrame(size_t length)
+    {
+        // The previous payload was handed off, so borrow recycled storage.
+        if (rxFrame_.capacity() == 0)
+            rxFrame_.adopt(takeRxPayload());
         rxFrame_.resize(length);
+    }
+
+    void receivePayload(RawsockMsgType msgType, size_t length)
+    {
+        prepareRxFrame(length);
+        receiveRemainingPayload(msgType, 0);
+    }
+
+    void receiveRemainingPayload(RawsockMsgType msgType, size_t offset)
+    {
         auto self = this->shared_from_this();
-        boost::asio::async_read(*socket_, rxFrame_.payloadBuffer(),
+        boost::asio::async_read(*socket_, rxFrame_.payloadBuffer() + offset,
             [this, self, msgType](boost::system::error_code ec, size_t)
             {
                 if (ec)
                     rxFrame_.clear();
                 if (check(ec) && running_)
-                    switch (msgType)
-                    {
-                    case RawsockMsgType::wamp:
-                        if (rxHandler_)
-                            post(rxHandler_, std::move(rxFrame_).payload());
-                        receive();
-                        break;
-
-                    case RawsockMsgType::ping:
-                        sendPong();
-                        break;
-
-                    case RawsockMsgType::pong:
-                        receivePong();
-                        break;
-
-                    default:
-                        assert(false);
-                    }
+                {
+                    onFrame(msgType, std::move(rxFrame_).payload());
+                    receive();
+                }
+            });
+    }
+
+    void receiveBuffered()
+    {
+        // Move any partially received frame to the front of the buffer
+        // before reading more.
+        if (rxBegin_ != 0)
+        {
+            auto first = rxBuffer_.begin();
+            std::copy(first + rxBegin_, first + rxEnd_, first);
+            rxEnd_ -= rxBegin_;
+            rxBegin_ = 0;
+        }
+
+        auto self = this->shared_from_this();
+        socket_->async_read_some(
+            boost::asio::buffer(&rxBuffer_[rxEnd_], rxBuffer_.size() - rxEnd_),
+            [this, self](boost::system::error_code ec, size_t length)
+            {
+                if (check(ec) && running_)
+                {
+                    rxEnd_ += length;
+                    processRxBuffer();
+                }
             });
     }
 
-    void sendPong()
+    void processRxBuffer()
     {
-        auto frame = enframe(RawsockMsgType::pong,
-                              std::move(rxFrame_).payload());
-        sendFrame(std::move(frame));
+        // Dispatches every complete frame that is already buffered, so that
+        // a flood of small messages costs one read per buffer-full.
+        static constexpr size_t headerSize = sizeof(RawsockFrame::Header);
+        while (rxEnd_ - rxBegin_ >= headerSize)
+        {
+            RawsockFrame::Header bigEndianHeader;
+            std::memcpy(&bigEndianHeader, &rxBuffer_[rxBegin_], headerSize);
+            auto hdr = RawsockHeader::fromBigEndian(bigEndianHeader);
+            if (!checkHeader(hdr))
+                return;
+
+            auto length = hdr.length();
+            auto frameSize = headerSize + length;
+            if (rxEnd_ - rxBegin_ < frameSize)
+            {
+                if (frameSize > rxBuffer_.size())
+                    return receiveOversized(hdr.msgType(), length);
+                break;
+            }
+
+            auto payload = rxBuffer_.begin() + rxBegin_ + headerSize;
+            rxBegin_ += frameSize;
+            auto buffer = takeRxPayload();
+            buffer.assign(payload, payload + length);
+            onFrame(hdr.msgType(), std::move(buffer));
+        }
+
+        if (rxBegin_ == rxEnd_)
+            rxBegin_ = rxEnd_ = 0;
         receive();
     }
 
-    void receivePong()
+    void receiveOversized(RawsockMsgType msgType, size_t length)
+    {
+        // The frame cannot fit in the read-ahead buffer, so the remainder of
+        // its payload is read directly into a dedicated frame.
+        static constexpr size_t headerSize = sizeof(RawsockFrame::Header);
+        auto partial = rxEnd_ - rxBegin_ - headerSize;
+        rxFrame_.clear();
+        prepareRxFrame(length);
+        boost::asio::buffer_copy(
+            rxFrame_.payloadBuffer(),
+            boost::asio::buffer(&rxBuffer_[rxBegin_ + headerSize], partial));
+        rxBegin_ = rxEnd_ = 0;
+        receiveRemainingPayload(msgType, partial);
+    }
+
+    void onFrame(RawsockMsgType msgType, MessageBuffer&& payload)
     {
-        if (canProcessPong())
+        switch (msgType)
+        {
+        case RawsockMsgType::wamp:
+            if (rxHandler_)
+                post(rxHandler_, std::move(payload));
+            break;
+
+        case RawsockMsgType::ping:
+            sendFrame(enframe(RawsockMsgType::pong, std::move(payload)),
+                      TxPriority::control);
+            break;
+
+        case RawsockMsgType::pong:
+            receivePong(payload);
+            recycle(std::move(payload));
+            break;
+
+        default:
+            assert(false);
+        }
+    }
+
+    void receivePong(const MessageBuffer& payload)
+    {
+        if (canProcessPong(payload))
         {
             namespace chrn = std::chrono;
             pingStop_ = chrn::high_resolution_clock::now();
@@ -304,14 +730,13 @@ private:
             post(pingHandler_, elapsed);
             pingHandler_ = nullptr;
         }
-        pingFrame_.reset();
-        receive();
+        framePool_.release(std::move(pingFrame_));
     }
 
-    bool canProcessPong() const
+    bool canProcessPong(const MessageBuffer& payload) const
     {
         return pingHandler_ && pingFrame_ &&
-               (rxFrame_.payload() == pingFrame_->payload());
+               (payload == pingFrame_->payload());
     }
 
     template <typename F, typename... Ts>
@@ -354,8 +779,12 @@ private:
         txErrorHandler_ = nullptr;
         pingHandler_ = nullptr;
         rxFrame_.clear();
-        txQueue_.clear();
-        txFrame_ = nullptr;
+        rxBegin_ = rxEnd_ = 0;
+        discardTxQueue(make_error_code(TransportErrc::aborted));
+        txBatch_.clear();
+        txBuffers_.clear();
+        txBytes_ = 0;
+        txFrames_ = 0;
         pingFrame_ = nullptr;
         socket_.reset();
     }
@@ -363,16 +792,32 @@ private:
     IoStrand strand_;
     std::unique_ptr<TSocket> socket_;
     TransportInfo info_;
+    RawsockOptions options_;
     bool running_ = false;
     RxHandler rxHandler_;
     TxErrorHandler txErrorHandler_;
     PingHandler pingHandler_;
     RawsockFrame rxFrame_;
-    TransmitQueue txQueue_;
-    RawsockFrame::Ptr txFrame_;
+    std::vector<MessageBuffer> spareBuffers_;
+    MessageBuffer rxBuffer_;
+    std::size_t rxBegin_ = 0;
+    std::size_t rxEnd_ = 0;
+    RawsockTxQueue txQueue_;
+    TransmitBatch txBatch_;
+    GatherBuffers txBuffers_;
+    TxSpaceHandlers txSpaceHandlers_;
+    TxWatermarks txWatermarks_;
+    std::size_t txBytes_ = 0;
+    std::size_t txFrames_ = 0;
+    bool txBlocked_ = false;
     RawsockFrame::Ptr pingFrame_;
     TimePoint pingStart_;
     TimePoint pingStop_;
+    RawsockFramePool framePool_;
+    std::size_t rxAllocationCount_ = 0;
+    std::size_t txAllocationCount_ = 0;
+    std::size_t txWriteCount_ = 0;
+    std::size_t txBatchHighWater_ = 0;
 };
 
 } // namespace internal
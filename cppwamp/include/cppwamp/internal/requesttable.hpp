@@ -0,0 +1,284 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_REQUESTTABLE_HPP
+#define CPPWAMP_INTERNAL_REQUESTTABLE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Open-addressing table of pending requests, keyed by (message type,
+// request ID) pairs.
+//
+// Since request IDs are issued sequentially, the ID itself is used as the
+// slot index (modulo the power-of-two capacity), so that outstanding requests
+// occupy adjacent slots and rarely collide. Collisions are resolved by
+// Robin Hood linear probing, and erasures use backward-shift deletion so that
+// no tombstones accumulate. In the common case of every entry residing in its
+// home slot, lookups, insertions and erasures each touch a single slot.
+// Erasing or inserting invalidates all iterators.
+//------------------------------------------------------------------------------
+template <typename TKey, typename TValue>
+class RequestTable
+{
+private:
+    struct Slot
+    {
+        std::pair<TKey, TValue> kv;
+        bool occupied = false;
+    };
+
+    using Slots = std::vector<Slot>;
+
+    template <typename TSlots, typename TPair>
+    class Iter
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<TKey, TValue>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TPair*;
+        using reference = TPair&;
+
+        Iter() = default;
+
+        reference operator*() const {return (*slots_)[index_].kv;}
+
+        pointer operator->() const {return &(*slots_)[index_].kv;}
+
+        Iter& operator++() {++index_; skipVacant(); return *this;}
+
+        Iter operator++(int) {auto temp = *this; ++(*this); return temp;}
+
+        bool operator==(const Iter& rhs) const {return index_ == rhs.index_;}
+
+        bool operator!=(const Iter& rhs) const {return index_ != rhs.index_;}
+
+    private:
+        Iter(TSlots* slots, std::size_t index) : slots_(slots), index_(index)
+        {}
+
+        void skipVacant()
+        {
+            while (index_ < slots_->size() && !(*slots_)[index_].occupied)
+                ++index_;
+        }
+
+        TSlots* slots_ = nullptr;
+        std::size_t index_ = 0;
+
+        friend class RequestTable;
+    };
+
+public:
+    using key_type = TKey;
+    using mapped_type = TValue;
+    using value_type = std::pair<TKey, TValue>;
+    using size_type = std::size_t;
+    using iterator = Iter<Slots, value_type>;
+    using const_iterator = Iter<const Slots, const value_type>;
+
+    RequestTable() = default;
+
+    bool empty() const {return size_ == 0;}
+
+    size_type size() const {return size_;}
+
+    size_type capacity() const {return slots_.size();}
+
+    iterator begin() {return makeIterator<iterator>(slots_, 0);}
+
+    iterator end() {return iterator(&slots_, slots_.size());}
+
+    const_iterator begin() const
+    {
+        return makeIterator<const_iterator>(slots_, 0);
+    }
+
+    const_iterator end() const {return const_iterator(&slots_, slots_.size());}
+
+    iterator find(const TKey& key)
+    {
+        auto index = locate(key);
+        return (index == npos) ? end() : iterator(&slots_, index);
+    }
+
+    const_iterator find(const TKey& key) const
+    {
+        auto index = locate(key);
+        return (index == npos) ? end() : const_iterator(&slots_, index);
+    }
+
+    size_type count(const TKey& key) const {return locate(key) != npos;}
+
+    template <typename T>
+    std::pair<iterator, bool> emplace(const TKey& key, T&& value)
+    {
+        auto index = locate(key);
+        if (index != npos)
+            return {iterator(&slots_, index), false};
+
+        if ((size_ + 1) * 2 > slots_.size())
+            grow();
+
+        Slot carried;
+        carried.kv.first = key;
+        carried.kv.second = std::forward<T>(value);
+        carried.occupied = true;
+        return {iterator(&slots_, insert(std::move(carried))), true};
+    }
+
+    void erase(iterator pos)
+    {
+        assert(pos.index_ < slots_.size() && slots_[pos.index_].occupied);
+        vacate(pos.index_);
+    }
+
+    size_type erase(const TKey& key)
+    {
+        auto index = locate(key);
+        if (index == npos)
+            return 0;
+        vacate(index);
+        return 1;
+    }
+
+    void clear()
+    {
+        for (auto& slot: slots_)
+        {
+            if (slot.occupied)
+                slot = Slot{};
+        }
+        size_ = 0;
+    }
+
+private:
+    static constexpr std::size_t npos = std::size_t(-1);
+    static constexpr std::size_t minCapacity = 16;
+
+    template <typename TIter, typename TSlots>
+    static TIter makeIterator(TSlots& slots, std::size_t index)
+    {
+        TIter iter(&slots, index);
+        iter.skipVacant();
+        return iter;
+    }
+
+    std::size_t home(const TKey& key) const
+    {
+        // Folding in the message type keeps keys sharing the same request ID
+        // (e.g. HELLO with ID zero) from always landing in the same slot.
+        auto hash = static_cast<std::size_t>(key.second) +
+                    static_cast<std::size_t>(key.first);
+        return hash & (slots_.size() - 1);
+    }
+
+    std::size_t next(std::size_t index) const
+    {
+        return (index + 1) & (slots_.size() - 1);
+    }
+
+    // Number of slots an occupied entry lies beyond its home slot.
+    std::size_t displacement(std::size_t index) const
+    {
+        return (index - home(slots_[index].kv.first)) & (slots_.size() - 1);
+    }
+
+    std::size_t locate(const TKey& key) const
+    {
+        if (size_ == 0)
+            return npos;
+
+        // A key cannot lie beyond an entry that is closer to its own home.
+        auto index = home(key);
+        std::size_t distance = 0;
+        while (slots_[index].occupied && displacement(index) >= distance)
+        {
+            if (slots_[index].kv.first == key)
+                return index;
+            index = next(index);
+            ++distance;
+        }
+        return npos;
+    }
+
+    std::size_t insert(Slot&& carried)
+    {
+        // Entries further from home take the place of those closer to home,
+        // which keeps probe runs short and ordered by displacement.
+        auto index = home(carried.kv.first);
+        auto inserted = npos;
+        std::size_t distance = 0;
+        while (slots_[index].occupied)
+        {
+            auto resident = displacement(index);
+            if (resident < distance)
+            {
+                std::swap(carried, slots_[index]);
+                if (inserted == npos)
+                    inserted = index;
+                distance = resident;
+            }
+            index = next(index);
+            ++distance;
+        }
+
+        slots_[index] = std::move(carried);
+        ++size_;
+        return (inserted == npos) ? index : inserted;
+    }
+
+    void vacate(std::size_t index)
+    {
+        // Shift subsequent displaced entries backwards, so that lookups never
+        // stop short at the newly vacated slot.
+        auto gap = index;
+        auto probe = next(gap);
+        while (slots_[probe].occupied && displacement(probe) != 0)
+        {
+            slots_[gap] = std::move(slots_[probe]);
+            gap = probe;
+            probe = next(probe);
+        }
+        slots_[gap] = Slot{};
+        --size_;
+    }
+
+    void grow()
+    {
+        std::size_t newCapacity = minCapacity;
+        if (!slots_.empty())
+            newCapacity = slots_.size() * 2;
+        Slots old(newCapacity);
+        old.swap(slots_);
+        size_ = 0;
+        for (auto& slot: old)
+        {
+            if (slot.occupied)
+                insert(std::move(slot));
+        }
+    }
+
+    Slots slots_;
+    size_type size_ = 0;
+};
+
+} // namespace internal
+
+} // namespace wamp
+
+#endif // CPPWAMP_INTERNAL_REQUESTTABLE_HPP
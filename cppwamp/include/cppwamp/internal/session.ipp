@@ -208,6 +208,66 @@ CPPWAMP_INLINE void Session::setLogLevel(LogLevel level)
     impl_->setLogLevel(level);
 }
 
+//------------------------------------------------------------------------------
+/** @details
+    When enabled, only the header fields of received messages are decoded
+    upon reception. The positional and keyword arguments of received
+    results, events, invocations and errors are instead decoded the first
+    time they are accessed, so that handlers which only inspect the header
+    (e.g. to route or discard messages) don't pay for building the payload.
+    Messages are always fully decoded when the log level is LogLevel::trace.
+
+    Deferred decoding is disabled by default. It only takes effect with
+    codecs that support header-only decoding (Json, Msgpack, and Cbor);
+    other codecs continue to decode messages fully.
+
+    Enabling deferred decoding also allows the arguments of received
+    messages to be forwarded without re-encoding them, via
+    Payload::encodedPayload.
+    @note This method is thread-safe.
+    @see @ref CodecDecoder */
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void Session::setLazyPayloads(bool enabled)
+{
+    impl_->setLazyPayloads(enabled);
+}
+
+//------------------------------------------------------------------------------
+/** @details
+    While the transport's outbound queue is above a high watermark,
+    publications are rejected with TransportErrc::wouldBlock until the
+    queue drains to the low watermarks. Other messages, such as calls,
+    yields and protocol replies, are always queued. Session::awaitTxSpace
+    can be used to wait for the queue to drain.
+    The watermarks apply to the current transport, if any, as well as to
+    subsequent connections. By default, the outbound queue is unbounded.
+    @see TxWatermarks */
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void Session::setTxWatermarks(TxWatermarks watermarks)
+{
+    impl_->setTxWatermarks(watermarks);
+}
+
+//------------------------------------------------------------------------------
+/** @details
+    When enabled, Session::connect no longer waits for an attempt to fail
+    before trying the next wish in a ConnectionWishList. Instead, in the
+    manner of Happy Eyeballs (RFC 8305), a new attempt is started after each
+    `stagger` interval, or immediately once all attempts in progress have
+    failed. The first transport to be established is kept, and the other
+    attempts are cancelled. Racing is disabled by default, and has no
+    effect on connections using a single wish.
+    @note Takes effect upon the next call to Session::connect. */
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void Session::setConnectionRacing(
+    bool enabled,                               /**< Enables racing if true. */
+    std::chrono::steady_clock::duration stagger /**< Delay between the
+                                                     start of attempts. */
+    )
+{
+    impl_->setConnectionRacing(enabled, stagger);
+}
+
 //------------------------------------------------------------------------------
 CPPWAMP_INLINE void Session::setWarningHandler(
     LogStringHandler handler /**< Callable handler of type `<void (std::string)>`. */
@@ -421,7 +481,9 @@ CPPWAMP_INLINE void Session::unsubscribe(
         - SessionErrc::payloadSizeExceeded if the resulting PUBLISH message exceeds
           the transport's limits.
         - SessionErrc::invalidState if the session was not established
-          during the attempt to publish (can be safely discarded). */
+          during the attempt to publish (can be safely discarded).
+        - TransportErrc::wouldBlock if the transport's outbound queue is
+          above its high watermark (see Session::awaitTxSpace). */
 //------------------------------------------------------------------------------
 CPPWAMP_INLINE ErrorOrDone Session::publish(
     Pub pub /**< The publication to publish. */
@@ -595,6 +657,12 @@ CPPWAMP_INLINE void Session::doPublish(Pub&& p, CompletionHandler<PublicationId>
 CPPWAMP_INLINE void Session::safePublish(Pub&& p, CompletionHandler<PublicationId>&& f)
     {impl_->safePublish(std::move(p), std::move(f));}
 
+CPPWAMP_INLINE void Session::doAwaitTxSpace(CompletionHandler<bool>&& f)
+    {impl_->awaitTxSpace(std::move(f));}
+
+CPPWAMP_INLINE void Session::safeAwaitTxSpace(CompletionHandler<bool>&& f)
+    {impl_->safeAwaitTxSpace(std::move(f));}
+
 CPPWAMP_INLINE void Session::doEnroll(Procedure&& p, CallSlot&& c, InterruptSlot&& i,
                        CompletionHandler<Registration>&& f)
     {impl_->enroll(std::move(p), std::move(c), std::move(i), std::move(f));}
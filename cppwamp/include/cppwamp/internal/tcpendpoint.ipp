@@ -39,6 +39,12 @@ CPPWAMP_INLINE TcpEndpoint& TcpEndpoint::withMaxRxLength(RawsockMaxLength length
     return *this;
 }
 
+CPPWAMP_INLINE TcpEndpoint& TcpEndpoint::withRawsockOptions(RawsockOptions options)
+{
+    rawsockOptions_ = std::move(options);
+    return *this;
+}
+
 CPPWAMP_INLINE const std::string& TcpEndpoint::address() const
 {
     return address_;
@@ -56,4 +62,9 @@ CPPWAMP_INLINE RawsockMaxLength TcpEndpoint::maxRxLength() const
     return maxRxLength_;
 }
 
+CPPWAMP_INLINE const RawsockOptions& TcpEndpoint::rawsockOptions() const
+{
+    return rawsockOptions_;
+}
+
 } // namespace wamp
@@ -41,6 +41,18 @@ CPPWAMP_INLINE TcpHost& TcpHost::withMaxRxLength(RawsockMaxLength length)
     return *this;
 }
 
+CPPWAMP_INLINE TcpHost& TcpHost::withRawsockOptions(RawsockOptions options)
+{
+    rawsockOptions_ = std::move(options);
+    return *this;
+}
+
+CPPWAMP_INLINE TcpHost& TcpHost::withResolverCache(TcpResolverCache::Ptr cache)
+{
+    resolverCache_ = std::move(cache);
+    return *this;
+}
+
 CPPWAMP_INLINE const std::string& TcpHost::hostName() const
 {
     return hostName_;
@@ -58,4 +70,14 @@ CPPWAMP_INLINE RawsockMaxLength TcpHost::maxRxLength() const
     return maxRxLength_;
 }
 
+CPPWAMP_INLINE const RawsockOptions& TcpHost::rawsockOptions() const
+{
+    return rawsockOptions_;
+}
+
+CPPWAMP_INLINE const TcpResolverCache::Ptr& TcpHost::resolverCache() const
+{
+    return resolverCache_;
+}
+
 } // namespace wamp
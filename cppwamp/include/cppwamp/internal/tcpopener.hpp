@@ -8,14 +8,18 @@
 #define CPPWAMP_INTERNAL_TCPOPENER_HPP
 
 #include <cassert>
+#include <functional>
 #include <memory>
 #include <string>
+#include <system_error>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/strand.hpp>
 #include "../asiodefs.hpp"
 #include "../erroror.hpp"
 #include "../tcphost.hpp"
+#include "../tcpresolvercache.hpp"
 
 namespace wamp
 {
@@ -41,6 +45,9 @@ public:
     template <typename F>
     void establish(F&& callback)
     {
+        if (settings_.resolverCache())
+            return lookup(std::forward<F>(callback));
+
         struct Resolved
         {
             TcpOpener* self;
@@ -66,10 +73,52 @@ public:
         resolver_.cancel();
         if (socket_)
             socket_->close();
+
+        if (lookupCallback_ && *lookupCallback_)
+        {
+            // The cache lookup itself cannot be cancelled; its outcome will
+            // be ignored.
+            auto callback = std::move(*lookupCallback_);
+            *lookupCallback_ = nullptr;
+            boost::asio::post(
+                strand_,
+                [callback]()
+                {
+                    auto ec = make_error_code(std::errc::operation_canceled);
+                    callback(UnexpectedError(ec));
+                });
+        }
     }
 
 private:
     using tcp = boost::asio::ip::tcp;
+    using Callback = std::function<void (ErrorOr<SocketPtr>)>;
+    using CallbackPtr = std::shared_ptr<Callback>;
+
+    template <typename F>
+    void lookup(F&& callback)
+    {
+        using EndpointList = TcpResolverCache::EndpointList;
+
+        auto pending = std::make_shared<Callback>(std::forward<F>(callback));
+        lookupCallback_ = pending;
+
+        // A cancelled lookup no longer refers to this object, which may have
+        // since been destroyed.
+        settings_.resolverCache()->lookup(
+            settings_.hostName(), settings_.serviceName(), strand_,
+            [this, pending](ErrorOr<EndpointList> endpoints)
+            {
+                if (!*pending)
+                    return;
+                auto callback = std::move(*pending);
+                *pending = nullptr;
+                lookupCallback_.reset();
+                if (!endpoints)
+                    return callback(UnexpectedError(endpoints.error()));
+                connect(*endpoints, std::move(callback), true);
+            });
+    }
 
     template <typename F>
     bool checkError(boost::system::error_code asioEc, F& callback)
@@ -82,19 +131,42 @@ private:
         return !asioEc;
     }
 
-    template <typename F>
-    void connect(tcp::resolver::iterator iterator, F&& callback)
+    template <typename TEndpoints, typename F>
+    void connect(const TEndpoints& endpoints, F&& callback,
+                 bool fromCache = false)
     {
         struct Connected
         {
             TcpOpener* self;
             typename std::decay<F>::type callback;
+            bool fromCache;
 
             void operator()(boost::system::error_code asioEc,
                             tcp::resolver::iterator)
+            {
+                finish(asioEc);
+            }
+
+            void operator()(boost::system::error_code asioEc,
+                            const tcp::endpoint&)
+            {
+                finish(asioEc);
+            }
+
+            void finish(boost::system::error_code asioEc)
             {
                 SocketPtr socket{std::move(self->socket_)};
                 self->socket_.reset();
+
+                // Stale cached endpoints shall be re-resolved next time.
+                bool aborted = asioEc == boost::asio::error::operation_aborted;
+                if (asioEc && fromCache && !aborted)
+                {
+                    const auto& s = self->settings_;
+                    s.resolverCache()->invalidate(s.hostName(),
+                                                  s.serviceName());
+                }
+
                 if (self->checkError(asioEc, callback))
                     callback(std::move(socket));
             }
@@ -106,14 +178,16 @@ private:
         settings_.options().applyTo(*socket_);
 
         // RawsockConnector will keep this object alive until completion.
-        boost::asio::async_connect(*socket_, iterator,
-                                   Connected{this, std::forward<F>(callback)});
+        boost::asio::async_connect(
+            *socket_, endpoints,
+            Connected{this, std::forward<F>(callback), fromCache});
     }
 
     IoStrand strand_;
     Settings settings_;
     boost::asio::ip::tcp::resolver resolver_;
     SocketPtr socket_;
+    CallbackPtr lookupCallback_;
 };
 
 } // namespace internal
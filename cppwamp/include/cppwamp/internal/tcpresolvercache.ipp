@@ -0,0 +1,248 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include "../tcpresolvercache.hpp"
+#include <system_error>
+#include <boost/asio/post.hpp>
+#include "../api.hpp"
+
+namespace wamp
+{
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE bool TcpResolverCache::Entry::isFresh(TimePoint now) const
+{
+    return !endpoints.empty() && (isStatic || now < expiry);
+}
+
+CPPWAMP_INLINE bool TcpResolverCache::Entry::isDueForRefresh(
+    TimePoint now, Duration margin) const
+{
+    return !isStatic && !isResolving && (margin > Duration::zero()) &&
+           (expiry - now <= margin);
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE TcpResolverCache::Ptr TcpResolverCache::create(
+    AnyIoExecutor exec, Duration ttl)
+{
+    return Ptr(new TcpResolverCache(std::move(exec), ttl));
+}
+
+CPPWAMP_INLINE void TcpResolverCache::setTtl(Duration ttl)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ttl_ = ttl;
+}
+
+CPPWAMP_INLINE void TcpResolverCache::setRefreshMargin(Duration margin)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshMargin_ = margin;
+}
+
+CPPWAMP_INLINE void TcpResolverCache::addStatic(
+    std::string hostName, std::string serviceName, EndpointList endpoints)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[Key{std::move(hostName), std::move(serviceName)}];
+    entry.endpoints = std::move(endpoints);
+    entry.isStatic = true;
+}
+
+CPPWAMP_INLINE void TcpResolverCache::preresolve(std::string hostName,
+                                                 std::string serviceName)
+{
+    Key key{std::move(hostName), std::move(serviceName)};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = entries_[key];
+        if (entry.isResolving || entry.isFresh(Clock::now()))
+            return;
+        entry.isResolving = true;
+    }
+    resolve(key);
+}
+
+CPPWAMP_INLINE void TcpResolverCache::lookup(
+    std::string hostName, std::string serviceName, IoStrand strand,
+    Handler handler)
+{
+    Key key{std::move(hostName), std::move(serviceName)};
+    EndpointList endpoints;
+    bool mustResolve = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        auto& entry = entries_[key];
+        if (entry.isFresh(now))
+        {
+            ++stats_.hits;
+            endpoints = entry.endpoints;
+            mustResolve = entry.isDueForRefresh(now, refreshMargin_);
+        }
+        else
+        {
+            ++stats_.misses;
+            entry.waiters.push_back({strand, std::move(handler)});
+            mustResolve = !entry.isResolving;
+        }
+        if (mustResolve)
+            entry.isResolving = true;
+    }
+
+    if (mustResolve)
+        resolve(key);
+
+    if (!endpoints.empty())
+    {
+        boost::asio::post(
+            strand,
+            [handler, endpoints]() {handler(endpoints);});
+    }
+}
+
+CPPWAMP_INLINE TcpResolverCache::EndpointList TcpResolverCache::find(
+    const std::string& hostName, const std::string& serviceName) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(Key{hostName, serviceName});
+    if (iter == entries_.end() || !iter->second.isFresh(Clock::now()))
+        return {};
+    return iter->second.endpoints;
+}
+
+CPPWAMP_INLINE void TcpResolverCache::invalidate(
+    const std::string& hostName, const std::string& serviceName)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(Key{hostName, serviceName});
+    if (iter != entries_.end() && !iter->second.isStatic)
+        iter->second.endpoints.clear();
+}
+
+CPPWAMP_INLINE void TcpResolverCache::remove(const std::string& hostName,
+                                             const std::string& serviceName)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(Key{hostName, serviceName});
+    if (iter == entries_.end())
+        return;
+
+    // Keep the entry if waiters still expect the outcome of a query.
+    auto& entry = iter->second;
+    if (entry.isResolving)
+    {
+        entry.endpoints.clear();
+        entry.isStatic = false;
+    }
+    else
+    {
+        entries_.erase(iter);
+    }
+}
+
+CPPWAMP_INLINE void TcpResolverCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = entries_.begin(); iter != entries_.end(); )
+    {
+        if (iter->second.isResolving)
+        {
+            iter->second.endpoints.clear();
+            iter->second.isStatic = false;
+            ++iter;
+        }
+        else
+        {
+            iter = entries_.erase(iter);
+        }
+    }
+}
+
+CPPWAMP_INLINE std::size_t TcpResolverCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+CPPWAMP_INLINE TcpResolverStats TcpResolverCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+CPPWAMP_INLINE TcpResolverCache::TcpResolverCache(AnyIoExecutor exec,
+                                                  Duration ttl)
+    : executor_(std::move(exec)),
+      ttl_(ttl)
+{}
+
+CPPWAMP_INLINE void TcpResolverCache::resolve(const Key& key)
+{
+    auto resolver = std::make_shared<Resolver>(executor_);
+    auto self = shared_from_this();
+    resolver->async_resolve(
+        key.first, key.second,
+        [self, resolver, key](boost::system::error_code asioEc,
+                              Resolver::results_type results)
+        {
+            self->onResolved(key, asioEc, results);
+        });
+}
+
+CPPWAMP_INLINE void TcpResolverCache::onResolved(
+    const Key& key, boost::system::error_code asioEc,
+    const Resolver::results_type& results)
+{
+    std::vector<Waiter> waiters;
+    ErrorOr<EndpointList> result;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = entries_[key];
+        entry.isResolving = false;
+        waiters = std::move(entry.waiters);
+        entry.waiters.clear();
+
+        if (asioEc)
+        {
+            ++stats_.failures;
+            auto ec = make_error_code(static_cast<std::errc>(asioEc.value()));
+            result = UnexpectedError(ec);
+            if (entry.endpoints.empty())
+                entries_.erase(key);
+        }
+        else if (entry.isStatic)
+        {
+            // A static entry was added while the query was in progress.
+            result = entry.endpoints;
+        }
+        else
+        {
+            ++stats_.resolutions;
+            entry.endpoints.assign(results.begin(), results.end());
+            entry.expiry = Clock::now() + ttl_;
+            result = entry.endpoints;
+        }
+    }
+
+    notify(waiters, result);
+}
+
+CPPWAMP_INLINE void TcpResolverCache::notify(
+    std::vector<Waiter>& waiters, const ErrorOr<EndpointList>& result)
+{
+    for (auto& waiter: waiters)
+    {
+        auto handler = std::move(waiter.handler);
+        boost::asio::post(waiter.strand,
+                          [handler, result]() {handler(result);});
+    }
+}
+
+} // namespace wamp
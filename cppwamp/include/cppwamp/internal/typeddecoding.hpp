@@ -0,0 +1,664 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_TYPEDDECODING_HPP
+#define CPPWAMP_INTERNAL_TYPEDDECODING_HPP
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../api.hpp"
+#include "../blob.hpp"
+#include "../error.hpp"
+#include "../payload.hpp"
+#include "../traits.hpp"
+#include "../variant.hpp"
+#include "genericconversion.hpp"
+#include "integersequence.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+class LazyPayload;
+class TypedContainerSink;
+template <typename> class StructSink;
+
+//------------------------------------------------------------------------------
+// Receives the decoding events of a single value, and stores that value
+// directly into a statically-typed destination.
+//------------------------------------------------------------------------------
+class TypedValueSink
+{
+public:
+    virtual ~TypedValueSink() = default;
+
+    // Stores a null, boolean, numeric, string, or blob value.
+    virtual void putScalar(Variant&& scalar) = 0;
+
+    // Starts an array value, returning the sink for its elements.
+    virtual TypedContainerSink& beginArray(std::size_t sizeHint) = 0;
+
+    // Starts an object value, returning the sink for its members.
+    virtual TypedContainerSink& beginObject() = 0;
+
+    // Called once the array or object started via this sink has ended.
+    virtual void endComposite() {}
+};
+
+//------------------------------------------------------------------------------
+// Provides the sinks for the elements of an array or the members of an object.
+// Elements or members that are not wanted are skipped.
+//------------------------------------------------------------------------------
+class TypedContainerSink
+{
+public:
+    virtual ~TypedContainerSink() = default;
+
+    virtual TypedValueSink& element();
+
+    virtual TypedValueSink& member(String&& key);
+};
+
+//------------------------------------------------------------------------------
+// Discards the values it receives.
+//------------------------------------------------------------------------------
+class SkipSink : public TypedValueSink, public TypedContainerSink
+{
+public:
+    static SkipSink& instance()
+    {
+        static SkipSink sink;
+        return sink;
+    }
+
+    void putScalar(Variant&&) override {}
+
+    TypedContainerSink& beginArray(std::size_t) override {return *this;}
+
+    TypedContainerSink& beginObject() override {return *this;}
+
+    TypedValueSink& element() override {return *this;}
+
+    TypedValueSink& member(String&&) override {return *this;}
+};
+
+inline TypedValueSink& TypedContainerSink::element()
+{
+    return SkipSink::instance();
+}
+
+inline TypedValueSink& TypedContainerSink::member(String&&)
+{
+    return SkipSink::instance();
+}
+
+//------------------------------------------------------------------------------
+// Builds a Variant, without the intermediate scratch arrays used by
+// VariantDecodingVisitor.
+//------------------------------------------------------------------------------
+class VariantSink : public TypedValueSink
+{
+public:
+    VariantSink() = default;
+
+    ~VariantSink() override;
+
+    void bind(Variant& dest) {dest_ = &dest;}
+
+    void putScalar(Variant&& scalar) override {*dest_ = std::move(scalar);}
+
+    TypedContainerSink& beginArray(std::size_t sizeHint) override;
+
+    TypedContainerSink& beginObject() override;
+
+private:
+    class Children;
+
+    Children& children();
+
+    Variant* dest_ = nullptr;
+    std::unique_ptr<Children> children_; // Allocated once per nesting level
+};
+
+class VariantSink::Children : public TypedContainerSink
+{
+public:
+    void bind(Array& array) {array_ = &array;}
+
+    void bind(Object& object) {object_ = &object;}
+
+    TypedValueSink& element() override
+    {
+        array_->emplace_back();
+        child_.bind(array_->back());
+        return child_;
+    }
+
+    TypedValueSink& member(String&& key) override
+    {
+        child_.bind((*object_)[std::move(key)]);
+        return child_;
+    }
+
+private:
+    Array* array_ = nullptr;
+    Object* object_ = nullptr;
+    VariantSink child_;
+};
+
+inline VariantSink::~VariantSink() {}
+
+inline TypedContainerSink& VariantSink::beginArray(std::size_t sizeHint)
+{
+    *dest_ = Array{};
+    auto& array = dest_->as<Array>();
+    array.reserve(sizeHint);
+    auto& c = children();
+    c.bind(array);
+    return c;
+}
+
+inline TypedContainerSink& VariantSink::beginObject()
+{
+    *dest_ = Object{};
+    auto& c = children();
+    c.bind(dest_->as<Object>());
+    return c;
+}
+
+inline VariantSink::Children& VariantSink::children()
+{
+    if (!children_)
+        children_.reset(new Children);
+    return *children_;
+}
+
+//------------------------------------------------------------------------------
+// Base class for sinks storing into a value of type T. Scalars are converted
+// via Variant::to. Composites that are not handled directly by the derived
+// sink are first collected into a Variant, which is then converted via
+// Variant::to, so that the conversion rules and errors remain the same as
+// those of Payload::convertTo.
+//------------------------------------------------------------------------------
+template <typename T>
+class TypedSinkBase : public TypedValueSink
+{
+public:
+    void bind(T& dest) {dest_ = &dest;}
+
+    void putScalar(Variant&& scalar) override
+    {
+        using IsMovable = BoolConstant<isSameType<T, String>() ||
+                                       isSameType<T, Blob>()>;
+        put(std::move(scalar), IsMovable{});
+    }
+
+    TypedContainerSink& beginArray(std::size_t sizeHint) override
+    {
+        return bufferArray(sizeHint);
+    }
+
+    TypedContainerSink& beginObject() override {return bufferObject();}
+
+    void endComposite() override {convertBuffered();}
+
+protected:
+    T& dest() {return *dest_;}
+
+    TypedContainerSink& bufferArray(std::size_t sizeHint)
+    {
+        buffering_ = true;
+        builder_.bind(buffer_);
+        return builder_.beginArray(sizeHint);
+    }
+
+    TypedContainerSink& bufferObject()
+    {
+        buffering_ = true;
+        builder_.bind(buffer_);
+        return builder_.beginObject();
+    }
+
+    // Returns false if the composite that just ended was not buffered.
+    bool convertBuffered()
+    {
+        if (!buffering_)
+            return false;
+        buffering_ = false;
+        Variant buffer(std::move(buffer_));
+        buffer_ = null;
+        buffer.to(*dest_);
+        return true;
+    }
+
+private:
+    void put(Variant&& scalar, TrueType)
+    {
+        // Avoids copying decoded strings and blobs
+        if (scalar.is<T>())
+            *dest_ = std::move(scalar.as<T>());
+        else
+            scalar.to(*dest_);
+    }
+
+    void put(Variant&& scalar, FalseType) {scalar.to(*dest_);}
+
+    T* dest_ = nullptr;
+    Variant buffer_;
+    VariantSink builder_;
+    bool buffering_ = false;
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+class ConvertingSink : public TypedSinkBase<T>
+{};
+
+//------------------------------------------------------------------------------
+template <typename T> class VectorSink;
+template <typename T> class MapSink;
+
+template <typename T>
+constexpr bool isStructSinkable()
+{
+    return std::is_class<T>::value && Variant::isInvalidArg<T>() &&
+           hasGenericConversion<T>();
+}
+
+template <typename T, typename Enable = void>
+struct TypedSinkSelector {using Type = ConvertingSink<T>;};
+
+template <>
+struct TypedSinkSelector<Variant> {using Type = VariantSink;};
+
+template <typename T>
+struct TypedSinkSelector<std::vector<T>, EnableIf<!isSameType<T, bool>(),
+                                                  void>>
+{
+    using Type = VectorSink<T>;
+};
+
+template <typename T>
+struct TypedSinkSelector<std::map<String, T>>
+{
+    using Type = MapSink<T>;
+};
+
+template <typename T>
+struct TypedSinkSelector<T, EnableIf<isStructSinkable<T>(), void>>
+{
+    using Type = StructSink<T>;
+};
+
+template <typename T>
+using TypedSinkFor = typename TypedSinkSelector<T>::Type;
+
+//------------------------------------------------------------------------------
+template <typename T>
+class VectorSink : public TypedSinkBase<std::vector<T>>,
+                   public TypedContainerSink
+{
+public:
+    TypedContainerSink& beginArray(std::size_t sizeHint) override
+    {
+        auto& vec = this->dest();
+        vec.clear();
+        vec.reserve(sizeHint);
+        return *this;
+    }
+
+    TypedValueSink& element() override
+    {
+        auto& vec = this->dest();
+        vec.emplace_back();
+        elem_.bind(vec.back());
+        return elem_;
+    }
+
+private:
+    TypedSinkFor<T> elem_;
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+class MapSink : public TypedSinkBase<std::map<String, T>>,
+                public TypedContainerSink
+{
+public:
+    TypedContainerSink& beginObject() override
+    {
+        this->dest().clear();
+        return *this;
+    }
+
+    TypedValueSink& member(String&& key) override
+    {
+        elem_.bind(this->dest()[std::move(key)]);
+        return elem_;
+    }
+
+private:
+    TypedSinkFor<T> elem_;
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+const void* typedSinkTag()
+{
+    static const char tag = 0;
+    return &tag;
+}
+
+//------------------------------------------------------------------------------
+// Associates the members registered by a custom type's `convert` function
+// with the sinks storing into them. Entries and their sinks are reused from
+// one object to the next.
+//------------------------------------------------------------------------------
+class TypedMemberTable
+{
+public:
+    void clear() {count_ = 0;}
+
+    template <typename T>
+    void add(ConverterKey key, T& dest, bool optional)
+    {
+        using Sink = TypedSinkFor<T>;
+        if (count_ == entries_.size())
+            entries_.emplace_back();
+        auto& entry = entries_[count_++];
+        if (entry.tag != typedSinkTag<T>())
+        {
+            entry.sink.reset(new Sink);
+            entry.tag = typedSinkTag<T>();
+        }
+        static_cast<Sink&>(*entry.sink).bind(dest);
+        entry.key.assign(key.data, key.size);
+        entry.optional = optional;
+        entry.seen = false;
+    }
+
+    TypedValueSink& find(const String& key)
+    {
+        for (std::size_t i=0; i<count_; ++i)
+        {
+            auto& entry = entries_[i];
+            if (entry.key == key)
+            {
+                entry.seen = true;
+                return *entry.sink;
+            }
+        }
+        return SkipSink::instance();
+    }
+
+    void checkMissing() const
+    {
+        for (std::size_t i=0; i<count_; ++i)
+        {
+            const auto& entry = entries_[i];
+            if (!entry.seen && !entry.optional)
+            {
+                std::ostringstream oss;
+                oss << "wamp::error::Conversion: Key \"" << entry.key
+                    << "\" not found in object";
+                throw error::Conversion(oss.str());
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        String key;
+        std::unique_ptr<TypedValueSink> sink;
+        const void* tag = nullptr;
+        bool optional = false;
+        bool seen = false;
+    };
+
+    std::vector<Entry> entries_;
+    std::size_t count_ = 0;
+};
+
+} // namespace internal
+
+//------------------------------------------------------------------------------
+/** Converter used by typed decoding to find out which members a custom
+    type expects.
+    This converter is passed to the generic `convert` functions of custom
+    types, and provides the same syntax as FromVariantConverter. Instead of
+    retrieving values from a Variant, it associates each member with the
+    destination it will be decoded into.
+
+    Only custom types converted as key-value pairs are decoded this way;
+    the others are decoded via Variant and FromVariantConverter.
+    @see wamp::unpackedEvent
+    @see wamp::unpackedRpc */
+//------------------------------------------------------------------------------
+class CPPWAMP_API DecodingConverter
+{
+public:
+    /// Integer type used to represent the size of arrays.
+    using SizeType = std::size_t;
+
+    /// String type used to represent an object key.
+    using String = std::string;
+
+    /** Indicates that this converter is used to convert **from** a
+        serialized representation of a variant. */
+    static constexpr bool convertingToVariant = false;
+
+    /** The size is unknown beforehand, so zero is always returned. */
+    SizeType size() const {return 0;}
+
+    /** The size is unknown beforehand, so zero is always obtained. */
+    DecodingConverter& size(SizeType& n)
+    {
+        n = 0;
+        shape_.noteSize();
+        return *this;
+    }
+
+    /** Expects a non-composite value. */
+    template <typename T>
+    DecodingConverter& operator()(T&)
+    {
+        shape_.noteScalar();
+        return *this;
+    }
+
+    /** Expects an array element. */
+    template <typename T>
+    DecodingConverter& operator[](T&)
+    {
+        shape_.noteElement();
+        return *this;
+    }
+
+    /** Expects an object member. */
+    template <typename T>
+    DecodingConverter& operator()(internal::ConverterKey key, T& value)
+    {
+        shape_.noteMember();
+        members_.add(key, value, false);
+        return *this;
+    }
+
+    /** Expects an optional object member, assigning the fallback value
+        until the member is decoded. */
+    template <typename T, typename U>
+    DecodingConverter& operator()(internal::ConverterKey key, T& value,
+                                  U&& fallback)
+    {
+        value = std::forward<U>(fallback);
+        shape_.noteMember();
+        members_.add(key, value, true);
+        return *this;
+    }
+
+private:
+    using Shape = internal::ConversionShape;
+    using Members = internal::TypedMemberTable;
+
+    DecodingConverter(Shape& shape, Members& members)
+        : shape_(shape),
+          members_(members)
+    {}
+
+    Shape& shape_;
+    Members& members_;
+
+    template <typename> friend class internal::StructSink;
+};
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Decodes the members of custom types converted as key-value pairs directly
+// into the destination object. Members are matched by key in any order, and
+// unexpected members are skipped.
+//------------------------------------------------------------------------------
+template <typename T>
+class StructSink : public TypedSinkBase<T>, public TypedContainerSink
+{
+public:
+    TypedContainerSink& beginObject() override
+    {
+        ConversionShape shape;
+        members_.clear();
+        DecodingConverter conv(shape, members_);
+        convert(conv, this->dest());
+        if (shape.kind() != ConversionShape::Kind::object)
+            return this->bufferObject();
+        return *this;
+    }
+
+    TypedValueSink& member(String&& key) override {return members_.find(key);}
+
+    void endComposite() override
+    {
+        if (!this->convertBuffered())
+            members_.checkMissing();
+    }
+
+private:
+    TypedMemberTable members_;
+};
+
+//------------------------------------------------------------------------------
+// Routes the elements of the positional arguments array to the sinks of the
+// corresponding tuple elements. Extra arguments are skipped.
+//------------------------------------------------------------------------------
+template <typename... Ts>
+class TypedArgsSink : public TypedContainerSink
+{
+public:
+    explicit TypedArgsSink(std::tuple<Ts...>& args)
+    {
+        using Seq = typename GenIntegerSequence<sizeof...(Ts)>::type;
+        bind(args, Seq{});
+    }
+
+    // Number of elements in the positional arguments array.
+    std::size_t count() const {return count_;}
+
+    TypedValueSink& element() override
+    {
+        auto index = count_++;
+        if (index < sizeof...(Ts))
+            return *sinkPtrs_[index];
+        return SkipSink::instance();
+    }
+
+private:
+    template <int... Seq>
+    void bind(std::tuple<Ts...>& args, IntegerSequence<Seq...>)
+    {
+        using swallow = int[];
+        (void)swallow{0, (std::get<Seq>(sinks_).bind(std::get<Seq>(args)),
+                          sinkPtrs_[Seq] = &std::get<Seq>(sinks_), 0)...};
+    }
+
+    std::tuple<TypedSinkFor<Ts>...> sinks_;
+    std::array<TypedValueSink*, sizeof...(Ts)> sinkPtrs_;
+    std::size_t count_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Feeds the positional arguments of the given still-encoded payload to the
+// given sink, returning false if the payload could not be parsed.
+//------------------------------------------------------------------------------
+CPPWAMP_API bool decodeTypedPayload(const LazyPayload& payload,
+                                    TypedContainerSink& args);
+
+//------------------------------------------------------------------------------
+// Returns the error, if any, that occurred while decoding the given
+// still-encoded payload into Variant fields.
+//------------------------------------------------------------------------------
+CPPWAMP_API std::error_code payloadDecodingError(const LazyPayload& payload);
+
+//------------------------------------------------------------------------------
+// Returns the error, if any, that occurred while decoding the arguments of
+// the given encoded payload.
+//------------------------------------------------------------------------------
+inline std::error_code decodingErrorOf(const EncodedPayload& payload)
+{
+    const auto& impl = TypedPayloadAccess::impl(payload);
+    return impl ? payloadDecodingError(*impl) : std::error_code{};
+}
+
+//------------------------------------------------------------------------------
+// Decodes the positional arguments of the given encoded payload directly
+// into the given tuple, without going through an Array of Variants. Returns
+// false if the payload is empty or could not be parsed, in which case the
+// arguments must be obtained via Payload::convertToTuple instead.
+//------------------------------------------------------------------------------
+template <typename... Ts>
+bool decodeTypedArgs(const EncodedPayload& payload, std::tuple<Ts...>& args,
+                     std::size_t& count)
+{
+    const auto& impl = TypedPayloadAccess::impl(payload);
+    if (!impl)
+        return false;
+
+    TypedArgsSink<Ts...> sink(args);
+    try
+    {
+        if (!decodeTypedPayload(*impl, sink))
+            return false;
+    }
+    catch (const error::Conversion& e)
+    {
+        std::ostringstream oss;
+        oss << "Payload element at index " << (sink.count() - 1)
+            << " is not convertible to the target type: " << e.what();
+        throw error::Conversion(oss.str());
+    }
+
+    count = sink.count();
+    return true;
+}
+
+} // namespace internal
+
+} // namespace wamp
+
+#ifndef CPPWAMP_COMPILED_LIB
+#include "typeddecoding.ipp"
+#endif
+
+#endif // CPPWAMP_INTERNAL_TYPEDDECODING_HPP
@@ -0,0 +1,352 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include "typeddecoding.hpp"
+#include <cstdint>
+#include <limits>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <jsoncons/byte_string.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_visitor.hpp>
+#include <jsoncons/json_visitor2.hpp>
+#include <jsoncons/ser_context.hpp>
+#include <jsoncons/source.hpp>
+#include <jsoncons/tag_type.hpp>
+#include <jsoncons_ext/cbor/cbor_parser.hpp>
+#include <jsoncons_ext/msgpack/msgpack_parser.hpp>
+#include "../api.hpp"
+#include "../codec.hpp"
+#include "base64.hpp"
+#include "lazypayload.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Skips the elements of a WAMP message array that precede its positional
+// arguments, and routes the latter to the given sink. Keyword arguments are
+// skipped as well.
+//------------------------------------------------------------------------------
+class TypedMessageSink : public TypedValueSink, public TypedContainerSink
+{
+public:
+    TypedMessageSink(std::size_t payloadPos, TypedContainerSink& args)
+        : args_(args),
+          payloadPos_(payloadPos)
+    {}
+
+    // Returns false if the message or its positional arguments were not
+    // arrays.
+    bool ok() const {return ok_;}
+
+    void putScalar(Variant&&) override {ok_ = false;}
+
+    TypedContainerSink& beginArray(std::size_t) override
+    {
+        if (inArgs_)
+            return args_;
+        return *this;
+    }
+
+    TypedContainerSink& beginObject() override
+    {
+        ok_ = false;
+        return SkipSink::instance();
+    }
+
+    TypedValueSink& element() override
+    {
+        if (index_++ != payloadPos_)
+            return SkipSink::instance();
+        inArgs_ = true;
+        return *this;
+    }
+
+private:
+    TypedContainerSink& args_;
+    std::size_t payloadPos_ = 0;
+    std::size_t index_ = 0;
+    bool inArgs_ = false;
+    bool ok_ = true;
+};
+
+//------------------------------------------------------------------------------
+// Drives a tree of typed sinks from the events of a jsoncons parser.
+//------------------------------------------------------------------------------
+template <typename TVisitor>
+class TypedDecodingVisitorBase : public TVisitor
+{
+public:
+    using string_view_type = typename TVisitor::string_view_type;
+
+    explicit TypedDecodingVisitorBase(TypedValueSink& root) : root_(root) {}
+
+protected:
+    using Tag = jsoncons::semantic_tag;
+    using Where = jsoncons::ser_context;
+
+    bool expectsKey() const
+    {
+        return !stack_.empty() && stack_.back().isObject &&
+               stack_.back().pending == nullptr;
+    }
+
+    void putKey(String&& key)
+    {
+        auto& frame = stack_.back();
+        frame.pending = &(frame.container->member(std::move(key)));
+    }
+
+    std::error_code put(Variant&& scalar)
+    {
+        if (expectsKey())
+            return make_error_code(DecodingErrc::expectedStringKey);
+        next().putScalar(std::move(scalar));
+        return {};
+    }
+
+private:
+    using ByteStringView = jsoncons::byte_string_view;
+
+    struct Frame
+    {
+        TypedContainerSink* container;
+        TypedValueSink* owner;
+        TypedValueSink* pending;
+        bool isObject;
+    };
+
+    // Obtains the sink for the next value
+    TypedValueSink& next()
+    {
+        if (stack_.empty())
+            return root_;
+        auto& frame = stack_.back();
+        if (!frame.isObject)
+            return frame.container->element();
+        auto* sink = frame.pending;
+        frame.pending = nullptr;
+        return *sink;
+    }
+
+    std::error_code begin(bool isObject, std::size_t sizeHint)
+    {
+        if (expectsKey())
+            return make_error_code(DecodingErrc::expectedStringKey);
+        auto& sink = next();
+        auto& container = isObject ? sink.beginObject()
+                                   : sink.beginArray(sizeHint);
+        stack_.push_back({&container, &sink, nullptr, isObject});
+        return {};
+    }
+
+    void end()
+    {
+        auto* owner = stack_.back().owner;
+        stack_.pop_back();
+        owner->endComposite();
+    }
+
+    void visit_flush() override {}
+
+    bool visit_begin_object(Tag, const Where&, std::error_code& ec) override
+    {
+        ec = begin(true, 0);
+        return !ec;
+    }
+
+    bool visit_end_object(const Where&, std::error_code&) override
+    {
+        end();
+        return true;
+    }
+
+    bool visit_begin_array(Tag, const Where&, std::error_code& ec) override
+    {
+        ec = begin(false, 0);
+        return !ec;
+    }
+
+    bool visit_begin_array(std::size_t length, Tag, const Where&,
+                           std::error_code& ec) override
+    {
+        ec = begin(false, length);
+        return !ec;
+    }
+
+    bool visit_end_array(const Where&, std::error_code&) override
+    {
+        end();
+        return true;
+    }
+
+    bool visit_null(Tag, const Where&, std::error_code& ec) override
+    {
+        ec = put(null);
+        return !ec;
+    }
+
+    bool visit_bool(bool value, Tag, const Where&,
+                    std::error_code& ec) override
+    {
+        ec = put(value);
+        return !ec;
+    }
+
+    bool visit_byte_string(const ByteStringView& bsv, Tag, const Where&,
+                           std::error_code& ec) override
+    {
+        ec = put(Blob(Blob::Data(bsv.begin(), bsv.end())));
+        return !ec;
+    }
+
+    bool visit_uint64(uint64_t n, Tag, const Where&,
+                      std::error_code& ec) override
+    {
+        // Same representation as with VariantDecodingVisitor, so that
+        // conversions to the target types behave the same.
+        if (n <= std::numeric_limits<Variant::Int>::max())
+            ec = put(static_cast<Variant::Int>(n));
+        else
+            ec = put(n);
+        return !ec;
+    }
+
+    bool visit_int64(int64_t n, Tag, const Where&,
+                     std::error_code& ec) override
+    {
+        ec = put(static_cast<Variant::Int>(n));
+        return !ec;
+    }
+
+    bool visit_double(double x, Tag, const Where&,
+                      std::error_code& ec) override
+    {
+        ec = put(x);
+        return !ec;
+    }
+
+    std::vector<Frame> stack_;
+    TypedValueSink& root_;
+};
+
+//------------------------------------------------------------------------------
+class TypedJsonDecodingVisitor :
+    public TypedDecodingVisitorBase<jsoncons::json_visitor>
+{
+public:
+    using Base = TypedDecodingVisitorBase<jsoncons::json_visitor>;
+
+    using Base::Base;
+
+private:
+    bool visit_key(const string_view_type& name, const Where&,
+                   std::error_code&) override
+    {
+        putKey(String(name.data(), name.size()));
+        return true;
+    }
+
+    bool visit_string(const string_view_type& sv, Tag, const Where&,
+                      std::error_code& ec) override
+    {
+        if ( (sv.size() > 0) && (sv[0] == '\0') )
+        {
+            Blob::Data bytes;
+            ec = Base64::decode(sv.data() + 1, sv.size() - 1, bytes);
+            if (!ec)
+                ec = put(Blob(std::move(bytes)));
+        }
+        else
+        {
+            ec = put(String(sv.data(), sv.size()));
+        }
+        return !ec;
+    }
+};
+
+//------------------------------------------------------------------------------
+class TypedBinaryDecodingVisitor :
+    public TypedDecodingVisitorBase<jsoncons::json_visitor2>
+{
+public:
+    using Base = TypedDecodingVisitorBase<jsoncons::json_visitor2>;
+
+    using Base::Base;
+
+private:
+    bool visit_string(const string_view_type& sv, Tag, const Where&,
+                      std::error_code& ec) override
+    {
+        String str(sv.data(), sv.size());
+        if (expectsKey())
+            putKey(std::move(str));
+        else
+            ec = put(std::move(str));
+        return !ec;
+    }
+};
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE std::error_code payloadDecodingError(const LazyPayload& payload)
+{
+    return payload.error();
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE bool decodeTypedPayload(const LazyPayload& payload,
+                                       TypedContainerSink& args)
+{
+    TypedMessageSink message(payload.payloadPosition(), args);
+    const auto& bytes = payload.bytes();
+    std::error_code ec;
+
+    switch (payload.codecId())
+    {
+    case KnownCodecIds::json():
+    {
+        TypedJsonDecodingVisitor visitor(message);
+        jsoncons::basic_json_parser<char> parser{
+            jsoncons::strict_json_parsing{}};
+        parser.update(reinterpret_cast<const char*>(bytes.data()),
+                      bytes.size());
+        parser.finish_parse(visitor, ec);
+        break;
+    }
+
+    case KnownCodecIds::msgpack():
+    {
+        TypedBinaryDecodingVisitor visitor(message);
+        jsoncons::msgpack::basic_msgpack_parser<jsoncons::bytes_source>
+            parser(bytes);
+        parser.parse(visitor, ec);
+        break;
+    }
+
+    case KnownCodecIds::cbor():
+    {
+        TypedBinaryDecodingVisitor visitor(message);
+        jsoncons::cbor::basic_cbor_parser<jsoncons::bytes_source>
+            parser(bytes);
+        parser.parse(visitor, ec);
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    return !ec && message.ok();
+}
+
+} // namespace internal
+
+} // namespace wamp
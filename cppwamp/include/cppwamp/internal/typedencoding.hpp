@@ -0,0 +1,277 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_INTERNAL_TYPEDENCODING_HPP
+#define CPPWAMP_INTERNAL_TYPEDENCODING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../api.hpp"
+#include "../blob.hpp"
+#include "../cbor.hpp"
+#include "../json.hpp"
+#include "../messagebuffer.hpp"
+#include "../msgpack.hpp"
+#include "../null.hpp"
+#include "../traits.hpp"
+#include "../variant.hpp"
+#include "genericconversion.hpp"
+#include "integersequence.hpp"
+
+namespace wamp
+{
+
+template <typename TEncoder> class EncodingConverter;
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Type-erased wrapper around a format-specific jsoncons encoder, so that the
+// latter remains hidden within the compiled library.
+//------------------------------------------------------------------------------
+class TypedEncoderSink
+{
+public:
+    virtual ~TypedEncoderSink() = default;
+    virtual void nullValue() = 0;
+    virtual void boolValue(bool b) = 0;
+    virtual void int64Value(std::int64_t n) = 0;
+    virtual void uint64Value(std::uint64_t n) = 0;
+    virtual void doubleValue(double x) = 0;
+    virtual void stringValue(const char* data, std::size_t size) = 0;
+    virtual void blobValue(const Blob& b) = 0;
+    virtual void key(const char* data, std::size_t size) = 0;
+    virtual void beginArray(std::size_t size) = 0;
+    virtual void endArray() = 0;
+    virtual void beginObject(std::size_t size) = 0;
+    virtual void endObject() = 0;
+};
+
+// Function that feeds the value pointed to by its second argument to the sink.
+using TypedEncodingFunction = void (*)(TypedEncoderSink&, const void*);
+
+// Encodes a value to the given output via a sink for the given format.
+CPPWAMP_API void encodeTypedVia(Json, std::string& output,
+                                TypedEncodingFunction func, const void* value);
+
+CPPWAMP_API void encodeTypedVia(Json, MessageBuffer& output,
+                                TypedEncodingFunction func, const void* value);
+
+CPPWAMP_API void encodeTypedVia(Msgpack, std::string& output,
+                                TypedEncodingFunction func, const void* value);
+
+CPPWAMP_API void encodeTypedVia(Msgpack, MessageBuffer& output,
+                                TypedEncodingFunction func, const void* value);
+
+CPPWAMP_API void encodeTypedVia(Cbor, std::string& output,
+                                TypedEncodingFunction func, const void* value);
+
+CPPWAMP_API void encodeTypedVia(Cbor, MessageBuffer& output,
+                                TypedEncodingFunction func, const void* value);
+
+//------------------------------------------------------------------------------
+// Feeds statically-typed values directly to an encoder sink, producing the
+// same data model as converting them to Variant and then encoding the result.
+// Custom types are streamed through EncodingConverter if their `convert`
+// function is generic; otherwise they are first converted to Variant.
+//------------------------------------------------------------------------------
+class TypedEncoder
+{
+public:
+    explicit TypedEncoder(TypedEncoderSink& encoder) : encoder_(encoder) {}
+
+    template <typename T>
+    static void encodeErased(TypedEncoderSink& sink, const void* value)
+    {
+        TypedEncoder(sink).encode(*static_cast<const T*>(value));
+    }
+
+    void encode(Null) {encoder_.nullValue();}
+
+    template <typename T, EnableIf<isBool<T>()> = 0>
+    void encode(T b) {encoder_.boolValue(b);}
+
+    template <typename T, EnableIf<isSignedInteger<T>()> = 0>
+    void encode(T n) {encoder_.int64Value(n);}
+
+    template <typename T, EnableIf<isUnsignedInteger<T>()> = 0>
+    void encode(T n) {encoder_.uint64Value(n);}
+
+    template <typename T, EnableIf<std::is_floating_point<T>::value> = 0>
+    void encode(T x) {encoder_.doubleValue(x);}
+
+    void encode(const String& s) {encoder_.stringValue(s.data(), s.size());}
+
+    void encode(const char* s) {encoder_.stringValue(s, std::strlen(s));}
+
+    void encode(const Blob& b) {encoder_.blobValue(b);}
+
+    void encode(const Variant& v) {wamp::apply(Forwarder(*this), v);}
+
+    template <typename T>
+    void encode(const std::vector<T>& array)
+    {
+        encoder_.beginArray(array.size());
+        for (const auto& elem: array)
+            encode(static_cast<const T&>(elem)); // Unwraps vector<bool> refs
+        encoder_.endArray();
+    }
+
+    template <typename T>
+    void encode(const std::map<String, T>& object) {encodeObject(object);}
+
+#ifdef CPPWAMP_FLAT_OBJECT
+    template <typename T>
+    void encode(const FlatMap<String, T>& object) {encodeObject(object);}
+#endif
+
+    template <typename... Ts>
+    void encode(const std::tuple<Ts...>& tuple)
+    {
+        using Seq = typename GenIntegerSequence<sizeof...(Ts)>::type;
+        encoder_.beginArray(sizeof...(Ts));
+        encodeElements(tuple, Seq{});
+        encoder_.endArray();
+    }
+
+    // Enumerators may have custom conversions that are not distinguishable
+    // from the default one, so they always go through Variant.
+    template <typename T, EnableIf<std::is_enum<T>::value> = 0>
+    void encode(const T& e) {encode(Variant::from(e));}
+
+    template <typename T, EnableIf<std::is_class<T>::value> = 0>
+    void encode(const T& obj)
+    {
+        encodeCustom(obj, BoolConstant<hasGenericConversion<T>()>{});
+    }
+
+    void encodeKey(ConverterKey key) {encoder_.key(key.data, key.size);}
+
+private:
+    struct Forwarder : Visitor<>
+    {
+        explicit Forwarder(TypedEncoder& self) : self(self) {}
+
+        template <typename T>
+        void operator()(const T& value) const {self.encode(value);}
+
+        TypedEncoder& self;
+    };
+
+    template <typename TObject>
+    void encodeObject(const TObject& object)
+    {
+        encoder_.beginObject(object.size());
+        for (const auto& kv: object)
+        {
+            encodeKey(kv.first);
+            encode(kv.second);
+        }
+        encoder_.endObject();
+    }
+
+    template <typename TTuple, int... Seq>
+    void encodeElements(const TTuple& tuple, IntegerSequence<Seq...>)
+    {
+        using swallow = int[]; // Guarantees left-to-right evaluation
+        (void)swallow{0, (encode(std::get<Seq>(tuple)), 0)...};
+    }
+
+    template <typename T>
+    void encodeCustom(const T& obj, TrueType)
+    {
+        using Converter = EncodingConverter<TypedEncoder>;
+
+        // Like Variant::from, passes the object as non-const to the user's
+        // convert function.
+        auto& mutableObj = const_cast<T&>(obj);
+        ConversionShape shape;
+        {
+            Converter counter(shape);
+            convert(counter, mutableObj);
+        }
+
+        using Kind = ConversionShape::Kind;
+        switch (shape.kind())
+        {
+        case Kind::none:
+            encoder_.nullValue();
+            return;
+
+        case Kind::mixed:
+            return encodeCustom(obj, FalseType{});
+
+        case Kind::array:
+            encoder_.beginArray(shape.count());
+            break;
+
+        case Kind::object:
+            encoder_.beginObject(shape.count());
+            break;
+
+        default:
+            break;
+        }
+
+        Converter conv(*this, shape);
+        convert(conv, mutableObj);
+
+        if (shape.kind() == Kind::array)
+            encoder_.endArray();
+        else if (shape.kind() == Kind::object)
+            encoder_.endObject();
+    }
+
+    template <typename T>
+    void encodeCustom(const T& obj, FalseType)
+    {
+        encode(Variant::from(obj));
+    }
+
+    TypedEncoderSink& encoder_;
+};
+
+//------------------------------------------------------------------------------
+template <typename TFormat>
+struct TypedEncodingTraits {};
+
+template <typename TFormat>
+struct SupportedTypedEncoding
+{
+    template <typename T, typename TOutput>
+    static void encode(const T& value, TOutput& output)
+    {
+        encodeTypedVia(TFormat{}, output, &TypedEncoder::encodeErased<T>,
+                       &value);
+    }
+};
+
+template <>
+struct TypedEncodingTraits<Json> : SupportedTypedEncoding<Json> {};
+
+template <>
+struct TypedEncodingTraits<Msgpack> : SupportedTypedEncoding<Msgpack> {};
+
+template <>
+struct TypedEncodingTraits<Cbor> : SupportedTypedEncoding<Cbor> {};
+
+} // namespace internal
+
+} // namespace wamp
+
+#ifndef CPPWAMP_COMPILED_LIB
+#include "typedencoding.ipp"
+#endif
+
+#endif // CPPWAMP_INTERNAL_TYPEDENCODING_HPP
@@ -0,0 +1,179 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include "typedencoding.hpp"
+#include <utility>
+#include <jsoncons/byte_string.hpp>
+#include <jsoncons/json_encoder.hpp>
+#include <jsoncons/sink.hpp>
+#include <jsoncons_ext/cbor/cbor_encoder.hpp>
+#include <jsoncons_ext/msgpack/msgpack_encoder.hpp>
+#include "../api.hpp"
+#include "base64.hpp"
+#include "jsonencoding.hpp"
+
+namespace wamp
+{
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+template <typename TEncoder>
+class BasicTypedEncoderSink : public TypedEncoderSink
+{
+public:
+    template <typename TArg>
+    explicit BasicTypedEncoderSink(TArg&& arg)
+        : encoder_(std::forward<TArg>(arg))
+    {}
+
+    void nullValue() override {encoder_.null_value();}
+
+    void boolValue(bool b) override {encoder_.bool_value(b);}
+
+    void int64Value(std::int64_t n) override {encoder_.int64_value(n);}
+
+    void uint64Value(std::uint64_t n) override {encoder_.uint64_value(n);}
+
+    void doubleValue(double x) override {encoder_.double_value(x);}
+
+    void stringValue(const char* data, std::size_t size) override
+    {
+        encoder_.string_value({data, size});
+    }
+
+    void blobValue(const Blob& b) override
+    {
+        jsoncons::byte_string_view bsv(b.data().data(), b.data().size());
+        encoder_.byte_string_value(bsv);
+    }
+
+    void key(const char* data, std::size_t size) override
+    {
+        encoder_.key({data, size});
+    }
+
+    void beginArray(std::size_t size) override {encoder_.begin_array(size);}
+
+    void endArray() override {encoder_.end_array();}
+
+    void beginObject(std::size_t size) override {encoder_.begin_object(size);}
+
+    void endObject() override {encoder_.end_object();}
+
+    void flush() {encoder_.flush();}
+
+protected:
+    TEncoder encoder_;
+};
+
+//------------------------------------------------------------------------------
+// WAMP transmits binary data in JSON as a Base64-encoded string prefixed with
+// a NUL character, which the JSON encoder escapes as \u0000.
+//------------------------------------------------------------------------------
+template <typename TEncoder>
+class JsonTypedEncoderSink : public BasicTypedEncoderSink<TEncoder>
+{
+public:
+    using Base = BasicTypedEncoderSink<TEncoder>;
+
+    using Base::Base;
+
+    void blobValue(const Blob& b) override
+    {
+        std::string text(1, '\0');
+        text.reserve(1 + (b.data().size() + 2) / 3 * 4);
+        Base64::encode(b.data().data(), b.data().size(), text);
+        this->stringValue(text.data(), text.size());
+    }
+};
+
+//------------------------------------------------------------------------------
+template <typename TOutput>
+void encodeJsonTyped(TOutput& output, TypedEncodingFunction func,
+                     const void* value)
+{
+    // JsonSinkProxy adapts the character-based JSON encoder to the
+    // output's byte type.
+    using Sink = jsoncons::string_sink<TOutput>;
+    using Proxy = JsonSinkProxy<Sink>;
+    using Encoder = jsoncons::basic_compact_json_encoder<char, Proxy>;
+    Sink sink(output);
+    JsonTypedEncoderSink<Encoder> encoder{Proxy(sink)};
+    func(encoder, value);
+    encoder.flush();
+}
+
+//------------------------------------------------------------------------------
+template <template <typename> class TEncoder, typename TOutput>
+void encodeBinaryTyped(TOutput& output, TypedEncodingFunction func,
+                       const void* value)
+{
+    using Sink = jsoncons::string_sink<TOutput>;
+    BasicTypedEncoderSink<TEncoder<Sink>> encoder(output);
+    func(encoder, value);
+    encoder.flush();
+}
+
+//------------------------------------------------------------------------------
+template <typename TSink>
+using MsgpackTypedEncoder = jsoncons::msgpack::basic_msgpack_encoder<TSink>;
+
+template <typename TSink>
+using CborTypedEncoder = jsoncons::cbor::basic_cbor_encoder<TSink>;
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void encodeTypedVia(Json, std::string& output,
+                                   TypedEncodingFunction func,
+                                   const void* value)
+{
+    encodeJsonTyped(output, func, value);
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void encodeTypedVia(Json, MessageBuffer& output,
+                                   TypedEncodingFunction func,
+                                   const void* value)
+{
+    encodeJsonTyped(output, func, value);
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void encodeTypedVia(Msgpack, std::string& output,
+                                   TypedEncodingFunction func,
+                                   const void* value)
+{
+    encodeBinaryTyped<MsgpackTypedEncoder>(output, func, value);
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void encodeTypedVia(Msgpack, MessageBuffer& output,
+                                   TypedEncodingFunction func,
+                                   const void* value)
+{
+    encodeBinaryTyped<MsgpackTypedEncoder>(output, func, value);
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void encodeTypedVia(Cbor, std::string& output,
+                                   TypedEncodingFunction func,
+                                   const void* value)
+{
+    encodeBinaryTyped<CborTypedEncoder>(output, func, value);
+}
+
+//------------------------------------------------------------------------------
+CPPWAMP_INLINE void encodeTypedVia(Cbor, MessageBuffer& output,
+                                   TypedEncodingFunction func,
+                                   const void* value)
+{
+    encodeBinaryTyped<CborTypedEncoder>(output, func, value);
+}
+
+} // namespace internal
+
+} // namespace wamp
@@ -32,6 +32,12 @@ CPPWAMP_INLINE UdsPath& UdsPath::withMaxRxLength(RawsockMaxLength length)
     return *this;
 }
 
+CPPWAMP_INLINE UdsPath& UdsPath::withRawsockOptions(RawsockOptions options)
+{
+    rawsockOptions_ = std::move(options);
+    return *this;
+}
+
 CPPWAMP_INLINE const std::string& UdsPath::pathName() const {return pathName_;}
 
 CPPWAMP_INLINE const UdsOptions& UdsPath::options() const {return options_;}
@@ -41,6 +47,11 @@ CPPWAMP_INLINE RawsockMaxLength UdsPath::maxRxLength() const
     return maxRxLength_;
 }
 
+CPPWAMP_INLINE const RawsockOptions& UdsPath::rawsockOptions() const
+{
+    return rawsockOptions_;
+}
+
 CPPWAMP_INLINE bool UdsPath::deletePathEnabled() const
 {
     return deletePathEnabled_;
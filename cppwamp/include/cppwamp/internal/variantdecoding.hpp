@@ -8,7 +8,9 @@
 #define CPPWAMP_INTERNAL_VARIANTDECODING_HPP
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <istream>
 #include <limits>
 #include <utility>
 #include <vector>
@@ -49,8 +51,25 @@ public:
         key_.clear();
         variant_ = Variant();
         hasRoot_ = false;
+        for (std::size_t i=0; i<scratchDepth_; ++i)
+            releaseScratch(scratch_[i]);
+        if (scratch_.size() > maxRetainedScratchDepth)
+            scratch_.resize(maxRetainedScratchDepth);
+        scratchDepth_ = 0;
+        skipDepth_ = 0;
+        headerOnly_ = false;
+        inPayload_ = false;
+        payloadSkipped_ = false;
     }
 
+    // When enabled, the elements of the root array starting from its first
+    // nested array (i.e. the args and kwargs of a WAMP message) are replaced
+    // by empty placeholders of the same type, and their contents are skipped.
+    void setHeaderOnly(bool headerOnly) {headerOnly_ = headerOnly;}
+
+    // Returns true if non-empty payload elements were skipped.
+    bool payloadSkipped() const {return payloadSkipped_;}
+
     const Variant& variant() const & {return variant_;}
 
     Variant&& variant() && {return std::move(variant_);}
@@ -64,6 +83,9 @@ protected:
     template <typename T>
     std::error_code put(T&& value, const Where& where, bool isComposite = false)
     {
+        if (skipsElement())
+            return {};
+
         if (contextStack_.empty())
             return addRoot(std::forward<T>(value), isComposite);
 
@@ -89,6 +111,8 @@ protected:
 
     void putStringOrKey(String&& str, const Where& where)
     {
+        if (skipsElement())
+            return;
         if (!contextStack_.empty() && context().expectsKey())
             putKey(std::move(str));
         else
@@ -98,13 +122,100 @@ protected:
     void endComposite()
     {
         assert(!contextStack_.empty());
+        auto& ctx = context();
+        if (ctx.hasScratch())
+        {
+            // Move the buffered elements into an array of exactly the
+            // right capacity.
+            auto& elements = scratch_[ctx.scratchIndex()];
+            auto& array = ctx.variant().template as<TypeId::array>();
+            array.reserve(elements.size());
+            for (auto& elem: elements)
+                array.push_back(std::move(elem));
+            releaseScratch(elements);
+            --scratchDepth_;
+        }
         contextStack_.pop_back();
     }
 
+    // Returns true if the current event lies within a payload element whose
+    // contents are being skipped.
+    bool skipsElement()
+    {
+        if (skipDepth_ == 0)
+            return false;
+        payloadSkipped_ = true;
+        return true;
+    }
+
+    // Handles the beginning of a composite that is either within a skipped
+    // payload element, or is itself a payload element to be skipped.
+    template <typename T>
+    bool skipsComposite(T&& placeholder, bool isArray, const Where& where)
+    {
+        if (skipDepth_ > 0)
+        {
+            ++skipDepth_;
+            payloadSkipped_ = true;
+            return true;
+        }
+
+        if (!headerOnly_ || contextStack_.size() != 1 ||
+            !context().variant().template is<Array>())
+        {
+            return false;
+        }
+
+        if (isArray)
+            inPayload_ = true;
+        if (!inPayload_)
+            return false;
+
+        put(std::forward<T>(placeholder), where);
+        skipDepth_ = 1;
+        return true;
+    }
+
+    // Handles the end of a composite that was skipped, returning false if
+    // it was not skipped.
+    bool skipsCompositeEnd()
+    {
+        if (skipDepth_ == 0)
+            return false;
+        --skipDepth_;
+        return true;
+    }
+
+    // For arrays of unknown length, elements are first accumulated in
+    // scratch arrays that are reused from one decoding to the next. This
+    // avoids repeated reallocations while the final array grows.
+    void bufferArrayElements()
+    {
+        if (scratchDepth_ == scratch_.size())
+            scratch_.emplace_back();
+        context().setScratchIndex(scratchDepth_++);
+    }
+
+    // Empties the given scratch array, releasing its storage if it grew
+    // beyond what is worth keeping. Decoders may be long-lived and shared
+    // (e.g. pooled per thread), so a single very long array must not pin
+    // its memory indefinitely.
+    static void releaseScratch(Array& elements)
+    {
+        if (elements.capacity() > maxRetainedScratchCapacity)
+            Array().swap(elements);
+        else
+            elements.clear();
+    }
+
 private:
     using Base = TVisitor;
     using ByteStringView = jsoncons::byte_string_view;
 
+    // Limits on the scratch storage retained between decodings.
+    static constexpr std::size_t maxRetainedScratchCapacity = 256;
+    static constexpr std::size_t maxRetainedScratchDepth = 8;
+
     class Context
     {
     public:
@@ -116,6 +227,12 @@ private:
 
         Variant& variant() {return *variant_;}
 
+        bool hasScratch() const {return scratchIndex_ != noScratch;}
+
+        std::size_t scratchIndex() const {return scratchIndex_;}
+
+        void setScratchIndex(std::size_t index) {scratchIndex_ = index;}
+
         bool expectsKey() const
         {
             return variant_->is<Object>() && !keyIsDone_;
@@ -126,7 +243,10 @@ private:
         void setKeyIsDone(bool done = true) {keyIsDone_ = done;}
 
     private:
+        static constexpr std::size_t noScratch = std::size_t(-1);
+
         Variant* variant_ = nullptr;
+        std::size_t scratchIndex_ = noScratch;
         bool keyIsDone_ = false;
     };
 
@@ -160,7 +280,10 @@ private:
     template <typename T>
     std::error_code addArrayElement(T&& value, bool isComposite)
     {
-        auto& array = context().variant().template as<TypeId::array>();
+        auto& ctx = context();
+        auto& array = ctx.hasScratch()
+            ? scratch_[ctx.scratchIndex()]
+            : ctx.variant().template as<TypeId::array>();
         array.push_back(std::forward<T>(value));
         if (isComposite)
             contextStack_.push_back(array.back());
@@ -175,14 +298,16 @@ private:
         if (!ctx.keyIsDone())
             return make_error_code(DecodingErrc::expectedStringKey);
 
+        // A single search locates either the existing element or the
+        // insertion point, which is usually the end for sorted keys.
         Variant* newElement = nullptr;
         auto& object = ctx.variant().template as<TypeId::object>();
-        auto found = object.find(key_);
-        if (found == object.end())
+        auto found = object.lower_bound(key_);
+        if (found == object.end() || found->first != key_)
         {
-            auto result = object.emplace(std::move(key_),
-                                         std::forward<T>(value));
-            newElement = &(result.first->second);
+            auto inserted = object.emplace_hint(found, std::move(key_),
+                                                std::forward<T>(value));
+            newElement = &(inserted->second);
         }
         else
         {
@@ -210,25 +335,34 @@ private:
 
     bool visit_begin_object(Tag, const Where& where, std::error_code&) override
     {
-        put(Object{}, where, true);
+        if (!skipsComposite(Object{}, false, where))
+            put(Object{}, where, true);
         return true;
     }
 
     bool visit_end_object(const Where&, std::error_code&) override
     {
-        endComposite();
+        if (!skipsCompositeEnd())
+            endComposite();
         return true;
     }
 
-    bool visit_begin_array(Tag, const Where& where, std::error_code&) override
+    bool visit_begin_array(Tag, const Where& where,
+                           std::error_code& ec) override
     {
-        put(Array{}, where, true);
-        return true;
+        if (skipsComposite(Array{}, true, where))
+            return true;
+        ec = put(Array{}, where, true);
+        if (!ec)
+            bufferArrayElements();
+        return !ec;
     }
 
     bool visit_begin_array(std::size_t length, Tag, const Where& where,
                            std::error_code&) override
     {
+        if (skipsComposite(Array{}, true, where))
+            return true;
         Array a;
         if (length > 0)
             a.reserve(length);
@@ -238,7 +372,8 @@ private:
 
     bool visit_end_array(const Where&, std::error_code&) override
     {
-        endComposite();
+        if (!skipsCompositeEnd())
+            endComposite();
         return true;
     }
 
@@ -287,9 +422,15 @@ private:
     }
 
     std::vector<Context> contextStack_;
+    std::vector<Array> scratch_;
+    std::size_t scratchDepth_ = 0;
+    std::size_t skipDepth_ = 0;
     String key_;
     Variant variant_;
     bool hasRoot_ = false;
+    bool headerOnly_ = false;
+    bool inPayload_ = false;
+    bool payloadSkipped_ = false;
 };
 
 //------------------------------------------------------------------------------
@@ -300,13 +441,16 @@ private:
     bool visit_key(const string_view_type& name, const Where&,
                    std::error_code&) override
     {
-        putKey(String(name.data(), name.size()));
+        if (!skipsElement())
+            putKey(String(name.data(), name.size()));
         return true;
     }
 
     bool visit_string(const string_view_type& sv, Tag, const Where& where,
                       std::error_code& ec) override
     {
+        if (skipsElement())
+            return true;
         if ( (sv.size() > 0) && (sv[0] == '\0') )
         {
             Blob::Data bytes;
@@ -333,6 +477,12 @@ private:
     }
 };
 
+//------------------------------------------------------------------------------
+// Size of the chunks in which input streams are read and fed to the parsers,
+// which never need to buffer an entire serialized stream.
+//------------------------------------------------------------------------------
+constexpr std::size_t streamChunkSize = 4096;
+
 //------------------------------------------------------------------------------
 template <typename TSource>
 struct GenericDecoderSourceTraits {};
@@ -342,6 +492,8 @@ struct GenericDecoderSourceTraits<StringSource>
 {
     using Source = jsoncons::bytes_source;
     using StubArg = std::string;
+
+    static Source makeSource(const std::string& s) {return Source(s);}
 };
 
 template <>
@@ -349,6 +501,8 @@ struct GenericDecoderSourceTraits<BufferSource>
 {
     using Source = jsoncons::bytes_source;
     using StubArg = MessageBuffer;
+
+    static Source makeSource(const MessageBuffer& b) {return Source(b);}
 };
 
 template <>
@@ -356,6 +510,11 @@ struct GenericDecoderSourceTraits<StreamSource>
 {
     using Source = jsoncons::stream_source<uint8_t>;
     using StubArg = std::nullptr_t;
+
+    static Source makeSource(std::istream& in)
+    {
+        return Source(in, streamChunkSize);
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -376,15 +535,17 @@ public:
     template <typename TSourceable>
     std::error_code decode(TSourceable&& input, Variant& variant)
     {
-        ParserSource source(std::forward<TSourceable>(input));
-        parser_.reset(std::move(source));
-        visitor_.reset();
-        std::error_code ec;
-        parser_.parse(visitor_, ec);
-        if (!ec)
-            variant = std::move(visitor_).variant();
-        reset();
-        return ec;
+        bool payloadSkipped = false;
+        return decodeAs(false, std::forward<TSourceable>(input), variant,
+                        payloadSkipped);
+    }
+
+    template <typename TSourceable>
+    std::error_code decodeHeader(TSourceable&& input, Variant& variant,
+                                 bool& payloadSkipped)
+    {
+        return decodeAs(true, std::forward<TSourceable>(input), variant,
+                        payloadSkipped);
     }
 
 private:
@@ -394,6 +555,23 @@ private:
     using Parser = typename TConfig::template Parser<ParserSource>;
     using Visitor = internal::VariantDecodingVisitor;
 
+    template <typename TSourceable>
+    std::error_code decodeAs(bool headerOnly, TSourceable&& input,
+                             Variant& variant, bool& payloadSkipped)
+    {
+        parser_.reset(SourceTraits::makeSource(
+            std::forward<TSourceable>(input)));
+        visitor_.reset();
+        visitor_.setHeaderOnly(headerOnly);
+        std::error_code ec;
+        parser_.parse(visitor_, ec);
+        payloadSkipped = !ec && visitor_.payloadSkipped();
+        if (!ec)
+            variant = std::move(visitor_).variant();
+        reset();
+        return ec;
+    }
+
     void reset()
     {
         parser_.reset();
@@ -8,6 +8,7 @@
 #define CPPWAMP_INTERNAL_VARIANTTRAITS_HPP
 
 #include <map>
+#include <new>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -266,77 +267,90 @@ template <> struct Access<String>
         {return *static_cast<const String*>(field);}
 };
 
-template <> struct Access<Blob>
+//------------------------------------------------------------------------------
+// Composite field types are stored directly within the Variant's field union
+// when they fit, so that empty and small composites need no extra heap
+// allocation, and moving a composite variant never allocates. Otherwise,
+// they are allocated on the heap and the union holds a pointer to them.
+// The decision is deferred to the function bodies so that the container
+// types are only examined once Variant is complete.
+//------------------------------------------------------------------------------
+template <typename TField> struct CompositeAccess
 {
-    template <typename U> static void construct(U&& value, void* field)
-        {ptr(field) = new Blob(std::forward<U>(value));}
-
-    static void destruct(void* field)
+    static constexpr bool isInline()
     {
-        Blob*& b = ptr(field);
-        delete b;
-        b = nullptr;
+        return sizeof(TField) <= sizeof(String) &&
+               alignof(TField) <= alignof(String);
     }
 
-    static Blob& get(void* field) {return *ptr(field);}
-
-    static const Blob& get(const void* field)
+    template <typename U> static void construct(U&& value, void* field)
     {
-        const Blob* b = Access<const Blob*>::get(field);
-        return *b;
+        using Tag = std::integral_constant<bool, isInline()>;
+        construct(std::forward<U>(value), field, Tag{});
     }
 
-    static Blob*& ptr(void* field) {return Access<Blob*>::get(field);}
-};
-
-template <> struct Access<Array>
-{
-    template <typename U> static void construct(U&& value, void* field)
-        {ptr(field) = new Array(std::forward<U>(value));}
-
     static void destruct(void* field)
     {
-        Array*& a = ptr(field);
-        delete a;
-        a = nullptr;
+        using Tag = std::integral_constant<bool, isInline()>;
+        destruct(field, Tag{});
     }
 
-    static Array& get(void* field) {return *ptr(field);}
-
-    static const Array& get(const void* field)
+    static TField& get(void* field)
     {
-        const Array* a = Access<const Array*>::get(field);
-        return *a;
+        using Tag = std::integral_constant<bool, isInline()>;
+        return get(field, Tag{});
     }
 
-    static Array*& ptr(void* field) {return Access<Array*>::get(field);}
-};
-
-template <> struct Access<Object>
-{
-    template <typename U> static void construct(U&& value, void* field)
+    static const TField& get(const void* field)
     {
-        ptr(field) = new Object(std::forward<U>(value));
+        using Tag = std::integral_constant<bool, isInline()>;
+        return get(field, Tag{});
     }
 
-    static void destruct(void* field)
+private:
+    using Inline = std::true_type;
+    using Boxed = std::false_type;
+
+    template <typename U>
+    static void construct(U&& value, void* field, Inline)
+        {new (field) TField(std::forward<U>(value));}
+
+    template <typename U>
+    static void construct(U&& value, void* field, Boxed)
+        {ptr(field) = new TField(std::forward<U>(value));}
+
+    static void destruct(void* field, Inline) {get(field, Inline{}).~TField();}
+
+    static void destruct(void* field, Boxed)
     {
-        Object*& o = ptr(field);
-        delete o;
-        o = nullptr;
+        TField*& p = ptr(field);
+        delete p;
+        p = nullptr;
     }
 
-    static Object& get(void* field) {return *ptr(field);}
+    static TField& get(void* field, Inline)
+        {return *static_cast<TField*>(field);}
+
+    static const TField& get(const void* field, Inline)
+        {return *static_cast<const TField*>(field);}
+
+    static TField& get(void* field, Boxed) {return *ptr(field);}
 
-    static const Object& get(const void* field)
+    static const TField& get(const void* field, Boxed)
     {
-        const Object* o = Access<const Object*>::get(field);
-        return *o;
+        const TField* p = Access<const TField*>::get(field);
+        return *p;
     }
 
-    static Object*& ptr(void* field) {return Access<Object*>::get(field);}
+    static TField*& ptr(void* field) {return Access<TField*>::get(field);}
 };
 
+template <> struct Access<Blob> : CompositeAccess<Blob> {};
+
+template <> struct Access<Array> : CompositeAccess<Array> {};
+
+template <> struct Access<Object> : CompositeAccess<Object> {};
+
 } // namespace internal
 
 } // namespace wamp
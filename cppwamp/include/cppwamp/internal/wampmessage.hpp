@@ -9,11 +9,14 @@
 
 #include <cassert>
 #include <limits>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include "../erroror.hpp"
 #include "../variant.hpp"
 #include "../wampdefs.hpp"
+#include "lazypayload.hpp"
+#include "messageholder.hpp"
 #include "messagetraits.hpp"
 
 namespace wamp
@@ -175,9 +178,70 @@ struct WampMessage
         return found->second.valueOr<bool>(false);
     }
 
+    // Position of the positional arguments field, or zero if the message
+    // type has no payload.
+    size_t payloadPosition() const
+    {
+        const auto& t = traits();
+        for (size_t i=1; i<std::extent<decltype(t.fieldTypes)>::value; ++i)
+        {
+            if (t.fieldTypes[i] == TypeId::array)
+                return i;
+        }
+        return 0;
+    }
+
+    // Attaches the raw message from which the payload fields, which were
+    // left empty, can be decoded on demand.
+    void setLazyPayload(std::shared_ptr<LazyPayload> payload)
+    {
+        lazyPayload_ = std::move(payload);
+    }
+
+    bool hasLazyPayload() const {return lazyPayload_ != nullptr;}
+
+    const std::shared_ptr<LazyPayload>& lazyPayload() const
+    {
+        return lazyPayload_;
+    }
+
+    // Replaces the empty payload fields with their decoded values. Must be
+    // called before accessing fields() for encoding, or modifying the
+    // payload.
+    void loadPayload()
+    {
+        if (!lazyPayload_)
+            return;
+
+        // The lazy payload may have originated from a different message
+        // type, where the arguments are at another position.
+        auto pos = payloadPosition();
+        auto from = lazyPayload_->payloadPosition();
+        if (lazyPayload_.use_count() == 1)
+        {
+            auto decoded = lazyPayload_->releaseFields();
+            for (auto i=pos, j=from; i<fields_.size() && j<decoded.size();
+                 ++i, ++j)
+            {
+                fields_[i] = std::move(decoded[j]);
+            }
+        }
+        else
+        {
+            const auto& decoded = lazyPayload_->fields();
+            for (auto i=pos, j=from; i<fields_.size() && j<decoded.size();
+                 ++i, ++j)
+            {
+                fields_[i] = decoded[j];
+            }
+        }
+        lazyPayload_.reset();
+    }
+
 protected:
     WampMsgType type_;
     mutable Array fields_; // Mutable for lazy-loaded empty payloads
+    std::shared_ptr<LazyPayload> lazyPayload_;
 };
 
 //------------------------------------------------------------------------------
@@ -213,6 +277,8 @@ struct MessageWithPayload : public MessageWithOptions<Kind, I>
 
     const Array& args() const &
     {
+        if (this->lazyPayload_)
+            return this->lazyPayload_->args();
         if (this->fields_.size() <= argsPos)
             this->fields_.emplace_back(Array{});
         return this->fields_[argsPos].template as<Array>();
@@ -220,6 +286,7 @@ struct MessageWithPayload : public MessageWithOptions<Kind, I>
 
     Array& args() &
     {
+        this->loadPayload();
         if (this->fields_.size() <= argsPos)
             this->fields_.emplace_back(Array{});
         return this->fields_[argsPos].template as<Array>();
@@ -227,6 +294,8 @@ struct MessageWithPayload : public MessageWithOptions<Kind, I>
 
     const Object& kwargs() const
     {
+        if (this->lazyPayload_)
+            return this->lazyPayload_->kwargs();
         if (this->fields_.size() <= kwargsPos)
         {
             if (this->fields_.size() <= argsPos)
@@ -238,6 +307,7 @@ struct MessageWithPayload : public MessageWithOptions<Kind, I>
 
     Object& kwargs()
     {
+        this->loadPayload();
         if (this->fields_.size() <= kwargsPos)
         {
             if (this->fields_.size() <= argsPos)
@@ -247,6 +317,22 @@ struct MessageWithPayload : public MessageWithOptions<Kind, I>
         return this->fields_[kwargsPos].template as<Object>();
     }
 
+    // Replaces the arguments with ones that are still encoded within a
+    // received message.
+    void setEncodedPayload(std::shared_ptr<LazyPayload> payload)
+    {
+        if (this->fields_.size() > argsPos)
+            this->fields_.resize(argsPos);
+        if (payload)
+        {
+            if (payload->fieldCount() > 0)
+                this->fields_.emplace_back(Array{});
+            if (payload->fieldCount() > 1)
+                this->fields_.emplace_back(Object{});
+        }
+        this->lazyPayload_ = std::move(payload);
+    }
+
 protected:
     explicit MessageWithPayload(Array&& fields)
         : MessageWithOptions<Kind, I>(std::move(fields))
@@ -464,6 +550,11 @@ private:
     using Base = MessageWithPayload<WampMsgType::event, 3, 4>;
 };
 
+// Events are shared by reference when being dispatched to multiple
+// local subscribers.
+template <>
+struct IsSharedMessage<EventMessage> : std::true_type {};
+
 //------------------------------------------------------------------------------
 struct CallMessage : public MessageWithPayload<WampMsgType::call, 2, 4>
 {
@@ -112,6 +112,17 @@ public:
     /** Deserializes from the given input source to the given variant. */
     CPPWAMP_NODISCARD std::error_code decode(Source source, Variant& variant);
 
+    /** Deserializes a WAMP message from the given input source, leaving its
+        payload arguments empty.
+        The elements of the message array starting from its first nested
+        array (i.e. the positional and keyword arguments) are replaced with
+        empty placeholders of the same type, without decoding their contents.
+        @post `payloadSkipped` is true if any of the skipped elements were
+              non-empty. */
+    CPPWAMP_NODISCARD std::error_code decodeHeader(Source source,
+                                                   Variant& variant,
+                                                   bool& payloadSkipped);
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,63 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_LOOPBACK_HPP
+#define CPPWAMP_LOOPBACK_HPP
+
+//------------------------------------------------------------------------------
+/** @file
+    @brief Contains facilities for creating in-process loopback transport
+           connectors. */
+//------------------------------------------------------------------------------
+
+#include <memory>
+#include "api.hpp"
+#include "asiodefs.hpp"
+#include "connector.hpp"
+#include "loopbackhost.hpp"
+
+namespace wamp
+{
+
+//------------------------------------------------------------------------------
+/** Connector specialization that establishes an in-process loopback
+    transport with a LoopbackListener.
+    Users do not need to use this class directly and should use
+    ConnectionWish instead. */
+//------------------------------------------------------------------------------
+template <>
+class CPPWAMP_API Connector<Loopback> : public Connecting
+{
+public:
+    /** Type containing the transport settings. */
+    using Settings = LoopbackHost;
+
+    /** Constructor. */
+    Connector(IoStrand i, Settings s, int codecId);
+
+    /** Destructor. */
+    ~Connector();
+
+    /** Starts establishing the transport connection, emitting a
+        Transportable::Ptr via the given handler if successful. */
+    void establish(Handler&& handler) override;
+
+    /** Cancels transport connection in progress, emitting an error code
+        via the handler passed to the establish method. */
+    void cancel() override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace wamp
+
+#ifndef CPPWAMP_COMPILED_LIB
+#include "internal/loopback.ipp"
+#endif
+
+#endif // CPPWAMP_LOOPBACK_HPP
@@ -0,0 +1,162 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_LOOPBACKHOST_HPP
+#define CPPWAMP_LOOPBACKHOST_HPP
+
+//------------------------------------------------------------------------------
+/** @file
+    @brief Contains facilities for connecting sessions to a router residing
+           in the same process, without sockets. */
+//------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include "api.hpp"
+#include "asiodefs.hpp"
+#include "config.hpp"
+#include "connector.hpp"
+#include "erroror.hpp"
+#include "rawsockoptions.hpp"
+#include "transport.hpp"
+
+namespace wamp
+{
+
+//------------------------------------------------------------------------------
+/** Tag type associated with the in-process loopback transport. */
+//------------------------------------------------------------------------------
+struct CPPWAMP_API Loopback
+{
+    constexpr Loopback() = default;
+};
+
+template <> class Connector<Loopback>; // Forward declaration
+
+//------------------------------------------------------------------------------
+/** Accepts in-process loopback transports on behalf of a server.
+    Loopback transports move message buffers directly between the client
+    and server strands via lock-free queues, bypassing sockets and framing.
+    Connection requests made while no establishment is in progress are
+    queued until the next call to LoopbackListener::establish.
+    @see LoopbackHost */
+//------------------------------------------------------------------------------
+class CPPWAMP_API LoopbackListener
+    : public std::enable_shared_from_this<LoopbackListener>
+{
+public:
+    /// Shared pointer type.
+    using Ptr = std::shared_ptr<LoopbackListener>;
+
+    /// Set of numeric codec IDs supported by the server.
+    using CodecIds = std::set<int>;
+
+    /// Handler type used to emit accepted transports.
+    using Handler = std::function<void (ErrorOr<Transporting::Ptr>)>;
+
+    /// The default maximum length permitted for incoming messages.
+    static constexpr RawsockMaxLength defaultMaxRxLength =
+        RawsockMaxLength::MB_16;
+
+    /** Creates a listener whose accepted transports execute their handlers
+        via the given strand. */
+    static Ptr create(IoStrand strand, CodecIds codecIds,
+                      RawsockMaxLength maxRxLength = defaultMaxRxLength);
+
+    /** Accepts the next connection, emitting the server end of the
+        transport via the given handler. */
+    void establish(Handler&& handler);
+
+    /** Cancels the establishment in progress, emitting
+        TransportErrc::aborted via the handler. */
+    void cancel();
+
+private:
+    struct Request
+    {
+        IoStrand strand;
+        Handler handler;
+        std::uint64_t id;
+        int codecId;
+        std::size_t maxRxLength;
+    };
+
+    LoopbackListener(IoStrand strand, CodecIds codecIds,
+                     RawsockMaxLength maxRxLength);
+
+    std::uint64_t connect(IoStrand strand, int codecId,
+                          RawsockMaxLength maxRxLength, Handler&& handler);
+
+    void cancelConnect(std::uint64_t requestId);
+
+    void pair(Request&& request, Handler&& acceptHandler);
+
+    IoStrand strand_;
+    CodecIds codecIds_;
+    std::size_t maxRxLength_;
+    std::mutex mutex_;
+    std::deque<Request> requests_;
+    Handler handler_;
+    std::uint64_t nextRequestId_ = 0;
+
+    friend class Connector<Loopback>;
+};
+
+//------------------------------------------------------------------------------
+/** Contains the settings for connecting to a LoopbackListener.
+    Meets the requirements of @ref TransportSettings.
+    @see ConnectionWish */
+//------------------------------------------------------------------------------
+class CPPWAMP_API LoopbackHost
+{
+public:
+    /// Transport protocol tag associated with these settings.
+    using Protocol = Loopback;
+
+    /// The default maximum length permitted for incoming messages.
+    static constexpr RawsockMaxLength defaultMaxRxLength =
+        RawsockMaxLength::MB_16;
+
+    /** Constructor taking the listener to connect to. */
+    explicit LoopbackHost(
+        LoopbackListener::Ptr listener, ///< Listener to connect to.
+        RawsockMaxLength maxRxLength
+            = defaultMaxRxLength  ///< Maximum inbound message length
+    );
+
+    /** Specifies the maximum length permitted for incoming messages. */
+    LoopbackHost& withMaxRxLength(RawsockMaxLength length);
+
+    /** Couples a serialization format with these transport settings to
+        produce a ConnectionWish that can be passed to Session::connect. */
+    template <typename TFormat>
+    ConnectionWish withFormat(TFormat) const
+    {
+        return ConnectionWish{*this, TFormat{}};
+    }
+
+    /** Obtains the listener to connect to. */
+    const LoopbackListener::Ptr& listener() const;
+
+    /** Obtains the specified maximum incoming message length. */
+    RawsockMaxLength maxRxLength() const;
+
+private:
+    LoopbackListener::Ptr listener_;
+    RawsockMaxLength maxRxLength_;
+};
+
+} // namespace wamp
+
+#ifndef CPPWAMP_COMPILED_LIB
+#include "./internal/loopbackhost.ipp"
+#endif
+
+#endif // CPPWAMP_LOOPBACKHOST_HPP
@@ -11,6 +11,7 @@
 #include "api.hpp"
 #include "traits.hpp"
 #include "variant.hpp"
+#include "./internal/messageholder.hpp"
 #include "./internal/passkey.hpp"
 #include "./internal/wampmessage.hpp"
 
@@ -32,19 +33,19 @@ public:
     /** Adds an option. */
     TDerived& withOption(String key, Variant value)
     {
-        message_.options().emplace(std::move(key), std::move(value));
+        message().options().emplace(std::move(key), std::move(value));
         return static_cast<TDerived&>(*this);
     }
 
     /** Sets all options at once. */
     TDerived& withOptions(Object opts)
     {
-        message_.options() = std::move(opts);
+        message().options() = std::move(opts);
         return static_cast<TDerived&>(*this);
     }
 
     /** Accesses the entire dictionary of options. */
-    const Object& options() const {return message_.options();}
+    const Object& options() const {return message().options();}
 
     /** Obtains an option by key. */
     Variant optionByKey(const String& key) const
@@ -77,19 +78,19 @@ protected:
     /** Constructor taking message construction aruments. */
     template <typename... TArgs>
     explicit Options(TArgs&&... args)
-        : message_(std::forward<TArgs>(args)...)
+        : message_(internal::InPlaceMessage{}, std::forward<TArgs>(args)...)
     {}
 
-    MessageType& message() {return message_;}
+    MessageType& message() {return message_.get();}
 
-    const MessageType& message() const {return message_;}
+    const MessageType& message() const {return message_.get();}
 
 private:
-    MessageType message_;
+    internal::MessageHolder<MessageType> message_;
 
 public:
     // Internal use only
-    MessageType& message(internal::PassKey) {return message_;}
+    MessageType& message(internal::PassKey) {return message_.get();}
 };
 
 } // namespace wamp
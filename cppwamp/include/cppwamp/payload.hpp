@@ -14,6 +14,7 @@
 //------------------------------------------------------------------------------
 
 #include <initializer_list>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <tuple>
@@ -25,6 +26,63 @@
 namespace wamp
 {
 
+namespace internal
+{
+class LazyPayload;
+struct TypedPayloadAccess;
+}
+
+//------------------------------------------------------------------------------
+/** Opaque handle to the positional and keyword arguments of a received
+    message, in the still-encoded form in which they were received.
+
+    An encoded payload can be obtained via Payload::encodedPayload and passed
+    to Payload::withEncodedPayload to forward the arguments of a received
+    message without having to decode and re-encode them. An encoded payload
+    can also be built from statically-typed arguments via wamp::encodeArgs.
+    @see Session::setLazyPayloads */
+//------------------------------------------------------------------------------
+class CPPWAMP_API EncodedPayload
+{
+public:
+    /** Constructs an empty encoded payload. */
+    EncodedPayload() = default;
+
+    /** Returns false if the encoded payload is empty. */
+    explicit operator bool() const {return impl_ != nullptr;}
+
+private:
+    using Impl = std::shared_ptr<internal::LazyPayload>;
+
+    explicit EncodedPayload(Impl impl) : impl_(std::move(impl)) {}
+
+    Impl impl_;
+
+    template <typename, typename> friend class Payload;
+    friend struct internal::TypedPayloadAccess;
+};
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+// Provides access to the raw bytes of encoded payloads for typed encoding
+// and decoding.
+//------------------------------------------------------------------------------
+struct TypedPayloadAccess
+{
+    using Impl = std::shared_ptr<LazyPayload>;
+
+    static EncodedPayload make(Impl impl)
+    {
+        return EncodedPayload{std::move(impl)};
+    }
+
+    static const Impl& impl(const EncodedPayload& p) {return p.impl_;}
+};
+
+} // namespace internal
+
 //------------------------------------------------------------------------------
 /** Wrapper around a WAMP message containing payload arguments and an
     options dictionary. */
@@ -48,6 +106,14 @@ public:
     /** Sets the keyword arguments for this payload. */
     TDerived& withKwargs(Object kwargs);
 
+    /** Sets the positional and keyword arguments for this payload from
+        the still-encoded arguments of a received message. */
+    TDerived& withEncodedPayload(EncodedPayload payload);
+
+    /** Obtains the still-encoded positional and keyword arguments of
+        a received message. */
+    EncodedPayload encodedPayload() const;
+
     /** Accesses the constant list of positional arguments. */
     const Array& args() const &;
 
@@ -184,6 +250,42 @@ D& Payload<D,M>::withKwargs(Object map)
     return static_cast<D&>(*this);
 }
 
+//------------------------------------------------------------------------------
+/** @details
+    When the session sending this payload uses the same serialization format
+    as the session that received the encoded payload, the encoded arguments
+    are copied verbatim into the outgoing message. Otherwise, they are
+    decoded and then re-encoded in the outgoing format.
+
+    The arguments may still be inspected via Payload::args and
+    Payload::kwargs, which decode them on demand. Modifying the arguments
+    afterwards discards their encoded form. Passing an empty encoded payload
+    clears the arguments.
+    @see Payload::encodedPayload */
+//------------------------------------------------------------------------------
+template <typename D, typename M>
+D& Payload<D,M>::withEncodedPayload(EncodedPayload payload)
+{
+    this->message().setEncodedPayload(std::move(payload.impl_));
+    return static_cast<D&>(*this);
+}
+
+//------------------------------------------------------------------------------
+/** @details
+    The encoded arguments are only available for messages received while
+    Session::setLazyPayloads is enabled, and only for as long as the
+    arguments haven't been modified or moved out of this payload. Reading
+    them via the `const` overloads of Payload::args and Payload::kwargs
+    keeps them available.
+    @returns An empty EncodedPayload if the encoded arguments are
+             unavailable. */
+//------------------------------------------------------------------------------
+template <typename D, typename M>
+EncodedPayload Payload<D,M>::encodedPayload() const
+{
+    return EncodedPayload(this->message().lazyPayload());
+}
+
 //------------------------------------------------------------------------------
 template <typename D, typename M>
 const Array& Payload<D,M>::args() const &
@@ -12,6 +12,9 @@
     @brief Contains common option definitions for raw socket transports. */
 //------------------------------------------------------------------------------
 
+#include <cstddef>
+#include "api.hpp"
+
 namespace wamp
 {
 
@@ -39,6 +42,51 @@ enum class RawsockMaxLength
     MB_16   ///< 16 megabytes
 };
 
+//------------------------------------------------------------------------------
+/** Contains options pertaining to the framing layer of raw socket transports,
+    as opposed to the options of the underlying socket. */
+//------------------------------------------------------------------------------
+class CPPWAMP_API RawsockOptions
+{
+public:
+    /** Enables the coalescing of queued outbound messages into a single
+        scatter/gather write operation. A batch is limited to the given
+        number of messages and total number of bytes (including framing
+        headers), but always contains at least one message. Batching is
+        disabled by default, which is the same as a limit of one message. */
+    RawsockOptions& withTxBatching(std::size_t maxMessages,
+                                   std::size_t maxBytes);
+
+    /** Enables reading ahead from the socket into a receive buffer of the
+        given size, so that multiple small messages can be obtained with a
+        single read operation. Messages too large to fit in the buffer are
+        read directly into their own storage. Read-ahead is disabled by
+        default, and a size of zero disables it. Nonzero sizes smaller than
+        minRxBufferSize are rounded up. */
+    RawsockOptions& withRxBuffering(std::size_t bufferSize);
+
+    /** Obtains the maximum number of messages per outbound batch. */
+    std::size_t txBatchMaxMessages() const;
+
+    /** Obtains the maximum number of bytes per outbound batch. */
+    std::size_t txBatchMaxBytes() const;
+
+    /** Obtains the read-ahead receive buffer size, or zero if disabled. */
+    std::size_t rxBufferSize() const;
+
+    /// Minimum size of the read-ahead receive buffer.
+    static constexpr std::size_t minRxBufferSize = 64;
+
+private:
+    std::size_t txBatchMaxMessages_ = 1;
+    std::size_t txBatchMaxBytes_ = 0;
+    std::size_t rxBufferSize_ = 0;
+};
+
 } // namespace wamp
 
+#ifndef CPPWAMP_COMPILED_LIB
+#include "./internal/rawsockoptions.ipp"
+#endif
+
 #endif // CPPWAMP_RAWSOCKOPTIONS_HPP
@@ -13,6 +13,7 @@
            in WAMP applications. */
 //------------------------------------------------------------------------------
 
+#include <chrono>
 #include <future>
 #include <memory>
 #include <string>
@@ -316,6 +317,20 @@ public:
     /** Sets the maximum level of log events that will be emitted. */
     void setLogLevel(LogLevel level);
 
+    /** Enables or disables deferred decoding of received payload
+        arguments. */
+    void setLazyPayloads(bool enabled);
+
+    /** Sets the outbound queue thresholds at which publications are held
+        back. */
+    void setTxWatermarks(TxWatermarks watermarks);
+
+    /** Enables or disables the racing of connection attempts across
+        multiple connection wishes. */
+    void setConnectionRacing(bool enabled,
+                             std::chrono::steady_clock::duration stagger =
+                                 std::chrono::milliseconds(250));
+
     /** Sets the log handler that is dispatched for warnings. */
     CPPWAMP_DEPRECATED void setWarningHandler(LogStringHandler handler);
 
@@ -478,6 +493,17 @@ public:
     template <typename C>
     CPPWAMP_NODISCARD Deduced<ErrorOr<PublicationId>, C>
     publish(ThreadSafe, Pub pub, C&& completion);
+
+    /** Waits until the transport's outbound queue has drained to its low
+        watermarks. */
+    template <typename C>
+    CPPWAMP_NODISCARD Deduced<ErrorOr<bool>, C>
+    awaitTxSpace(C&& completion);
+
+    /** Thread-safe wait for outbound queue space. */
+    template <typename C>
+    CPPWAMP_NODISCARD Deduced<ErrorOr<bool>, C>
+    awaitTxSpace(ThreadSafe, C&& completion);
     /// @}
 
     /// @name Remote Procedures
@@ -602,6 +628,7 @@ private:
     struct SubscribeOp;
     struct UnsubscribeOp;
     struct PublishOp;
+    struct AwaitTxSpaceOp;
     struct EnrollOp;
     struct EnrollIntrOp;
     struct UnregisterOp;
@@ -633,6 +660,8 @@ private:
     void safeUnsubscribe(const Subscription& s, CompletionHandler<bool>&& f);
     void doPublish(Pub&& p, CompletionHandler<PublicationId>&& f);
     void safePublish(Pub&& p, CompletionHandler<PublicationId>&& f);
+    void doAwaitTxSpace(CompletionHandler<bool>&& f);
+    void safeAwaitTxSpace(CompletionHandler<bool>&& f);
     void doEnroll(Procedure&& p, CallSlot&& c, InterruptSlot&& i,
                   CompletionHandler<Registration>&& f);
     void safeEnroll(Procedure&& p, CallSlot&& c, InterruptSlot&& i,
@@ -731,7 +760,9 @@ Session::connect(
 //------------------------------------------------------------------------------
 /** @details
     The session will attempt to connect using the transport/codec combinations
-    specified in the given ConnectionWishList, in the same order.
+    specified in the given ConnectionWishList, in the same order. If
+    connection racing is enabled via Session::setConnectionRacing, the
+    attempts overlap and the first transport to be established wins.
     @return The index of the ConnectionWish used to establish the connetion.
     @pre `wishes.empty() == false`
     @post `this->state() == SessionState::connecting` if successful
@@ -1216,6 +1247,8 @@ struct Session::PublishOp
           the transport's limits.
         - SessionErrc::invalidState if the session was not established
           during the attempt to publish.
+        - TransportErrc::wouldBlock if the transport's outbound queue is
+          above its high watermark (see Session::awaitTxSpace).
         - SessionErrc::sessionEnded if the operation was aborted.
         - SessionErrc::sessionEndedByPeer if the session was ended by the peer.
         - SessionErrc::publishError if the router replies with an ERROR
@@ -1257,6 +1290,69 @@ Session::publish(
                                      std::move(pub));
 }
 
+//------------------------------------------------------------------------------
+struct Session::AwaitTxSpaceOp
+{
+    using ResultValue = bool;
+    Session* self;
+
+    template <typename F> void operator()(F&& f)
+    {
+        self->doAwaitTxSpace(std::forward<F>(f));
+    }
+
+    template <typename F> void operator()(F&& f, ThreadSafe)
+    {
+        self->safeAwaitTxSpace(std::forward<F>(f));
+    }
+};
+
+//------------------------------------------------------------------------------
+/** @details
+    Completes immediately if the outbound queue is not blocked. Otherwise,
+    completes once the queued bytes and frames have fallen to the low
+    watermarks set via Session::setTxWatermarks. Publishers can use this to
+    wait for space instead of having their publications rejected with
+    TransportErrc::wouldBlock.
+    @return `true` once there is space available.
+    @par Error Codes
+        - SessionErrc::invalidState if the session was not established
+          while attempting to wait.
+        - TransportErrc::aborted if the transport was closed while waiting.
+        - Some other `std::error_code` for transport errors. */
+//------------------------------------------------------------------------------
+template <typename C>
+#ifdef CPPWAMP_FOR_DOXYGEN
+Deduced<ErrorOr<bool>, C>
+#else
+Session::template Deduced<ErrorOr<bool>, C>
+#endif
+Session::awaitTxSpace(
+    C&& completion /**< Callable handler of type `void(ErrorOr<bool>)`,
+                        or a compatible Boost.Asio completion token. */
+    )
+{
+    return initiate<AwaitTxSpaceOp>(std::forward<C>(completion));
+}
+
+//------------------------------------------------------------------------------
+/** @copydetails Session::awaitTxSpace(C&&) */
+//------------------------------------------------------------------------------
+template <typename C>
+#ifdef CPPWAMP_FOR_DOXYGEN
+Deduced<ErrorOr<bool>, C>
+#else
+Session::template Deduced<ErrorOr<bool>, C>
+#endif
+Session::awaitTxSpace(
+    ThreadSafe,
+    C&& completion /**< Callable handler of type `void(ErrorOr<bool>)`,
+                        or a compatible Boost.Asio completion token. */
+    )
+{
+    return safelyInitiate<AwaitTxSpaceOp>(std::forward<C>(completion));
+}
+
 //------------------------------------------------------------------------------
 struct Session::EnrollOp
 {
@@ -57,6 +57,9 @@ public:
     /** Specifies the maximum length permitted for incoming messages. */
     TcpEndpoint& withMaxRxLength(RawsockMaxLength length);
 
+    /** Specifies options for the raw socket framing layer. */
+    TcpEndpoint& withRawsockOptions(RawsockOptions options);
+
     /** Obtains the endpoint address. */
     const std::string& address() const;
 
@@ -69,9 +72,13 @@ public:
     /** Obtains the specified maximum incoming message length. */
     RawsockMaxLength maxRxLength() const;
 
+    /** Obtains the raw socket framing layer options. */
+    const RawsockOptions& rawsockOptions() const;
+
 private:
     std::string address_;
     TcpOptions options_;
+    RawsockOptions rawsockOptions_;
     RawsockMaxLength maxRxLength_;
     unsigned short port_;
 };
@@ -19,6 +19,7 @@
 #include "connector.hpp"
 #include "rawsockoptions.hpp"
 #include "tcpprotocol.hpp"
+#include "tcpresolvercache.hpp"
 
 namespace wamp
 {
@@ -62,6 +63,14 @@ public:
     /** Specifies the maximum length permitted for incoming messages. */
     TcpHost& withMaxRxLength(RawsockMaxLength length);
 
+    /** Specifies options for the raw socket framing layer. */
+    TcpHost& withRawsockOptions(RawsockOptions options);
+
+    /** Specifies a DNS resolution cache, possibly shared with other hosts,
+        to be consulted instead of querying the resolver upon every
+        connection attempt. */
+    TcpHost& withResolverCache(TcpResolverCache::Ptr cache);
+
     /** Couples a serialization format with these transport settings to
         produce a ConnectionWish that can be passed to Session::connect. */
     template <typename TFormat>
@@ -82,6 +91,13 @@ public:
     /** Obtains the specified maximum incoming message length. */
     RawsockMaxLength maxRxLength() const;
 
+    /** Obtains the raw socket framing layer options. */
+    const RawsockOptions& rawsockOptions() const;
+
+    /** Obtains the DNS resolution cache, or a null pointer if none was
+        specified. */
+    const TcpResolverCache::Ptr& resolverCache() const;
+
     /** The following setters are deprecated. Socket options should
         be passed via the constructor or set via TcpHost::withOptions. */
     /// @{
@@ -189,6 +205,8 @@ private:
     std::string hostName_;
     std::string serviceName_;
     TcpOptions options_;
+    RawsockOptions rawsockOptions_;
+    TcpResolverCache::Ptr resolverCache_;
     RawsockMaxLength maxRxLength_;
 };
 
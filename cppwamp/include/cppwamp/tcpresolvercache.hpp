@@ -0,0 +1,183 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_TCPRESOLVERCACHE_HPP
+#define CPPWAMP_TCPRESOLVERCACHE_HPP
+
+//------------------------------------------------------------------------------
+/** @file
+    @brief Contains a DNS resolution cache that can be shared amongst TCP
+           connectors. */
+//------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/asio/ip/tcp.hpp>
+#include "api.hpp"
+#include "asiodefs.hpp"
+#include "erroror.hpp"
+
+namespace wamp
+{
+
+//------------------------------------------------------------------------------
+/** Statistics gathered by a TcpResolverCache. */
+//------------------------------------------------------------------------------
+struct CPPWAMP_API TcpResolverStats
+{
+    std::size_t hits = 0;        ///< Lookups served from the cache.
+    std::size_t misses = 0;      ///< Lookups that had to wait for resolution.
+    std::size_t resolutions = 0; ///< Successful resolver queries.
+    std::size_t failures = 0;    ///< Failed resolver queries.
+};
+
+//------------------------------------------------------------------------------
+/** Caches the endpoints resolved for TCP host/service pairs.
+
+    A cache can be shared by any number of TcpHost settings, via
+    TcpHost::withResolverCache, so that sessions reconnecting en masse do
+    not each query the DNS resolver. Concurrent lookups of the same
+    host/service pair are coalesced into a single resolver query.
+    Resolved endpoints expire after a time-to-live, whereas static entries
+    (akin to `/etc/hosts` entries) never expire.
+
+    A TcpResolverCache may be used from multiple threads. Resolver queries
+    are executed via the executor passed to TcpResolverCache::create. */
+//------------------------------------------------------------------------------
+class CPPWAMP_API TcpResolverCache
+    : public std::enable_shared_from_this<TcpResolverCache>
+{
+public:
+    /// Shared pointer type.
+    using Ptr = std::shared_ptr<TcpResolverCache>;
+
+    /// Clock used to determine expiry.
+    using Clock = std::chrono::steady_clock;
+
+    /// Duration type used for time-to-live values.
+    using Duration = Clock::duration;
+
+    /// Resolved TCP endpoint type.
+    using Endpoint = boost::asio::ip::tcp::endpoint;
+
+    /// List of resolved endpoints, in the order they should be tried.
+    using EndpointList = std::vector<Endpoint>;
+
+    /// Handler type used for emitting lookup results.
+    using Handler = std::function<void (ErrorOr<EndpointList>)>;
+
+    /// Default time-to-live of resolved endpoints.
+    static constexpr Duration defaultTtl()
+    {
+        return std::chrono::seconds(60);
+    }
+
+    /** Creates a cache that executes resolver queries via the given
+        executor. */
+    static Ptr create(AnyIoExecutor exec, Duration ttl = defaultTtl());
+
+    /** Sets the time-to-live of subsequently resolved endpoints. */
+    void setTtl(Duration ttl);
+
+    /** Enables background refresh of entries that are looked up within the
+        given margin before their expiry. The stale entry is emitted while
+        the refresh proceeds. A zero margin, the default, disables
+        background refresh. */
+    void setRefreshMargin(Duration margin);
+
+    /** Adds an entry that never expires and is never queried via the
+        resolver. */
+    void addStatic(std::string hostName, std::string serviceName,
+                   EndpointList endpoints);
+
+    /** Resolves the given host/service pair in the background, if not
+        already cached, so that later lookups can be served from the cache. */
+    void preresolve(std::string hostName, std::string serviceName);
+
+    /** Emits the cached endpoints for the given host/service pair via the
+        given strand, querying the resolver first if necessary. */
+    void lookup(std::string hostName, std::string serviceName,
+                IoStrand strand, Handler handler);
+
+    /** Obtains the cached endpoints for the given host/service pair without
+        querying the resolver. The list is empty if there is no unexpired
+        entry. */
+    EndpointList find(const std::string& hostName,
+                      const std::string& serviceName) const;
+
+    /** Discards the resolved endpoints of the given host/service pair,
+        so that the next lookup queries the resolver. Static entries are
+        unaffected. */
+    void invalidate(const std::string& hostName,
+                    const std::string& serviceName);
+
+    /** Removes the given entry, including static ones. */
+    void remove(const std::string& hostName, const std::string& serviceName);
+
+    /** Removes all entries, including static ones. */
+    void clear();
+
+    /** Obtains the number of cached entries. */
+    std::size_t size() const;
+
+    /** Obtains the statistics gathered so far. */
+    TcpResolverStats stats() const;
+
+private:
+    using Key = std::pair<std::string, std::string>;
+    using TimePoint = Clock::time_point;
+    using Resolver = boost::asio::ip::tcp::resolver;
+
+    struct Waiter
+    {
+        IoStrand strand;
+        Handler handler;
+    };
+
+    struct Entry
+    {
+        bool isFresh(TimePoint now) const;
+        bool isDueForRefresh(TimePoint now, Duration margin) const;
+
+        EndpointList endpoints;
+        std::vector<Waiter> waiters;
+        TimePoint expiry;
+        bool isStatic = false;
+        bool isResolving = false;
+    };
+
+    TcpResolverCache(AnyIoExecutor exec, Duration ttl);
+
+    void resolve(const Key& key);
+
+    void onResolved(const Key& key, boost::system::error_code asioEc,
+                    const Resolver::results_type& results);
+
+    static void notify(std::vector<Waiter>& waiters,
+                       const ErrorOr<EndpointList>& result);
+
+    AnyIoExecutor executor_;
+    mutable std::mutex mutex_;
+    std::map<Key, Entry> entries_;
+    TcpResolverStats stats_;
+    Duration ttl_;
+    Duration refreshMargin_ = Duration::zero();
+};
+
+} // namespace wamp
+
+#ifndef CPPWAMP_COMPILED_LIB
+#include "./internal/tcpresolvercache.ipp"
+#endif
+
+#endif // CPPWAMP_TCPRESOLVERCACHE_HPP
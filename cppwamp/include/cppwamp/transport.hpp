@@ -7,9 +7,12 @@
 #ifndef CPPWAMP_TRANSPORT_HPP
 #define CPPWAMP_TRANSPORT_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <system_error>
+#include <utility>
 #include <vector>
 #include "asiodefs.hpp"
 #include "erroror.hpp"
@@ -26,6 +29,76 @@ struct TransportInfo
     std::size_t maxRxLength;
 };
 
+//------------------------------------------------------------------------------
+/** Priority classes of outbound messages. Transports supporting them send
+    queued messages of higher priority first, while preserving the order of
+    messages having the same priority. */
+//------------------------------------------------------------------------------
+enum class TxPriority
+{
+    control, ///< Transport and session control (e.g. pings, HELLO)
+    rpc,     ///< Requests and replies (e.g. CALL, YIELD, SUBSCRIBE)
+    bulk     ///< Publications, events, and messages that must follow them
+};
+
+//------------------------------------------------------------------------------
+/** Thresholds at which a transport's outbound queue applies backpressure.
+    Once either the number of queued bytes or frames rises above its high
+    watermark, the transport reports that it is blocked until both have
+    fallen back to their low watermarks. A high watermark of zero disables
+    the corresponding limit, which is the default. */
+//------------------------------------------------------------------------------
+class TxWatermarks
+{
+public:
+    /** Sets the watermarks for the number of queued bytes, including
+        framing overhead. The low watermark is capped to the high one. */
+    TxWatermarks& withBytes(std::size_t high, std::size_t low)
+    {
+        highBytes_ = high;
+        lowBytes_ = (std::min)(low, high);
+        return *this;
+    }
+
+    /** Sets the watermarks for the number of queued frames. The low
+        watermark is capped to the high one. */
+    TxWatermarks& withFrames(std::size_t high, std::size_t low)
+    {
+        highFrames_ = high;
+        lowFrames_ = (std::min)(low, high);
+        return *this;
+    }
+
+    std::size_t highBytes() const {return highBytes_;}
+
+    std::size_t lowBytes() const {return lowBytes_;}
+
+    std::size_t highFrames() const {return highFrames_;}
+
+    std::size_t lowFrames() const {return lowFrames_;}
+
+    /** Returns true if the given queue size rises above a high watermark. */
+    bool isAboveHigh(std::size_t bytes, std::size_t frames) const
+    {
+        return (highBytes_ != 0 && bytes > highBytes_) ||
+               (highFrames_ != 0 && frames > highFrames_);
+    }
+
+    /** Returns true if the given queue size is at or below all enabled low
+        watermarks. */
+    bool isAtOrBelowLow(std::size_t bytes, std::size_t frames) const
+    {
+        return (highBytes_ == 0 || bytes <= lowBytes_) &&
+               (highFrames_ == 0 || frames <= lowFrames_);
+    }
+
+private:
+    std::size_t highBytes_ = 0;
+    std::size_t lowBytes_ = 0;
+    std::size_t highFrames_ = 0;
+    std::size_t lowFrames_ = 0;
+};
+
 //------------------------------------------------------------------------------
 // Interface class for transports.
 //------------------------------------------------------------------------------
@@ -44,6 +117,9 @@ public:
     /// Handler type used for ping response events.
     using PingHandler = std::function<void (float)>;
 
+    /// Handler type used for transmit space availability events.
+    using TxSpaceHandler = std::function<void (std::error_code)>;
+
     // Noncopyable
     Transporting(const Transporting&) = delete;
     Transporting& operator=(const Transporting&) = delete;
@@ -64,12 +140,58 @@ public:
     /** Sends the given serialized message via the transport. */
     virtual void send(MessageBuffer message) = 0;
 
+    /** Sends the given serialized message via the transport, ahead of
+        already queued messages of lower priority.
+        The default implementation ignores the priority. */
+    virtual void send(MessageBuffer message, TxPriority)
+    {
+        send(std::move(message));
+    }
+
     /** Stops I/O operations and closes the underlying socket. */
     virtual void close() = 0;
 
     /** Sends a transport-level ping message. */
     virtual void ping(MessageBuffer message, PingHandler handler) = 0;
 
+    /** Obtains an empty buffer, possibly with storage already reserved,
+        into which an outgoing message can be serialized before being
+        passed to Transporting::send.
+        The default implementation returns a default-constructed buffer. */
+    virtual MessageBuffer acquireBuffer() {return {};}
+
+    /** Gives back the storage of a buffer that was passed to the RxHandler
+        or obtained via Transporting::acquireBuffer, so that the transport
+        may reuse it for subsequent messages.
+        @pre Must be called from within the RxHandler, or from the same
+             execution context used to call Transporting::send.
+        The default implementation simply discards the buffer. */
+    virtual void recycle(MessageBuffer&&) {}
+
+    /** Sets the thresholds at which the outbound queue reports being
+        blocked. The default implementation ignores them, for transports
+        that do not queue outbound messages. */
+    virtual void setTxWatermarks(TxWatermarks) {}
+
+    /** Returns true if the outbound queue rose above a high watermark and
+        has not yet drained to the low watermarks.
+        Transports keep accepting messages while blocked; it is up to the
+        caller to hold back those that can wait. */
+    virtual bool isTxBlocked() const {return false;}
+
+    /** Obtains the number of bytes, including framing overhead, that are
+        queued or being written. */
+    virtual std::size_t txQueuedBytes() const {return 0;}
+
+    /** Obtains the number of frames that are queued or being written. */
+    virtual std::size_t txQueuedFrames() const {return 0;}
+
+    /** Arranges for the given handler to be called once the transport is no
+        longer blocked, or with an error if the transport is closed or
+        fails beforehand.
+        The default implementation calls the handler immediately. */
+    virtual void awaitTxSpace(TxSpaceHandler handler) {handler({});}
+
 protected:
     Transporting() = default;
 };
@@ -0,0 +1,218 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#ifndef CPPWAMP_TYPEDENCODING_HPP
+#define CPPWAMP_TYPEDENCODING_HPP
+
+//------------------------------------------------------------------------------
+/** @file
+    @brief Contains facilities for encoding statically-typed values without
+           first converting them to Variant. */
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "api.hpp"
+#include "codec.hpp"
+#include "messagebuffer.hpp"
+#include "payload.hpp"
+#include "variant.hpp"
+#include "internal/lazypayload.hpp"
+#include "internal/typedencoding.hpp"
+
+namespace wamp
+{
+
+//------------------------------------------------------------------------------
+/** Wrapper around a destination encoder, used for conversions performed
+    by typed encoding.
+    This converter is passed to the generic `convert` functions of custom
+    types, and provides the same syntax as ToVariantConverter. Instead of
+    populating a Variant, it feeds the converted values directly to the
+    underlying encoder.
+
+    Each `convert` function is invoked twice per object: once to determine
+    the number of array elements or object members, and once to encode them.
+    Object members are encoded in the order they are converted.
+    @see wamp::encodeTyped */
+//------------------------------------------------------------------------------
+template <typename TEncoder>
+class CPPWAMP_API EncodingConverter
+{
+public:
+    /// Integer type used to represent the size of arrays.
+    using SizeType = std::size_t;
+
+    /// String type used to represent an object key.
+    using String = std::string;
+
+    /** Indicates that this converter is used to convert **to** a
+        serialized representation of a variant. */
+    static constexpr bool convertingToVariant = true;
+
+    /** Makes the destination become an array. */
+    EncodingConverter& size(SizeType)
+    {
+        if (encoder_ == nullptr)
+            shape_.noteSize();
+        return *this;
+    }
+
+    /** Encodes a value as the destination. */
+    template <typename T>
+    EncodingConverter& operator()(T&& value)
+    {
+        if (encoder_ == nullptr)
+            shape_.noteScalar();
+        else
+            encoder_->encode(value);
+        return *this;
+    }
+
+    /** Encodes an array element. */
+    template <typename T>
+    EncodingConverter& operator[](T&& value)
+    {
+        if (encoder_ == nullptr)
+            shape_.noteElement();
+        else
+            encoder_->encode(value);
+        return *this;
+    }
+
+    /** Encodes an object member. */
+    template <typename T>
+    EncodingConverter& operator()(internal::ConverterKey key, T&& value)
+    {
+        if (encoder_ == nullptr)
+        {
+            shape_.noteMember();
+        }
+        else
+        {
+            encoder_->encodeKey(key);
+            encoder_->encode(value);
+        }
+        return *this;
+    }
+
+    /** Encodes an object member. */
+    template <typename T, typename U>
+    EncodingConverter& operator()(internal::ConverterKey key, T&& value,
+                                  U&&)
+    {
+        return operator()(key, std::forward<T>(value));
+    }
+
+private:
+    using Shape = internal::ConversionShape;
+
+    explicit EncodingConverter(Shape& shape) : shape_(shape) {}
+
+    EncodingConverter(TEncoder& encoder, Shape& shape)
+        : shape_(shape),
+          encoder_(&encoder)
+    {}
+
+    Shape& shape_;
+    TEncoder* encoder_ = nullptr;
+
+    friend TEncoder;
+};
+
+//------------------------------------------------------------------------------
+/** Encodes the given statically-typed value to the given byte container,
+    without first converting it to a Variant.
+    The result is equivalent to `wamp::encode<TFormat>(Variant::from(value))`,
+    except that object members of custom types are encoded in the order in
+    which their `convert` function converts them.
+
+    Custom types having a generic `convert` function template, in the form
+    `template <typename C> void convert(C&, T&)` or as a member, are encoded
+    directly via EncodingConverter. Enumerators and custom types with
+    non-generic or split conversions are converted to Variant beforehand.
+    By design, the output is not cleared before encoding.
+    @tparam TFormat The serialization format tag (e.g. Json)
+    @tparam T The value type (deduced)
+    @tparam TOutput The output type, either std::string or MessageBuffer
+                    (deduced) */
+//------------------------------------------------------------------------------
+template <typename TFormat, typename T, typename TOutput>
+void encodeTyped(const T& value, TOutput& output)
+{
+    internal::TypedEncodingTraits<TFormat>::encode(value, output);
+}
+
+namespace internal
+{
+
+//------------------------------------------------------------------------------
+template <typename TFormat, typename TFields>
+EncodedPayload encodeTypedPayload(const TFields& fields)
+{
+    // Only used as a prototype to be cloned if the arguments ever need
+    // to be decoded.
+    static const AnyBufferCodec prototype{TFormat{}};
+
+    MessageBuffer buffer;
+    encodeTyped<TFormat>(fields, buffer);
+    return TypedPayloadAccess::make(std::make_shared<LazyPayload>(
+        std::move(buffer), prototype, TFormat::id(), 0,
+        std::tuple_size<TFields>::value));
+}
+
+} // namespace internal
+
+//------------------------------------------------------------------------------
+/** Encodes the given statically-typed positional arguments from a tuple,
+    without first converting them to Variant.
+    The result can be passed to Payload::withEncodedPayload. When the
+    session uses the same serialization format, the encoded arguments are
+    copied verbatim into outgoing messages. Otherwise, they are decoded and
+    re-encoded in the session's format.
+    @tparam TFormat The serialization format tag (e.g. Json)
+    @see wamp::encodeTyped */
+//------------------------------------------------------------------------------
+template <typename TFormat, typename... Ts>
+EncodedPayload encodeArgsTuple(const std::tuple<Ts...>& args)
+{
+    using Fields = std::tuple<const std::tuple<Ts...>&>;
+    return internal::encodeTypedPayload<TFormat>(Fields(args));
+}
+
+//------------------------------------------------------------------------------
+/** Encodes the given statically-typed positional and keyword arguments,
+    without first converting them to Variant.
+    The keyword arguments must be of a type that is encoded as an
+    object, such as a std::map or a custom type converted via key-value
+    pairs.
+    @copydetails wamp::encodeArgsTuple(const std::tuple<Ts...>&) */
+//------------------------------------------------------------------------------
+template <typename TFormat, typename TKwargs, typename... Ts>
+EncodedPayload encodeArgsTuple(const std::tuple<Ts...>& args,
+                               const TKwargs& kwargs)
+{
+    using Fields = std::tuple<const std::tuple<Ts...>&, const TKwargs&>;
+    return internal::encodeTypedPayload<TFormat>(Fields(args, kwargs));
+}
+
+//------------------------------------------------------------------------------
+/** Encodes the given statically-typed positional arguments, without
+    first converting them to Variant.
+    @copydetails wamp::encodeArgsTuple(const std::tuple<Ts...>&) */
+//------------------------------------------------------------------------------
+template <typename TFormat, typename... Ts>
+EncodedPayload encodeArgs(const Ts&... args)
+{
+    return encodeArgsTuple<TFormat>(std::tuple<const Ts&...>(args...));
+}
+
+} // namespace wamp
+
+#endif // CPPWAMP_TYPEDENCODING_HPP
@@ -53,6 +53,9 @@ public:
     /** Specifies the maximum length permitted for incoming messages. */
     UdsPath& withMaxRxLength(RawsockMaxLength length);
 
+    /** Specifies options for the raw socket framing layer. */
+    UdsPath& withRawsockOptions(RawsockOptions options);
+
     /** Enables/disables the deletion of existing file path before listening. */
     UdsPath& withDeletePath(bool enabled = true);
 
@@ -73,6 +76,9 @@ public:
     /** Obtains the specified maximum incoming message length. */
     RawsockMaxLength maxRxLength() const;
 
+    /** Obtains the raw socket framing layer options. */
+    const RawsockOptions& rawsockOptions() const;
+
     /** Returns true if path deletion before listening is enabled. */
     bool deletePathEnabled() const;
 
@@ -161,6 +167,7 @@ public:
 private:
     std::string pathName_;
     UdsOptions options_;
+    RawsockOptions rawsockOptions_;
     RawsockMaxLength maxRxLength_;
     bool deletePathEnabled_;
 };
@@ -13,7 +13,9 @@
            event slots and call slots. */
 //------------------------------------------------------------------------------
 
+#include <cstddef>
 #include <functional>
+#include <sstream>
 #include <tuple>
 #include "api.hpp"
 #include "config.hpp"
@@ -21,6 +23,7 @@
 #include "traits.hpp"
 #include "variant.hpp"
 #include "./internal/integersequence.hpp"
+#include "./internal/typeddecoding.hpp"
 
 namespace wamp
 {
@@ -37,6 +40,9 @@ using DecayedSlot = typename std::decay<TSlot>::type;
     payload arguments.
     The [wamp::unpackedEvent](@ref EventUnpacker::unpackedEvent) convenience
     function should be used to construct instances of EventUnpacker.
+    If the event's arguments are still encoded, as is the case when
+    Session::setLazyPayloads is enabled, they are decoded straight into the
+    `TArgs` types without first being converted to an Array of Variants.
     @see [wamp::unpackedEvent](@ref EventUnpacker::unpackedEvent)
     @see @ref UnpackedEventSlots
     @tparam TSlot Function type to be wrapped.
@@ -152,6 +158,8 @@ basicEvent(TSlot&& slot);
     arguments.
     The [wamp::unpackedRpc](@ref InvocationUnpacker::unpackedRpc) convenience
     function should be used to construct instances of InvocationUnpacker.
+    As with EventUnpacker, still-encoded arguments are decoded straight into
+    the `TArgs` types.
     @see [wamp::unpackedRpc](@ref InvocationUnpacker::unpackedRpc)
     @see @ref UnpackedCallSlots
     @tparam TSlot Function type to be wrapped.
@@ -291,6 +299,46 @@ struct UnpackError : public Error
     UnpackError() : Error("wamp.error.invalid_argument") {}
 };
 
+//------------------------------------------------------------------------------
+// Converts the positional arguments of the given payload to the given tuple.
+// If the arguments are still encoded, they are decoded directly into the
+// tuple, bypassing the intermediate Array of Variants.
+//------------------------------------------------------------------------------
+template <typename TPayload, typename... Ts>
+void unpackArgs(const TPayload& payload, std::tuple<Ts...>& args)
+{
+    std::size_t count = 0;
+    auto encoded = payload.encodedPayload();
+
+    try
+    {
+        if (!decodeTypedArgs(encoded, args, count))
+        {
+            count = payload.args().size();
+            auto ec = decodingErrorOf(encoded);
+            if (ec)
+            {
+                throw UnpackError().withArgs("Error decoding payload: " +
+                                             ec.message());
+            }
+            if (count >= sizeof...(Ts))
+                payload.convertToTuple(args);
+        }
+    }
+    catch (const error::Conversion& e)
+    {
+        throw UnpackError().withArgs(e.what());
+    }
+
+    if (count < sizeof...(Ts))
+    {
+        std::ostringstream oss;
+        oss << "Expected " << sizeof...(Ts)
+            << " args, but only got " << count;
+        throw UnpackError().withArgs(oss.str());
+    }
+}
+
 } // namespace internal
 
 
@@ -308,14 +356,6 @@ EventUnpacker<S,A...>::EventUnpacker(Slot slot)
 template <typename S, typename... A>
 void EventUnpacker<S,A...>::operator()(Event event) const
 {
-    if (event.args().size() < sizeof...(A))
-    {
-        std::ostringstream oss;
-        oss << "Expected " << sizeof...(A)
-            << " args, but only got " << event.args().size();
-        throw internal::UnpackError().withArgs(oss.str());
-    }
-
     // Use the integer parameter pack technique shown in
     // http://stackoverflow.com/a/7858971/245265
     using Seq = typename internal::GenIntegerSequence<sizeof...(A)>::type;
@@ -329,15 +369,7 @@ void EventUnpacker<S,A...>::invoke(Event&& event,
                                    internal::IntegerSequence<Seq...>) const
 {
     std::tuple<ValueTypeOf<A>...> args;
-
-    try
-    {
-        event.convertToTuple(args);
-    }
-    catch (const error::Conversion& e)
-    {
-        throw internal::UnpackError().withArgs(e.what());
-    }
+    internal::unpackArgs(event, args);
 
     slot_(std::move(event), std::get<Seq>(std::move(args))...);
 }
@@ -365,14 +397,6 @@ SimpleEventUnpacker<S,A...>::SimpleEventUnpacker(Slot slot)
 template <typename S, typename... A>
 void SimpleEventUnpacker<S,A...>::operator()(Event event) const
 {
-    if (event.args().size() < sizeof...(A))
-    {
-        std::ostringstream oss;
-        oss << "Expected " << sizeof...(A)
-            << " args, but only got " << event.args().size();
-        throw internal::UnpackError().withArgs(oss.str());
-    }
-
     // Use the integer parameter pack technique shown in
     // http://stackoverflow.com/a/7858971/245265
     using Seq = typename internal::GenIntegerSequence<sizeof...(A)>::type;
@@ -386,15 +410,7 @@ void SimpleEventUnpacker<S,A...>::invoke(Event&& event,
                                          internal::IntegerSequence<Seq...>) const
 {
     std::tuple<ValueTypeOf<A>...> args;
-
-    try
-    {
-        event.convertToTuple(args);
-    }
-    catch (const error::Conversion& e)
-    {
-        throw internal::UnpackError().withArgs(e.what());
-    }
+    internal::unpackArgs(event, args);
 
     slot_(std::get<Seq>(std::move(args))...);
 }
@@ -430,14 +446,6 @@ InvocationUnpacker<S,A...>::InvocationUnpacker(Slot slot)
 template <typename S, typename... A>
 Outcome InvocationUnpacker<S,A...>::operator()(Invocation inv) const
 {
-    if (inv.args().size() < sizeof...(A))
-    {
-        std::ostringstream oss;
-        oss << "Expected " << sizeof...(A)
-            << " args, but only got " << inv.args().size();
-        throw internal::UnpackError().withArgs(oss.str());
-    }
-
     // Use the integer parameter pack technique shown in
     // http://stackoverflow.com/a/7858971/245265
     using Seq = typename internal::GenIntegerSequence<sizeof...(A)>::type;
@@ -452,15 +460,7 @@ InvocationUnpacker<S,A...>::invoke(Invocation&& inv,
                                    internal::IntegerSequence<Seq...>) const
 {
     std::tuple<ValueTypeOf<A>...> args;
-
-    try
-    {
-        inv.convertToTuple(args);
-    }
-    catch (const error::Conversion& e)
-    {
-        throw internal::UnpackError().withArgs(e.what());
-    }
+    internal::unpackArgs(inv, args);
 
     return slot_(std::move(inv), std::get<Seq>(std::move(args))...);
 }
@@ -488,14 +488,6 @@ SimpleInvocationUnpacker<S,R,A...>::SimpleInvocationUnpacker(Slot slot)
 template <typename S, typename R, typename... A>
 Outcome SimpleInvocationUnpacker<S,R,A...>::operator()(Invocation inv) const
 {
-    if (inv.args().size() < sizeof...(A))
-    {
-        std::ostringstream oss;
-        oss << "Expected " << sizeof...(A)
-            << " args, but only got " << inv.args().size();
-        throw internal::UnpackError().withArgs(oss.str());
-    }
-
     // Use the integer parameter pack technique shown in
     // http://stackoverflow.com/a/7858971/245265
     using Seq = typename internal::GenIntegerSequence<sizeof...(A)>::type;
@@ -510,15 +502,7 @@ Outcome SimpleInvocationUnpacker<S,R,A...>::invoke(
     TrueType, Invocation&& inv, internal::IntegerSequence<Seq...>) const
 {
     std::tuple<ValueTypeOf<A>...> args;
-
-    try
-    {
-        inv.convertToTuple(args);
-    }
-    catch (const error::Conversion& e)
-    {
-        throw internal::UnpackError().withArgs(e.what());
-    }
+    internal::unpackArgs(inv, args);
 
     slot_(std::get<Seq>(std::move(args))...);
     return {};
@@ -531,15 +515,7 @@ Outcome SimpleInvocationUnpacker<S,R,A...>::invoke(
     FalseType, Invocation&& inv, internal::IntegerSequence<Seq...>) const
 {
     std::tuple<ValueTypeOf<A>...> args;
-
-    try
-    {
-        inv.convertToTuple(args);
-    }
-    catch (const error::Conversion& e)
-    {
-        throw internal::UnpackError().withArgs(e.what());
-    }
+    internal::unpackArgs(inv, args);
 
     ResultType result = slot_(std::get<Seq>(std::move(args))...);
     return Result().withArgs(std::move(result));
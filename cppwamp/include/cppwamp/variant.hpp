@@ -404,6 +404,9 @@ private:
     template <typename TField, typename V>
     CPPWAMP_HIDDEN static TField& get(V&& variant);
 
+    // Blob, Array and Object are constructed in place within the union when
+    // they fit (see internal::CompositeAccess); otherwise the union holds a
+    // pointer to a heap-allocated instance.
     union Field
     {
         Field();
@@ -17,6 +17,10 @@
 #include <map>
 #include <vector>
 
+#ifdef CPPWAMP_FLAT_OBJECT
+#include "flatmap.hpp"
+#endif
+
 namespace wamp
 {
 
@@ -49,7 +53,18 @@ using UInt   = std::uint64_t;             ///< Variant bound type for unsigned i
 using Real   = double;                    ///< Variant bound type for floating-point numbers
 using String = std::string;               ///< Variant bound type for text strings
 using Array  = std::vector<Variant>;      ///< Variant bound type for arrays of variants
-using Object = std::map<String, Variant>; ///< Variant bound type for maps of variants
+
+/** Variant bound type for maps of variants.
+    This is `std::map<String, Variant>` by default, or FlatMap if
+    `CPPWAMP_FLAT_OBJECT` is defined. The latter stores small dictionaries
+    (such as WAMP options and details) with fewer allocations. The macro must
+    be defined consistently for the library and all code that uses it, which
+    the `CPPWAMP_OPT_FLAT_OBJECT` CMake option takes care of. */
+#ifdef CPPWAMP_FLAT_OBJECT
+using Object = FlatMap<String, Variant>;
+#else
+using Object = std::map<String, Variant>;
+#endif
 /// @}
 
 } // namespace wamp
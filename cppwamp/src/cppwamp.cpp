@@ -18,9 +18,12 @@
 #include <cppwamp/internal/error.ipp>
 #include <cppwamp/internal/json.ipp>
 #include <cppwamp/internal/logging.ipp>
+#include <cppwamp/internal/loopback.ipp>
+#include <cppwamp/internal/loopbackhost.ipp>
 #include <cppwamp/internal/messagetraits.ipp>
 #include <cppwamp/internal/msgpack.ipp>
 #include <cppwamp/internal/peerdata.ipp>
+#include <cppwamp/internal/rawsockoptions.ipp>
 #include <cppwamp/internal/registration.ipp>
 #include <cppwamp/internal/session.ipp>
 #include <cppwamp/internal/subscription.ipp>
@@ -28,6 +31,9 @@
 #include <cppwamp/internal/tcpendpoint.ipp>
 #include <cppwamp/internal/tcphost.ipp>
 #include <cppwamp/internal/tcpprotocol.ipp>
+#include <cppwamp/internal/tcpresolvercache.ipp>
+#include <cppwamp/internal/typeddecoding.ipp>
+#include <cppwamp/internal/typedencoding.ipp>
 #include <cppwamp/internal/variant.ipp>
 #include <cppwamp/internal/version.ipp>
 
@@ -0,0 +1,235 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cppwamp/internal/base64.hpp>
+
+using namespace wamp;
+using namespace wamp::internal;
+
+namespace
+{
+
+using Bytes = std::vector<uint8_t>;
+
+//------------------------------------------------------------------------------
+std::vector<Base64Simd> supportedKernels()
+{
+    std::vector<Base64Simd> kernels{Base64Simd::none};
+    auto best = Base64Kernels::detect();
+    if (best != Base64Simd::none)
+        kernels.push_back(Base64Simd::ssse3);
+    if (best == Base64Simd::avx2)
+        kernels.push_back(Base64Simd::avx2);
+    return kernels;
+}
+
+//------------------------------------------------------------------------------
+const char* kernelName(Base64Simd simd)
+{
+    switch (simd)
+    {
+    case Base64Simd::ssse3: return "SSSE3";
+    case Base64Simd::avx2:  return "AVX2";
+    default: break;
+    }
+    return "scalar";
+}
+
+//------------------------------------------------------------------------------
+Bytes randomBytes(std::size_t size, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(0, 255);
+    Bytes bytes(size);
+    for (auto& b: bytes)
+        b = static_cast<uint8_t>(dist(rng));
+    return bytes;
+}
+
+//------------------------------------------------------------------------------
+std::string encode(const Bytes& bytes, Base64Simd simd)
+{
+    std::string text;
+    Base64::encode(bytes.data(), bytes.size(), text, simd);
+    return text;
+}
+
+//------------------------------------------------------------------------------
+std::error_code decode(const std::string& text, Bytes& bytes,
+                       Base64Simd simd)
+{
+    bytes.clear();
+    return Base64::decode(text.data(), text.size(), bytes, simd);
+}
+
+//------------------------------------------------------------------------------
+// Repeats the given operation for at least a fixed duration, and returns the
+// mean throughput in megabytes (10^6 bytes) of input per second.
+//------------------------------------------------------------------------------
+template <typename F>
+double measureMBps(std::size_t inputSize, F&& operation)
+{
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+    const auto minDuration = std::chrono::milliseconds(500);
+
+    std::size_t iterations = 0;
+    std::size_t checksum = 0; // Prevents the work being optimized away
+    auto start = Clock::now();
+    Clock::duration elapsed;
+    do
+    {
+        checksum += operation();
+        ++iterations;
+        elapsed = Clock::now() - start;
+    }
+    while (elapsed < minDuration);
+
+    CHECK( checksum != 0 );
+    double meanSeconds = Seconds(elapsed).count() / iterations;
+    return inputSize / meanSeconds / 1e6;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "Base64 encoding and decoding", "[Base64]" )
+{
+    for (auto simd: supportedKernels())
+    {
+        INFO( "Using " << kernelName(simd) << " kernels" );
+
+        WHEN( "using the RFC 4648 test vectors" )
+        {
+            const std::vector<std::pair<std::string, std::string>> vectors =
+            {
+                {"",       ""},
+                {"f",      "Zg=="},
+                {"fo",     "Zm8="},
+                {"foo",    "Zm9v"},
+                {"foob",   "Zm9vYg=="},
+                {"fooba",  "Zm9vYmE="},
+                {"foobar", "Zm9vYmFy"}
+            };
+
+            for (const auto& vec: vectors)
+            {
+                Bytes bytes(vec.first.begin(), vec.first.end());
+                CHECK( encode(bytes, simd) == vec.second );
+                Bytes decoded;
+                CHECK( !decode(vec.second, decoded, simd) );
+                CHECK( decoded == bytes );
+            }
+        }
+
+        WHEN( "round-tripping random data of every length up to 300 bytes" )
+        {
+            for (std::size_t size=0; size<=300; ++size)
+            {
+                INFO( "For size " << size );
+                auto bytes = randomBytes(size, static_cast<unsigned>(size));
+                auto text = encode(bytes, simd);
+                CHECK( text == encode(bytes, Base64Simd::none) );
+                Bytes decoded;
+                CHECK( !decode(text, decoded, simd) );
+                CHECK( decoded == bytes );
+            }
+        }
+
+        WHEN( "round-tripping data spanning several chunks" )
+        {
+            auto bytes = randomBytes(100000, 42);
+            auto text = encode(bytes, simd);
+            CHECK( text == encode(bytes, Base64Simd::none) );
+            Bytes decoded;
+            CHECK( !decode(text, decoded, simd) );
+            CHECK( decoded == bytes );
+        }
+
+        WHEN( "decoding invalid characters anywhere within long input" )
+        {
+            auto text = encode(randomBytes(3000, 7), Base64Simd::none);
+            for (std::size_t pos: {0, 5, 15, 16, 31, 32, 63, 1024, 3995})
+            {
+                INFO( "At position " << pos );
+                for (char c: {'\0', '-', '_', ' ', '\x80', '\xff', '@', '['})
+                {
+                    auto bad = text;
+                    bad[pos] = c;
+                    Bytes decoded;
+                    CHECK( decode(bad, decoded, simd) ==
+                           DecodingErrc::badBase64Char );
+                }
+
+                auto padded = text;
+                padded[pos] = '=';
+                Bytes decoded;
+                CHECK( decode(padded, decoded, simd) ==
+                       DecodingErrc::badBase64Padding );
+            }
+        }
+
+        WHEN( "decoding input with a bad length or padding" )
+        {
+            Bytes decoded;
+            CHECK( decode("Zm9vYmF", decoded, simd) ==
+                   DecodingErrc::badBase64Length );
+            CHECK( decode("Zm9v=mFy", decoded, simd) ==
+                   DecodingErrc::badBase64Padding );
+            CHECK( decode("Zm9vY=Fy", decoded, simd) ==
+                   DecodingErrc::badBase64Padding );
+            CHECK( decode("Zm9vYm=y", decoded, simd) ==
+                   DecodingErrc::badBase64Padding );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Base64 throughput", "[Base64][.benchmark]" )
+{
+    const std::size_t size = 1024 * 1024;
+    auto bytes = randomBytes(size, 123);
+    auto text = encode(bytes, Base64Simd::none);
+
+    for (auto simd: supportedKernels())
+    {
+        std::string name = kernelName(simd);
+
+        BENCHMARK( name + " encode 1 MiB" )
+        {
+            return encode(bytes, simd);
+        };
+
+        BENCHMARK( name + " decode 1 MiB" )
+        {
+            Bytes decoded;
+            return decode(text, decoded, simd);
+        };
+
+        auto encodeMBps = measureMBps(bytes.size(), [&]()
+        {
+            return encode(bytes, simd).size();
+        });
+
+        auto decodeMBps = measureMBps(text.size(), [&]()
+        {
+            Bytes decoded;
+            auto ec = decode(text, decoded, simd);
+            return ec ? 0 : decoded.size();
+        });
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << name << " encode: " << encodeMBps << " MB/s, "
+                  << "decode: " << decodeMBps << " MB/s" << std::endl;
+    }
+}
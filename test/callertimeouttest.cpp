@@ -0,0 +1,200 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <boost/asio/strand.hpp>
+#include <catch2/catch.hpp>
+#include <cppwamp/internal/callertimeout.hpp>
+
+using namespace wamp;
+using namespace wamp::internal;
+
+namespace
+{
+
+using Record = CallerTimeoutRecord;
+
+//------------------------------------------------------------------------------
+Record makeRecord(int ms, RequestId rid)
+{
+    Record rec;
+    rec.deadline = Record::Timepoint(std::chrono::milliseconds(ms));
+    rec.requestId = rid;
+    return rec;
+}
+
+//------------------------------------------------------------------------------
+std::vector<RequestId> drain(CallerTimeoutHeap& heap)
+{
+    std::vector<RequestId> ids;
+    auto last = Record::Timepoint::min();
+    while (!heap.empty())
+    {
+        CHECK( heap.top().deadline >= last );
+        last = heap.top().deadline;
+        ids.push_back(heap.top().requestId);
+        heap.pop();
+    }
+    return ids;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "Caller timeout heap operations", "[CallerTimeout]" )
+{
+GIVEN( "an empty heap" )
+{
+    CallerTimeoutHeap heap;
+    CHECK( heap.empty() );
+    CHECK( heap.size() == 0 );
+    CHECK_FALSE( heap.erase(1) );
+
+    WHEN( "pushing records out of order" )
+    {
+        heap.push(makeRecord(30, 1));
+        heap.push(makeRecord(10, 2));
+        heap.push(makeRecord(20, 3));
+        heap.push(makeRecord(10, 4));
+
+        THEN( "they are popped in deadline order" )
+        {
+            CHECK( heap.size() == 4 );
+            CHECK( heap.contains(3) );
+            auto ids = drain(heap);
+            REQUIRE( ids.size() == 4 );
+            CHECK( ids[2] == 3 );
+            CHECK( ids[3] == 1 );
+            CHECK( heap.empty() );
+        }
+
+        THEN( "records can be erased by request ID" )
+        {
+            CHECK( heap.erase(2) );
+            CHECK( heap.erase(1) );
+            CHECK_FALSE( heap.erase(1) );
+            CHECK_FALSE( heap.contains(1) );
+            CHECK( drain(heap) == (std::vector<RequestId>{4, 3}) );
+        }
+
+        THEN( "pushing an existing request ID replaces its record" )
+        {
+            heap.push(makeRecord(5, 1));
+            CHECK( heap.size() == 4 );
+            CHECK( heap.top().requestId == 1 );
+        }
+
+        THEN( "the heap can be cleared" )
+        {
+            heap.clear();
+            CHECK( heap.empty() );
+            CHECK_FALSE( heap.contains(2) );
+        }
+    }
+
+    WHEN( "randomly interleaving pushes and erasures" )
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> deadline(0, 1000);
+        std::vector<RequestId> live;
+        for (RequestId rid=1; rid<=2000; ++rid)
+        {
+            heap.push(makeRecord(deadline(rng), rid));
+            live.push_back(rid);
+            if (rid % 3 == 0)
+            {
+                std::uniform_int_distribution<std::size_t> pick(
+                    0, live.size() - 1);
+                auto pos = pick(rng);
+                CHECK( heap.erase(live[pos]) );
+                live.erase(live.begin() + pos);
+            }
+        }
+
+        THEN( "the remaining records are popped in deadline order" )
+        {
+            CHECK( heap.size() == live.size() );
+            auto ids = drain(heap);
+            std::sort(ids.begin(), ids.end());
+            CHECK( ids == live );
+        }
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Caller timeout scheduling", "[CallerTimeout]" )
+{
+    using std::chrono::milliseconds;
+
+    IoContext ioctx;
+    auto scheduler = CallerTimeoutScheduler::create(
+        boost::asio::make_strand(ioctx.get_executor()));
+    std::vector<RequestId> expired;
+    scheduler->listen([&](RequestId rid) {expired.push_back(rid);});
+
+    WHEN( "adding deadlines out of order" )
+    {
+        scheduler->add(milliseconds(30), 1);
+        scheduler->add(milliseconds(10), 2);
+        scheduler->add(milliseconds(20), 3);
+        ioctx.run();
+
+        THEN( "the handler is invoked in deadline order" )
+        {
+            CHECK( expired == (std::vector<RequestId>{2, 3, 1}) );
+            CHECK( scheduler->size() == 0 );
+        }
+    }
+
+    WHEN( "removing pending deadlines, including the earliest one" )
+    {
+        scheduler->add(milliseconds(10), 1);
+        scheduler->add(milliseconds(20), 2);
+        scheduler->add(milliseconds(30), 3);
+        scheduler->remove(1);
+        scheduler->remove(3);
+        scheduler->remove(4);
+        CHECK( scheduler->size() == 1 );
+        ioctx.run();
+
+        THEN( "only the remaining deadline expires" )
+        {
+            CHECK( expired == std::vector<RequestId>{2} );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Caller timeout add/remove churn", "[CallerTimeout][.benchmark]" )
+{
+    // Keeps a sliding window of timed calls outstanding, where the oldest
+    // call completes each time a new one is issued.
+    const std::size_t inFlight = 50000;
+    const std::size_t rounds = 100000;
+    const auto timeout = std::chrono::seconds(60);
+
+    IoContext ioctx;
+    auto scheduler = CallerTimeoutScheduler::create(
+        boost::asio::make_strand(ioctx.get_executor()));
+
+    BENCHMARK( "50000 in flight" )
+    {
+        RequestId rid = 0;
+        for (std::size_t i=0; i<inFlight; ++i)
+            scheduler->add(timeout, ++rid);
+        for (std::size_t i=0; i<rounds; ++i)
+        {
+            scheduler->remove(rid - inFlight + 1);
+            scheduler->add(timeout, ++rid);
+        }
+        scheduler->clear();
+        return rid;
+    };
+}
@@ -9,6 +9,7 @@
 #include <catch2/catch.hpp>
 #include <cppwamp/variant.hpp>
 #include <cppwamp/cbor.hpp>
+#include <cppwamp/internal/encodedsize.hpp>
 
 using namespace wamp;
 
@@ -26,6 +27,7 @@ void checkCbor(CborBufferEncoder& encoder, CborBufferDecoder& decoder,
     {
         MessageBuffer buffer;
         encoder.encode(v, buffer);
+        CHECK_FALSE( internal::encodedSizeExceeds(v, buffer.size()) );
         Variant w;
         auto ec = decoder.decode(buffer, w);
         CHECK( !ec );
@@ -250,3 +252,63 @@ SCENARIO( "CBOR typed array", "[Variant][Codec][Cbor]" )
     CHECK( a[2] == 35243 );
     CHECK( a[3] == 52719 );
 }
+
+//------------------------------------------------------------------------------
+SCENARIO( "CBOR header-only decoding", "[Variant][Codec][Cbor]" )
+{
+GIVEN( "a RESULT message with positional and keyword arguments" )
+{
+    Array args{1, "two", Array{3}};
+    Object kwargs{{"k", Object{{"n", null}}}};
+    Variant message{Array{50, 123, Object{{"progress", true}}, args, kwargs}};
+    MessageBuffer buffer;
+    CborBufferEncoder encoder;
+    encoder.encode(message, buffer);
+
+    WHEN( "decoding only its header" )
+    {
+        CborBufferDecoder decoder;
+        Variant v;
+        bool skipped = false;
+        auto ec = decoder.decodeHeader(buffer, v, skipped);
+        CHECK( !ec );
+
+        THEN( "the payload is replaced with empty placeholders" )
+        {
+            CHECK( skipped );
+            CHECK( v == (Array{50, 123, Object{{"progress", true}},
+                               Array{}, Object{}}) );
+        }
+
+        THEN( "the same decoder can afterwards fully decode it" )
+        {
+            ec = decoder.decode(buffer, v);
+            CHECK( !ec );
+            CHECK( v == message );
+        }
+    }
+}
+
+GIVEN( "a RESULT message without arguments" )
+{
+    Variant message{Array{50, 123, Object{{"progress", true}}}};
+    MessageBuffer buffer;
+    CborBufferEncoder encoder;
+    encoder.encode(message, buffer);
+
+    WHEN( "decoding only its header" )
+    {
+        CborBufferDecoder decoder;
+        Variant v;
+        bool skipped = true;
+        auto ec = decoder.decodeHeader(buffer, v, skipped);
+
+        THEN( "the message is decoded in full" )
+        {
+            CHECK( !ec );
+            CHECK_FALSE( skipped );
+            CHECK( v == message );
+        }
+    }
+}
+}
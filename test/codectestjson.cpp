@@ -7,9 +7,12 @@
 #include <cmath>
 #include <limits>
 #include <sstream>
+#include <thread>
 #include <catch2/catch.hpp>
 #include <cppwamp/variant.hpp>
 #include <cppwamp/json.hpp>
+#include <cppwamp/internal/encodedsize.hpp>
+#include <cppwamp/internal/wampmessage.hpp>
 
 using namespace wamp;
 namespace Matchers = Catch::Matchers;
@@ -36,6 +39,7 @@ void checkJson(JsonStringEncoder& encoder, JsonStringDecoder& decoder,
         encoder.encode(v, str);
         CHECK( v == expected );
         CHECK( str == serialized );
+        CHECK_FALSE( internal::encodedSizeExceeds(v, str.size()) );
 
         std::ostringstream oss;
         encode<Json>(v, oss);
@@ -366,3 +370,367 @@ GIVEN( "a string Variant with multi-byte UTF-8 characters" )
     }
 }
 }
+
+//------------------------------------------------------------------------------
+SCENARIO( "JSON decoding of a large array followed by a small one",
+          "[Variant][Codec][JSON]" )
+{
+    // Builds [[0,1,...],[[...]]] with deeply nested arrays, so that scratch
+    // storage is used at many depths.
+    const std::size_t largeSize = 100000;
+    const unsigned depth = 20;
+    Array largeElements;
+    largeElements.reserve(largeSize);
+    for (std::size_t i=0; i<largeSize; ++i)
+        largeElements.emplace_back(i);
+    Variant nested{Array{}};
+    for (unsigned i=0; i<depth; ++i)
+        nested = Array{nested, Int(i)};
+    Variant large{Array{largeElements, nested}};
+    Variant small{Array{1, Array{"two"}, Object{{"three", Array{3}}}}};
+
+    std::string largeText;
+    std::string smallText;
+    encode<Json>(large, largeText);
+    encode<Json>(small, smallText);
+
+    GIVEN( "a reused decoder" )
+    {
+        JsonStringDecoder decoder;
+        Variant v;
+        REQUIRE( !decoder.decode(largeText, v) );
+        CHECK( v == large );
+        REQUIRE( !decoder.decode(smallText, v) );
+        CHECK( v == small );
+        REQUIRE( !decoder.decode(largeText, v) );
+        CHECK( v == large );
+    }
+
+    GIVEN( "a pooled codec" )
+    {
+        auto codec = AnyBufferCodec::pooled(json);
+        MessageBuffer largeBuffer(largeText.begin(), largeText.end());
+        MessageBuffer smallBuffer(smallText.begin(), smallText.end());
+        Variant v;
+        REQUIRE( !codec.decode(largeBuffer, v) );
+        CHECK( v == large );
+        REQUIRE( !codec.decode(smallBuffer, v) );
+        CHECK( v == small );
+    }
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "JSON header-only decoding", "[Variant][Codec][JSON]" )
+{
+    using namespace wamp::internal;
+
+GIVEN( "a RESULT message with positional and keyword arguments" )
+{
+    std::string text =
+        R"([50,123,{"progress":true},[1,"two",[3]],{"k":{"n":null}}])";
+    MessageBuffer buffer(text.begin(), text.end());
+    Array args{1, "two", Array{3}};
+    Object kwargs{{"k", Object{{"n", null}}}};
+
+    WHEN( "decoding only its header" )
+    {
+        JsonBufferDecoder decoder;
+        Variant v;
+        bool skipped = false;
+        auto ec = decoder.decodeHeader(buffer, v, skipped);
+        CHECK( !ec );
+
+        THEN( "the payload is replaced with empty placeholders" )
+        {
+            CHECK( skipped );
+            CHECK( v == (Array{50, 123, Object{{"progress", true}},
+                               Array{}, Object{}}) );
+        }
+
+        THEN( "the same decoder can afterwards fully decode it" )
+        {
+            ec = decoder.decode(buffer, v);
+            CHECK( !ec );
+            CHECK( v == (Array{50, 123, Object{{"progress", true}},
+                               args, kwargs}) );
+        }
+    }
+
+    WHEN( "parsing the header with its payload left to be decoded lazily" )
+    {
+        AnyBufferCodec codec{json};
+        Variant v;
+        bool skipped = false;
+        REQUIRE( !codec.decodeHeader(buffer, v, skipped) );
+        REQUIRE( skipped );
+        auto parsed = WampMessage::parse(std::move(v.as<Array>()));
+        REQUIRE( parsed.has_value() );
+        auto& msg = message_cast<ResultMessage>(*parsed);
+        msg.setLazyPayload(std::make_shared<LazyPayload>(
+            buffer, codec, KnownCodecIds::json(), msg.payloadPosition(), 2));
+        CHECK( msg.hasLazyPayload() );
+        CHECK( msg.requestId() == 123 );
+
+        THEN( "the payload position is that of the positional arguments" )
+        {
+            CHECK( msg.payloadPosition() == 3 );
+        }
+
+        THEN( "the payload is decoded upon being read" )
+        {
+            const auto& constMsg = msg;
+            CHECK( constMsg.args() == args );
+            CHECK( constMsg.kwargs() == kwargs );
+            CHECK( constMsg.args().at(1) == "two" );
+            CHECK( constMsg.kwargs().at("k") == (Object{{"n", null}}) );
+            CHECK( msg.hasLazyPayload() );
+            CHECK( msg.fields().at(3) == Array{} );
+            CHECK( msg.fields().at(4) == Object{} );
+        }
+
+        THEN( "the payload is merged into the message upon being modified" )
+        {
+            auto copy = msg;
+            msg.args().push_back(4);
+            CHECK_FALSE( msg.hasLazyPayload() );
+            CHECK( msg.fields().at(0) == 50 );
+            CHECK( msg.fields().at(1) == 123 );
+            CHECK( msg.fields().at(2) == (Object{{"progress", true}}) );
+            CHECK( msg.fields().at(3) == (Array{1, "two", Array{3}, 4}) );
+            CHECK( msg.fields().at(4) == kwargs );
+            CHECK( msg.kwargs() == kwargs );
+            CHECK( copy.hasLazyPayload() );
+            CHECK( static_cast<const ResultMessage&>(copy).args() == args );
+        }
+
+        THEN( "the payload is merged into the message upon modifying "
+              "keyword arguments" )
+        {
+            msg.kwargs().emplace("x", 42);
+            CHECK_FALSE( msg.hasLazyPayload() );
+            CHECK( msg.fields().at(3) == args );
+            CHECK( msg.fields().at(4) ==
+                   (Object{{"k", Object{{"n", null}}}, {"x", 42}}) );
+        }
+    }
+}
+
+GIVEN( "a RESULT message whose payload is malformed" )
+{
+    std::string text = R"([50,123,{},[1,"two"],{"k":})";
+    MessageBuffer buffer(text.begin(), text.end());
+    AnyBufferCodec codec{json};
+    LazyPayload payload(buffer, codec, KnownCodecIds::json(), 3, 2);
+
+    WHEN( "accessing the payload" )
+    {
+        const auto& args = payload.args();
+        const auto& kwargs = payload.kwargs();
+
+        THEN( "the decoding error is reported" )
+        {
+            CHECK( args.empty() );
+            CHECK( kwargs.empty() );
+            CHECK( payload.fields().empty() );
+            CHECK( payload.error() == DecodingErrc::failure );
+        }
+    }
+}
+
+GIVEN( "an EVENT message with positional and keyword arguments" )
+{
+    std::string text = R"([36,1,2,{},["a"],{"b":true}])";
+    MessageBuffer buffer(text.begin(), text.end());
+
+    WHEN( "parsing the header with its payload left to be decoded lazily" )
+    {
+        AnyBufferCodec codec{json};
+        Variant v;
+        bool skipped = false;
+        REQUIRE( !codec.decodeHeader(buffer, v, skipped) );
+        REQUIRE( skipped );
+        auto parsed = WampMessage::parse(std::move(v.as<Array>()));
+        REQUIRE( parsed.has_value() );
+        auto& msg = message_cast<EventMessage>(*parsed);
+        CHECK( msg.payloadPosition() == 4 );
+        msg.setLazyPayload(std::make_shared<LazyPayload>(
+            buffer, codec, KnownCodecIds::json(), msg.payloadPosition(), 2));
+
+        THEN( "the payload is decoded from the correct positions" )
+        {
+            const auto& constMsg = msg;
+            CHECK( constMsg.args() == Array{"a"} );
+            CHECK( constMsg.kwargs() == (Object{{"b", true}}) );
+            msg.args().push_back("c");
+            CHECK( msg.fields().at(3) == Object{} );
+            CHECK( msg.fields().at(4) == (Array{"a", "c"}) );
+            CHECK( msg.fields().at(5) == (Object{{"b", true}}) );
+        }
+    }
+}
+
+GIVEN( "a message without a payload" )
+{
+    std::string text = R"([50,123,{}])";
+    MessageBuffer buffer(text.begin(), text.end());
+
+    WHEN( "decoding only its header" )
+    {
+        JsonBufferDecoder decoder;
+        Variant v;
+        bool skipped = true;
+        auto ec = decoder.decodeHeader(buffer, v, skipped);
+        CHECK( !ec );
+
+        THEN( "the whole message is decoded and nothing is skipped" )
+        {
+            CHECK_FALSE( skipped );
+            CHECK( v == (Array{50, 123, Object{}}) );
+        }
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "JSON stream decoding", "[Variant][Codec][JSON]" )
+{
+GIVEN( "a JSON document spanning several stream chunks" )
+{
+    // Elements of varying lengths ensure that tokens straddle the boundaries
+    // of the chunks in which the stream is parsed.
+    Array array;
+    for (int i=0; i<3000; ++i)
+    {
+        array.push_back(std::string(i % 13, 'a' + (i % 26)) + "\"\\");
+        array.push_back(i * 1000003);
+        array.push_back(Object{{"k" + std::to_string(i), i % 2 == 0}});
+    }
+    array.push_back(std::string(20000, 'z'));
+    Variant expected(array);
+
+    std::string json;
+    encode<Json>(expected, json);
+    REQUIRE( json.size() > 16 * 4096 );
+
+    WHEN( "decoding it from a stream" )
+    {
+        Variant v;
+        std::istringstream iss(json);
+        auto ec = decode<Json>(iss, v);
+
+        THEN( "the decoded Variant matches the original" )
+        {
+            CHECK( !ec );
+            CHECK( v == expected );
+        }
+    }
+
+    WHEN( "decoding a truncated version of it from a stream" )
+    {
+        Variant v;
+        std::istringstream iss(json.substr(0, json.size() - 4097));
+        auto ec = decode<Json>(iss, v);
+
+        THEN( "an error is reported" )
+        {
+            CHECK( ec == DecodingErrc::failure );
+        }
+    }
+
+    WHEN( "decoding it after another document from the same decoder" )
+    {
+        JsonStreamDecoder decoder;
+        Variant v;
+        std::istringstream first("[1, 2, \"three\"]");
+        auto ec = decoder.decode(first, v);
+        REQUIRE( !ec );
+        REQUIRE( v == (Array{1, 2, "three"}) );
+
+        std::istringstream second(json);
+        ec = decoder.decode(second, v);
+
+        THEN( "the decoded Variant matches the original" )
+        {
+            CHECK( !ec );
+            CHECK( v == expected );
+        }
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "JSON pooled codecs", "[Variant][Codec][JSON]" )
+{
+GIVEN( "two pooled codecs on the same thread" )
+{
+    using Pool = CodecPool<Json, BufferSink, BufferSource>;
+    Pool::resetStats();
+    auto a = AnyBufferCodec::pooled(json);
+    auto b = AnyBufferCodec::pooled(json);
+    Variant original{Array{1, "two", Object{{"three", 3.0}}}};
+    std::string text = R"([1,"two",{"three":3.0}])";
+
+    WHEN( "encoding and decoding with both" )
+    {
+        MessageBuffer first;
+        MessageBuffer second{'x'};
+        a.encode(original, first);
+        b.encode(original, second);
+        Variant v;
+        REQUIRE( !a.decode(first, v) );
+        CHECK( v == original );
+        bool skipped = false;
+        REQUIRE( !b.clone().decodeHeader(first, v, skipped) );
+        CHECK( v == original );
+
+        THEN( "they share the same thread-local statistics" )
+        {
+            CHECK( std::string(first.begin(), first.end()) == text );
+            auto stats = Pool::stats();
+            CHECK( stats.encodeCount == 2 );
+            CHECK( stats.decodeCount == 2 );
+            CHECK( stats.encodedBytesHighWater == text.size() );
+            CHECK( stats.decodedBytesHighWater == text.size() );
+        }
+
+        THEN( "other threads have their own statistics" )
+        {
+            CodecPoolStats stats;
+            std::thread t([&stats]() {stats = Pool::stats();});
+            t.join();
+            CHECK( stats.encodeCount == 0 );
+            CHECK( stats.decodeCount == 0 );
+        }
+
+        THEN( "the statistics can be reset" )
+        {
+            Pool::resetStats();
+            CHECK( Pool::stats().encodeCount == 0 );
+            CHECK( Pool::stats().encodedBytesHighWater == 0 );
+        }
+    }
+}
+
+GIVEN( "a codec builder with pooling enabled" )
+{
+    BufferCodecBuilder builder{json};
+    CHECK_FALSE( builder.pooling() );
+    builder.withPooling();
+    CHECK( builder.pooling() );
+
+    WHEN( "building a codec" )
+    {
+        using Pool = CodecPool<Json, BufferSink, BufferSource>;
+        Pool::resetStats();
+        auto codec = builder();
+        MessageBuffer buffer;
+        codec.encode(Variant{42}, buffer);
+
+        THEN( "the codec uses the thread's pool" )
+        {
+            CHECK( std::string(buffer.begin(), buffer.end()) == "42" );
+            CHECK( Pool::stats().encodeCount == 1 );
+        }
+    }
+}
+}
@@ -8,6 +8,7 @@
 #include <catch2/catch.hpp>
 #include <cppwamp/variant.hpp>
 #include <cppwamp/msgpack.hpp>
+#include <cppwamp/internal/encodedsize.hpp>
 
 using namespace wamp;
 
@@ -25,6 +26,7 @@ void checkMsgpack(MsgpackBufferEncoder& encoder, MsgpackBufferDecoder& decoder,
     {
         MessageBuffer buffer;
         encoder.encode(v, buffer);
+        CHECK_FALSE( internal::encodedSizeExceeds(v, buffer.size()) );
         Variant w;
         auto ec = decoder.decode(buffer, w);
         CHECK( !ec );
@@ -225,3 +227,63 @@ GIVEN( "a Msgpack message with a non-string key" )
 }
 
 }
+
+//------------------------------------------------------------------------------
+SCENARIO( "Msgpack header-only decoding", "[Variant][Codec][Msgpack]" )
+{
+GIVEN( "a RESULT message with positional and keyword arguments" )
+{
+    Array args{1, "two", Array{3}};
+    Object kwargs{{"k", Object{{"n", null}}}};
+    Variant message{Array{50, 123, Object{{"progress", true}}, args, kwargs}};
+    MessageBuffer buffer;
+    MsgpackBufferEncoder encoder;
+    encoder.encode(message, buffer);
+
+    WHEN( "decoding only its header" )
+    {
+        MsgpackBufferDecoder decoder;
+        Variant v;
+        bool skipped = false;
+        auto ec = decoder.decodeHeader(buffer, v, skipped);
+        CHECK( !ec );
+
+        THEN( "the payload is replaced with empty placeholders" )
+        {
+            CHECK( skipped );
+            CHECK( v == (Array{50, 123, Object{{"progress", true}},
+                               Array{}, Object{}}) );
+        }
+
+        THEN( "the same decoder can afterwards fully decode it" )
+        {
+            ec = decoder.decode(buffer, v);
+            CHECK( !ec );
+            CHECK( v == message );
+        }
+    }
+}
+
+GIVEN( "a RESULT message without arguments" )
+{
+    Variant message{Array{50, 123, Object{{"progress", true}}}};
+    MessageBuffer buffer;
+    MsgpackBufferEncoder encoder;
+    encoder.encode(message, buffer);
+
+    WHEN( "decoding only its header" )
+    {
+        MsgpackBufferDecoder decoder;
+        Variant v;
+        bool skipped = true;
+        auto ec = decoder.decodeHeader(buffer, v, skipped);
+
+        THEN( "the message is decoded in full" )
+        {
+            CHECK( !ec );
+            CHECK_FALSE( skipped );
+            CHECK( v == message );
+        }
+    }
+}
+}
@@ -0,0 +1,226 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cppwamp/asiodefs.hpp>
+#include <cppwamp/error.hpp>
+#include <cppwamp/internal/connectionrace.hpp>
+
+using namespace wamp;
+using internal::ConnectionRace;
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+struct MockTransport : public Transporting
+{
+    using Transporting::send;
+
+    TransportInfo info() const override {return {};}
+    bool isStarted() const override {return false;}
+    void start(RxHandler, TxErrorHandler) override {}
+    void send(MessageBuffer) override {}
+    void close() override {closed = true;}
+    void ping(MessageBuffer, PingHandler) override {}
+
+    bool closed = false;
+};
+
+//------------------------------------------------------------------------------
+struct MockConnector : public Connecting
+{
+    using Ptr = std::shared_ptr<MockConnector>;
+
+    void establish(Handler&& h) override
+    {
+        started = true;
+        handler = std::move(h);
+    }
+
+    void cancel() override
+    {
+        cancelled = true;
+        fail(TransportErrc::aborted);
+    }
+
+    std::shared_ptr<MockTransport> succeed()
+    {
+        auto transport = std::make_shared<MockTransport>();
+        auto h = std::move(handler);
+        handler = nullptr;
+        if (h)
+            h(Transporting::Ptr(transport));
+        return transport;
+    }
+
+    template <typename TErrc>
+    void fail(TErrc errc)
+    {
+        auto h = std::move(handler);
+        handler = nullptr;
+        if (h)
+            h(makeUnexpectedError(errc));
+    }
+
+    Handler handler;
+    bool started = false;
+    bool cancelled = false;
+};
+
+//------------------------------------------------------------------------------
+struct RaceFixture
+{
+    explicit RaceFixture(ConnectionRace::Duration stagger,
+                         std::size_t count = 3)
+    {
+        ConnectionRace::Connectors connectors;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            mocks.push_back(std::make_shared<MockConnector>());
+            connectors.push_back(mocks.back());
+        }
+        race = ConnectionRace::create(IoStrand{ioctx.get_executor()},
+                                      std::move(connectors), stagger);
+        race->start(
+            [this](ErrorOr<Transporting::Ptr> t, std::size_t i)
+            {
+                ++completions;
+                result = std::move(t);
+                index = i;
+            });
+    }
+
+    void runUntilStarted(std::size_t n)
+    {
+        for (int i = 0; i < 100 && race->startedCount() < n; ++i)
+        {
+            ioctx.restart();
+            ioctx.run_one_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    IoContext ioctx;
+    std::vector<MockConnector::Ptr> mocks;
+    ConnectionRace::Ptr race;
+    ErrorOr<Transporting::Ptr> result;
+    std::size_t index = 0;
+    int completions = 0;
+};
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "Racing connection attempts", "[ConnectionRace]" )
+{
+GIVEN( "a race with a long stagger delay" )
+{
+    RaceFixture f(std::chrono::hours(1));
+    CHECK( f.race->startedCount() == 1 );
+    CHECK( f.mocks[0]->started );
+    CHECK_FALSE( f.mocks[1]->started );
+
+    WHEN( "the first attempt fails" )
+    {
+        f.mocks[0]->fail(std::errc::connection_refused);
+
+        THEN( "the next attempt starts without waiting" )
+        {
+            CHECK( f.race->startedCount() == 2 );
+            CHECK( f.mocks[1]->started );
+            CHECK( f.completions == 0 );
+        }
+
+        AND_WHEN( "the next attempt succeeds" )
+        {
+            auto transport = f.mocks[1]->succeed();
+
+            THEN( "its transport wins" )
+            {
+                CHECK( f.completions == 1 );
+                REQUIRE( f.result.has_value() );
+                CHECK( f.result.value() == transport );
+                CHECK( f.index == 1 );
+                CHECK_FALSE( transport->closed );
+                CHECK_FALSE( f.mocks[0]->cancelled );
+                CHECK_FALSE( f.mocks[2]->started );
+            }
+        }
+    }
+
+    WHEN( "all attempts fail" )
+    {
+        f.mocks[0]->fail(std::errc::connection_refused);
+        f.mocks[1]->fail(std::errc::timed_out);
+        f.mocks[2]->fail(std::errc::connection_refused);
+
+        THEN( "the race fails" )
+        {
+            CHECK( f.completions == 1 );
+            CHECK( f.result == makeUnexpectedError(
+                                   SessionErrc::allTransportsFailed) );
+        }
+    }
+
+    WHEN( "the race is cancelled" )
+    {
+        f.race->cancel();
+
+        THEN( "pending attempts are cancelled" )
+        {
+            CHECK( f.completions == 1 );
+            CHECK( f.result == makeUnexpectedError(TransportErrc::aborted) );
+            CHECK( f.mocks[0]->cancelled );
+            CHECK_FALSE( f.mocks[1]->started );
+        }
+    }
+}
+
+GIVEN( "a race with a short stagger delay" )
+{
+    RaceFixture f(std::chrono::milliseconds(1));
+    f.runUntilStarted(3);
+    REQUIRE( f.race->startedCount() == 3 );
+
+    WHEN( "the last attempt succeeds first" )
+    {
+        auto winner = f.mocks[2]->succeed();
+
+        THEN( "the other attempts are cancelled" )
+        {
+            CHECK( f.completions == 1 );
+            REQUIRE( f.result.has_value() );
+            CHECK( f.result.value() == winner );
+            CHECK( f.index == 2 );
+            CHECK( f.mocks[0]->cancelled );
+            CHECK( f.mocks[1]->cancelled );
+            CHECK_FALSE( f.mocks[2]->cancelled );
+        }
+    }
+
+    WHEN( "a losing attempt establishes a transport anyway" )
+    {
+        f.mocks[1]->cancelled = true; // Prevent the mock from failing
+        auto handler = std::move(f.mocks[1]->handler);
+        f.mocks[1]->handler = nullptr;
+        auto winner = f.mocks[0]->succeed();
+        auto loser = std::make_shared<MockTransport>();
+        handler(Transporting::Ptr(loser));
+
+        THEN( "the losing transport is closed" )
+        {
+            CHECK( f.completions == 1 );
+            CHECK( f.index == 0 );
+            CHECK_FALSE( winner->closed );
+            CHECK( loser->closed );
+        }
+    }
+}
+}
@@ -0,0 +1,251 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/asio/post.hpp>
+#include <catch2/catch.hpp>
+#include <cppwamp/connector.hpp>
+#include <cppwamp/json.hpp>
+#include <cppwamp/session.hpp>
+#include <cppwamp/transport.hpp>
+
+using namespace wamp;
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Transport standing in for a router, which welcomes the session and
+// acknowledges its subscriptions with random IDs. Inbound EVENT messages are
+// fed straight to the session's receive handler, so that dispatching them
+// goes through the same path as if they had been read from a socket.
+//------------------------------------------------------------------------------
+class FakeRouterTransport : public Transporting
+{
+public:
+    using Ptr = std::shared_ptr<FakeRouterTransport>;
+
+    using Transporting::send;
+
+    explicit FakeRouterTransport(AnyIoExecutor exec)
+        : exec_(std::move(exec)),
+          // Routers issue subscription IDs randomly from the 2^53 range.
+          rng_(12345),
+          dist_(1, 1ull << 53)
+    {}
+
+    TransportInfo info() const override
+    {
+        return {KnownCodecIds::json(), 16*1024*1024, 16*1024*1024};
+    }
+
+    bool isStarted() const override {return rxHandler_ != nullptr;}
+
+    void start(RxHandler rxHandler, TxErrorHandler) override
+    {
+        rxHandler_ = std::move(rxHandler);
+    }
+
+    void send(MessageBuffer message) override
+    {
+        Variant decoded;
+        auto ec = decode<Json>(message, decoded);
+        REQUIRE( !ec );
+        const auto& fields = decoded.as<Array>();
+
+        switch (fields.at(0).to<int>())
+        {
+        case 1: // HELLO
+            reply(Array{2, 1, Object{{"roles", Object{{"broker", Object{}}}}}});
+            break;
+
+        case 32: // SUBSCRIBE
+            reply(Array{33, fields.at(1), newSubscriptionId()});
+            break;
+
+        case 6: // GOODBYE
+            reply(Array{6, Object{}, "wamp.close.goodbye_and_out"});
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void close() override {rxHandler_ = nullptr;}
+
+    void ping(MessageBuffer, PingHandler) override {}
+
+    void inject(const MessageBuffer& message) {rxHandler_(message);}
+
+    const std::vector<SubscriptionId>& subscriptionIds() const
+    {
+        return subIds_;
+    }
+
+private:
+    SubscriptionId newSubscriptionId()
+    {
+        SubscriptionId subId = 0;
+        do
+            subId = dist_(rng_);
+        while (!issued_.insert(subId).second);
+        subIds_.push_back(subId);
+        return subId;
+    }
+
+    void reply(const Array& fields)
+    {
+        MessageBuffer buffer;
+        encode<Json>(fields, buffer);
+        auto self = std::static_pointer_cast<FakeRouterTransport>(
+            shared_from_this());
+        boost::asio::post(
+            exec_,
+            [self, buffer]()
+            {
+                if (self->rxHandler_)
+                    self->rxHandler_(buffer);
+            });
+    }
+
+    AnyIoExecutor exec_;
+    RxHandler rxHandler_;
+    std::mt19937_64 rng_;
+    std::uniform_int_distribution<SubscriptionId> dist_;
+    std::set<SubscriptionId> issued_;
+    std::vector<SubscriptionId> subIds_;
+};
+
+//------------------------------------------------------------------------------
+struct FakeRouter {};
+
+//------------------------------------------------------------------------------
+struct FakeRouterHost
+{
+    using Protocol = FakeRouter;
+
+    FakeRouterTransport::Ptr transport;
+};
+
+} // anonymous namespace
+
+namespace wamp
+{
+
+//------------------------------------------------------------------------------
+template <>
+class Connector<FakeRouter> : public Connecting
+{
+public:
+    Connector(IoStrand, FakeRouterHost host, int)
+        : transport_(std::move(host.transport))
+    {}
+
+    void establish(Handler&& handler) override
+    {
+        handler(Transporting::Ptr(transport_));
+    }
+
+    void cancel() override {}
+
+private:
+    FakeRouterTransport::Ptr transport_;
+};
+
+} // namespace wamp
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+void runPending(IoContext& ioctx)
+{
+    ioctx.run();
+    ioctx.restart();
+}
+
+//------------------------------------------------------------------------------
+void benchmarkEventDispatch(std::size_t subscriptionCount)
+{
+    const std::size_t eventCount = 10000;
+
+    IoContext ioctx;
+    auto transport = std::make_shared<FakeRouterTransport>(
+        ioctx.get_executor());
+    Session session(ioctx);
+
+    bool joined = false;
+    session.connect(
+        ConnectionWish{FakeRouterHost{transport}, json},
+        [](ErrorOr<std::size_t> index) {REQUIRE( index.has_value() );});
+    runPending(ioctx);
+    session.join(
+        Realm{"cppwamp.benchmark"},
+        [&joined](ErrorOr<SessionInfo> info)
+        {
+            REQUIRE( info.has_value() );
+            joined = true;
+        });
+    runPending(ioctx);
+    REQUIRE( joined );
+
+    // Every event lands on a no-op slot, so that the measurement covers only
+    // decoding the EVENT, looking up its subscription and posting the slot.
+    std::size_t subscribed = 0;
+    for (std::size_t i=0; i<subscriptionCount; ++i)
+    {
+        session.subscribe(
+            Topic{"com.example.topic" + std::to_string(i)},
+            [](Event) {},
+            [&subscribed](ErrorOr<Subscription> sub)
+            {
+                REQUIRE( sub.has_value() );
+                ++subscribed;
+            });
+    }
+    runPending(ioctx);
+    REQUIRE( subscribed == subscriptionCount );
+
+    const auto& subIds = transport->subscriptionIds();
+    std::mt19937_64 rng(subscriptionCount);
+    std::uniform_int_distribution<std::size_t> pick(0, subIds.size() - 1);
+    std::vector<MessageBuffer> events;
+    events.reserve(eventCount);
+    for (std::size_t i=0; i<eventCount; ++i)
+    {
+        MessageBuffer buffer;
+        encode<Json>(Array{36, subIds[pick(rng)], i + 1, Object{}}, buffer);
+        events.push_back(std::move(buffer));
+    }
+
+    BENCHMARK( std::to_string(subscriptionCount) + " subscriptions" )
+    {
+        for (const auto& event: events)
+            transport->inject(event);
+        runPending(ioctx);
+        return events.size();
+    };
+
+    session.disconnect();
+    runPending(ioctx);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Event dispatch cost versus subscription count",
+           "[Client][.benchmark]" )
+{
+    for (std::size_t count: {10u, 1000u, 100000u})
+        benchmarkEventDispatch(count);
+}
@@ -0,0 +1,240 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cppwamp/flatmap.hpp>
+#include <cppwamp/json.hpp>
+#include <cppwamp/variant.hpp>
+
+using namespace wamp;
+
+namespace
+{
+
+using Flat = FlatMap<String, int>;
+using Tree = std::map<String, int>;
+
+//------------------------------------------------------------------------------
+void checkSameContents(const Flat& flat, const Tree& tree)
+{
+    REQUIRE( flat.size() == tree.size() );
+    auto iter = flat.begin();
+    for (const auto& kv: tree)
+    {
+        CHECK( iter->first == kv.first );
+        CHECK( iter->second == kv.second );
+        ++iter;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Keys typically found in WAMP options and details dictionaries.
+const std::vector<String>& optionKeys()
+{
+    static const std::vector<String> keys =
+        {"disclose_me", "receive_progress", "timeout", "match", "exclude_me"};
+    return keys;
+}
+
+//------------------------------------------------------------------------------
+template <typename TMap>
+TMap makeOptions(std::size_t keyCount)
+{
+    TMap map;
+    for (std::size_t i=0; i<keyCount; ++i)
+        map.emplace(optionKeys()[i], Variant(Int(i)));
+    return map;
+}
+
+//------------------------------------------------------------------------------
+template <typename TMap>
+Int lookUpAll(const TMap& map)
+{
+    Int sum = 0;
+    for (const auto& key: optionKeys())
+    {
+        auto found = map.find(key);
+        if (found != map.end())
+            sum += found->second.template as<Int>();
+    }
+    return sum;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "FlatMap operations", "[FlatMap]" )
+{
+GIVEN( "a FlatMap built from unsorted elements with a duplicate key" )
+{
+    Flat flat{{"c", 3}, {"a", 1}, {"b", 2}, {"a", 42}};
+
+    THEN( "the elements are sorted and the first duplicate is kept" )
+    {
+        checkSameContents(flat, Tree{{"a", 1}, {"b", 2}, {"c", 3}});
+        CHECK( flat.count("a") == 1 );
+        CHECK( flat.count("z") == 0 );
+        CHECK( flat.at("b") == 2 );
+        CHECK_THROWS_AS( flat.at("z"), std::out_of_range );
+        CHECK( flat.lower_bound("b")->first == "b" );
+        CHECK( flat.upper_bound("b")->first == "c" );
+        CHECK( flat.find("z") == flat.end() );
+    }
+
+    WHEN( "inserting and erasing elements" )
+    {
+        Tree tree{{"a", 1}, {"b", 2}, {"c", 3}};
+        auto result = flat.emplace("bb", 22);
+        CHECK( result.second );
+        CHECK( result.first->first == "bb" );
+        tree.emplace("bb", 22);
+
+        result = flat.insert(Flat::value_type("a", 99));
+        CHECK_FALSE( result.second );
+        CHECK( result.first->second == 1 );
+
+        flat["d"] = 4;
+        tree["d"] = 4;
+        flat["a"] = 11;
+        tree["a"] = 11;
+
+        CHECK( flat.try_emplace("a", 0).second == false );
+        CHECK( flat.erase("c") == 1 );
+        CHECK( flat.erase("c") == 0 );
+        tree.erase("c");
+
+        auto next = flat.erase(flat.find("b"));
+        CHECK( next->first == "bb" );
+        tree.erase("b");
+
+        THEN( "the contents match an equivalent std::map" )
+        {
+            checkSameContents(flat, tree);
+        }
+    }
+
+    WHEN( "inserting with hints" )
+    {
+        auto pos = flat.emplace_hint(flat.end(), "d", 4);
+        CHECK( pos->first == "d" );
+        pos = flat.emplace_hint(flat.begin(), "bb", 22);
+        CHECK( pos->first == "bb" );
+        pos = flat.emplace_hint(flat.end(), "b", 99);
+        CHECK( pos->second == 2 );
+
+        THEN( "wrong hints are ignored" )
+        {
+            checkSameContents(flat, Tree{{"a", 1}, {"b", 2}, {"bb", 22},
+                                         {"c", 3}, {"d", 4}});
+        }
+    }
+
+    WHEN( "comparing FlatMaps" )
+    {
+        Flat same{{"a", 1}, {"b", 2}, {"c", 3}};
+        Flat less{{"a", 1}, {"b", 1}};
+
+        THEN( "they compare like std::map" )
+        {
+            CHECK( flat == same );
+            CHECK_FALSE( flat != same );
+            CHECK( less < flat );
+            CHECK( flat > less );
+            CHECK( less <= flat );
+            CHECK( flat >= same );
+            CHECK( flat != less );
+        }
+    }
+
+    WHEN( "clearing and swapping" )
+    {
+        Flat other{{"x", 24}};
+        swap(flat, other);
+        CHECK( flat.size() == 1 );
+        CHECK( other.size() == 3 );
+        flat.clear();
+        CHECK( flat.empty() );
+        CHECK( flat.begin() == flat.end() );
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Object dictionary cost by representation",
+           "[FlatMap][.benchmark]" )
+{
+    using FlatObject = FlatMap<String, Variant>;
+    using TreeObject = std::map<String, Variant>;
+
+    for (std::size_t keyCount: {0, 2, 5})
+    {
+        auto suffix = ", " + std::to_string(keyCount) + " keys";
+
+        BENCHMARK( "std::map build" + suffix )
+        {
+            return makeOptions<TreeObject>(keyCount);
+        };
+
+        BENCHMARK( "FlatMap build" + suffix )
+        {
+            return makeOptions<FlatObject>(keyCount);
+        };
+
+        auto tree = makeOptions<TreeObject>(keyCount);
+        BENCHMARK( "std::map lookup" + suffix )
+        {
+            return lookUpAll(tree);
+        };
+
+        auto flat = makeOptions<FlatObject>(keyCount);
+        BENCHMARK( "FlatMap lookup" + suffix )
+        {
+            return lookUpAll(flat);
+        };
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Object JSON encoding and decoding cost",
+           "[FlatMap][.benchmark]" )
+{
+    // These measure whichever representation Object is currently bound to.
+    // Build with and without CPPWAMP_OPT_FLAT_OBJECT to compare them.
+#ifdef CPPWAMP_FLAT_OBJECT
+    const std::string name = "FlatMap";
+#else
+    const std::string name = "std::map";
+#endif
+
+    JsonStringEncoder encoder;
+    JsonStringDecoder decoder;
+
+    for (std::size_t keyCount: {0, 2, 5})
+    {
+        auto suffix = ", " + std::to_string(keyCount) + " keys";
+        Variant details(makeOptions<Object>(keyCount));
+        std::string json;
+        encoder.encode(details, json);
+
+        BENCHMARK( name + " JSON encode" + suffix )
+        {
+            std::string output;
+            encoder.encode(details, output);
+            return output;
+        };
+
+        BENCHMARK( name + " JSON decode" + suffix )
+        {
+            Variant v;
+            decoder.decode(json, v);
+            return v;
+        };
+    }
+}
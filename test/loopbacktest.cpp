@@ -0,0 +1,436 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cppwamp/asiodefs.hpp>
+#include <cppwamp/codec.hpp>
+#include <cppwamp/error.hpp>
+#include <cppwamp/json.hpp>
+#include <cppwamp/loopback.hpp>
+#include <cppwamp/transport.hpp>
+#include <cppwamp/internal/mpscqueue.hpp>
+
+using namespace wamp;
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+constexpr auto jsonId = KnownCodecIds::json();
+constexpr auto msgpackId = KnownCodecIds::msgpack();
+
+//------------------------------------------------------------------------------
+struct LoopbackFixture
+{
+    explicit LoopbackFixture(int codecId = jsonId,
+                             RawsockMaxLength clientMaxRxLength =
+                                RawsockMaxLength::kB_64)
+        : listener(LoopbackListener::create(
+              IoStrand{serverCtx.get_executor()}, {jsonId},
+              RawsockMaxLength::kB_1)),
+          connector(std::make_shared<Connector<Loopback>>(
+              IoStrand{clientCtx.get_executor()},
+              LoopbackHost{listener, clientMaxRxLength}, codecId))
+    {}
+
+    void connect()
+    {
+        listener->establish(
+            [this](ErrorOr<Transporting::Ptr> t)
+            {
+                REQUIRE( t.has_value() );
+                server = *t;
+            });
+
+        connector->establish(
+            [this](ErrorOr<Transporting::Ptr> t)
+            {
+                REQUIRE( t.has_value() );
+                client = *t;
+            });
+
+        run();
+        REQUIRE( client );
+        REQUIRE( server );
+    }
+
+    void run()
+    {
+        while (clientCtx.poll() + serverCtx.poll() != 0)
+        {
+            clientCtx.restart();
+            serverCtx.restart();
+        }
+        clientCtx.restart();
+        serverCtx.restart();
+    }
+
+    IoContext clientCtx;
+    IoContext serverCtx;
+    LoopbackListener::Ptr listener;
+    Connecting::Ptr connector;
+    Transporting::Ptr client;
+    Transporting::Ptr server;
+};
+
+//------------------------------------------------------------------------------
+MessageBuffer makeMessage(const std::string& str)
+{
+    return MessageBuffer(str.begin(), str.end());
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Lock-free MPSC queue", "[Transport][Loopback]" )
+{
+    internal::MpscQueue<int> queue;
+    int n = 0;
+    CHECK( queue.empty() );
+    CHECK_FALSE( queue.pop(n) );
+
+    queue.push(1);
+    queue.push(2);
+    CHECK_FALSE( queue.empty() );
+    CHECK( queue.pop(n) );
+    CHECK( n == 1 );
+    CHECK( queue.pop(n) );
+    CHECK( n == 2 );
+    CHECK_FALSE( queue.pop(n) );
+
+    constexpr int producerCount = 4;
+    constexpr int perProducer = 10000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p)
+    {
+        producers.emplace_back([&queue, p]()
+        {
+            for (int i = 0; i < perProducer; ++i)
+                queue.push(p * perProducer + i);
+        });
+    }
+
+    std::vector<int> lastSeen(producerCount, -1);
+    int received = 0;
+    bool ordered = true;
+    while (received < producerCount * perProducer)
+    {
+        if (!queue.pop(n))
+            continue;
+        auto& last = lastSeen[n / perProducer];
+        ordered = ordered && (n % perProducer == last + 1);
+        last = n % perProducer;
+        ++received;
+    }
+    for (auto& t: producers)
+        t.join();
+
+    CHECK( ordered );
+    CHECK( queue.empty() );
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Loopback transport", "[Transport][Loopback]" )
+{
+GIVEN( "a connected client and server" )
+{
+    LoopbackFixture f;
+    f.connect();
+
+    THEN( "the transport info is negotiated" )
+    {
+        CHECK( f.client->info().codecId == jsonId );
+        CHECK( f.client->info().maxTxLength == 1024 );
+        CHECK( f.client->info().maxRxLength == 64*1024 );
+        CHECK( f.server->info().codecId == jsonId );
+        CHECK( f.server->info().maxTxLength == 64*1024 );
+        CHECK( f.server->info().maxRxLength == 1024 );
+    }
+
+    WHEN( "exchanging messages" )
+    {
+        std::vector<MessageBuffer> serverRx;
+        std::vector<MessageBuffer> clientRx;
+        f.client->start([&](ErrorOr<MessageBuffer> m)
+        {
+            REQUIRE( m.has_value() );
+            clientRx.push_back(*m);
+        });
+
+        // Messages sent before the server starts are held.
+        f.client->send(makeMessage("one"));
+        f.client->send(makeMessage("two"));
+        f.run();
+        CHECK( serverRx.empty() );
+
+        f.server->start([&](ErrorOr<MessageBuffer> m)
+        {
+            REQUIRE( m.has_value() );
+            serverRx.push_back(*m);
+            f.server->send(makeMessage("echo"));
+        });
+        f.run();
+        CHECK( serverRx.size() == 2 );
+
+        f.client->send(makeMessage("three"));
+        f.run();
+
+        THEN( "they are received in order" )
+        {
+            REQUIRE( serverRx.size() == 3 );
+            CHECK( serverRx[0] == makeMessage("one") );
+            CHECK( serverRx[1] == makeMessage("two") );
+            CHECK( serverRx[2] == makeMessage("three") );
+            REQUIRE( clientRx.size() == 3 );
+            CHECK( clientRx[0] == makeMessage("echo") );
+        }
+    }
+
+    WHEN( "sending a message exceeding the peer's limit" )
+    {
+        std::error_code txError;
+        bool received = false;
+        f.server->start([&](ErrorOr<MessageBuffer>) {received = true;});
+        f.client->start([](ErrorOr<MessageBuffer>) {},
+                        [&](std::error_code ec) {txError = ec;});
+        f.client->send(MessageBuffer(1025, 'x'));
+        f.run();
+
+        THEN( "a transmit error is reported" )
+        {
+            CHECK( txError == TransportErrc::badTxLength );
+            CHECK_FALSE( received );
+        }
+    }
+
+    WHEN( "pinging" )
+    {
+        float rtt = -1;
+        f.server->start([](ErrorOr<MessageBuffer>) {});
+        f.client->start([](ErrorOr<MessageBuffer>) {});
+        f.client->ping(makeMessage("ping"), [&](float ms) {rtt = ms;});
+        f.run();
+
+        THEN( "the round trip time is reported" )
+        {
+            CHECK( rtt >= 0 );
+        }
+    }
+
+    WHEN( "the client closes the transport" )
+    {
+        std::vector<MessageBuffer> serverRx;
+        std::error_code serverError;
+        f.server->start([&](ErrorOr<MessageBuffer> m)
+        {
+            if (m)
+                serverRx.push_back(*m);
+            else
+                serverError = m.error();
+        });
+        f.client->start([](ErrorOr<MessageBuffer>) {});
+        f.client->send(makeMessage("bye"));
+        f.client->close();
+        f.run();
+
+        THEN( "the server receives pending messages before the error" )
+        {
+            CHECK( serverRx.size() == 1 );
+            CHECK( serverError == std::errc::connection_reset );
+            CHECK_FALSE( f.server->isStarted() );
+        }
+    }
+
+    WHEN( "the server end is destroyed" )
+    {
+        std::error_code clientError;
+        f.client->start([&](ErrorOr<MessageBuffer> m)
+        {
+            if (!m)
+                clientError = m.error();
+        });
+        f.server.reset();
+        f.run();
+
+        THEN( "the client is disconnected" )
+        {
+            CHECK( clientError == std::errc::connection_reset );
+        }
+    }
+}
+
+GIVEN( "a connection request awaiting the server" )
+{
+    LoopbackFixture f;
+    ErrorOr<Transporting::Ptr> result;
+    bool completed = false;
+    f.connector->establish([&](ErrorOr<Transporting::Ptr> t)
+    {
+        result = t;
+        completed = true;
+    });
+    f.run();
+    CHECK_FALSE( completed );
+
+    WHEN( "cancelling the request" )
+    {
+        f.connector->cancel();
+        f.run();
+
+        THEN( "the request is aborted" )
+        {
+            CHECK( completed );
+            CHECK( result == makeUnexpectedError(TransportErrc::aborted) );
+        }
+    }
+
+    WHEN( "the server accepts" )
+    {
+        Transporting::Ptr server;
+        f.listener->establish([&](ErrorOr<Transporting::Ptr> t)
+        {
+            REQUIRE( t.has_value() );
+            server = *t;
+        });
+        f.run();
+
+        THEN( "the connection is established" )
+        {
+            CHECK( server != nullptr );
+            CHECK( completed );
+            REQUIRE( result.has_value() );
+            CHECK( *result != nullptr );
+        }
+    }
+}
+
+GIVEN( "an unsupported codec" )
+{
+    LoopbackFixture f(msgpackId);
+    ErrorOr<Transporting::Ptr> result;
+    f.connector->establish([&](ErrorOr<Transporting::Ptr> t) {result = t;});
+    f.run();
+
+    THEN( "the connection is refused" )
+    {
+        CHECK( result == makeUnexpectedError(RawsockErrc::badSerializer) );
+    }
+}
+
+GIVEN( "a cancelled listener" )
+{
+    LoopbackFixture f;
+    ErrorOr<Transporting::Ptr> result;
+    f.listener->establish([&](ErrorOr<Transporting::Ptr> t) {result = t;});
+    f.listener->cancel();
+    f.run();
+
+    THEN( "the establishment is aborted" )
+    {
+        CHECK( result == makeUnexpectedError(TransportErrc::aborted) );
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Loopback transport across threads", "[Transport][Loopback]" )
+{
+    LoopbackFixture f;
+    f.connect();
+
+    constexpr unsigned messageCount = 20000;
+    std::atomic<unsigned> echoed{0};
+    bool ordered = true;
+    unsigned serverCount = 0;
+
+    // Catch2 assertions are not thread-safe, so outcomes are only checked
+    // once the server thread is joined.
+    f.server->start([&](ErrorOr<MessageBuffer> m)
+    {
+        ordered = ordered && m.has_value() && (m->size() == 4) &&
+                  (m->at(0) == static_cast<uint8_t>(serverCount & 0xff));
+        ++serverCount;
+        if (m)
+            f.server->send(std::move(*m));
+    });
+
+    f.client->start([&](ErrorOr<MessageBuffer> m)
+    {
+        if (m)
+            ++echoed;
+    });
+
+    auto serverWork = boost::asio::make_work_guard(f.serverCtx);
+    std::thread serverThread([&f]() {f.serverCtx.run();});
+
+    boost::asio::post(f.clientCtx, [&]()
+    {
+        for (unsigned i = 0; i < messageCount; ++i)
+            f.client->send(MessageBuffer(4, static_cast<uint8_t>(i & 0xff)));
+    });
+
+    while (echoed.load() < messageCount)
+    {
+        f.clientCtx.restart();
+        f.clientCtx.run_one_for(std::chrono::milliseconds(100));
+    }
+
+    serverWork.reset();
+    f.serverCtx.stop();
+    serverThread.join();
+
+    CHECK( ordered );
+    CHECK( serverCount == messageCount );
+    CHECK( echoed.load() == messageCount );
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Loopback transport via ConnectionWish", "[Transport][Loopback]" )
+{
+    IoContext ioctx;
+    IoStrand strand{ioctx.get_executor()};
+    auto listener = LoopbackListener::create(strand, {jsonId});
+    auto wish = LoopbackHost{listener}.withFormat(json);
+    CHECK( wish.codecId() == jsonId );
+    CHECK( static_cast<bool>(wish.makeCodec()) );
+
+    Transporting::Ptr client;
+    Transporting::Ptr server;
+    listener->establish([&](ErrorOr<Transporting::Ptr> t)
+    {
+        REQUIRE( t.has_value() );
+        server = *t;
+    });
+    auto connector = wish.makeConnector(strand);
+    REQUIRE( connector != nullptr );
+    connector->establish([&](ErrorOr<Transporting::Ptr> t)
+    {
+        REQUIRE( t.has_value() );
+        client = *t;
+    });
+    ioctx.run();
+    ioctx.restart();
+    REQUIRE( client != nullptr );
+    REQUIRE( server != nullptr );
+    CHECK( client->info().codecId == jsonId );
+    CHECK( server->info().codecId == jsonId );
+
+    std::vector<MessageBuffer> serverRx;
+    server->start([&](ErrorOr<MessageBuffer> m)
+    {
+        REQUIRE( m.has_value() );
+        serverRx.push_back(*m);
+    });
+    client->start([](ErrorOr<MessageBuffer>) {});
+    client->send(makeMessage("hello"));
+    ioctx.run();
+
+    REQUIRE( serverRx.size() == 1 );
+    CHECK( serverRx.front() == makeMessage("hello") );
+}
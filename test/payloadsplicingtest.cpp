@@ -0,0 +1,279 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <string>
+#include <catch2/catch.hpp>
+#include <cppwamp/json.hpp>
+#include <cppwamp/peerdata.hpp>
+#include <cppwamp/internal/lazypayload.hpp>
+#include <cppwamp/internal/payloadsplicing.hpp>
+#include <cppwamp/internal/wampmessage.hpp>
+
+using namespace wamp;
+using namespace wamp::internal;
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+MessageBuffer toBuffer(const std::string& text)
+{
+    return MessageBuffer(text.begin(), text.end());
+}
+
+//------------------------------------------------------------------------------
+std::string toString(const MessageBuffer& buffer)
+{
+    return std::string(buffer.begin(), buffer.end());
+}
+
+//------------------------------------------------------------------------------
+MessageBuffer slicedBytes(const MessageBuffer& message,
+                          const EncodedSlice& slice)
+{
+    auto first = message.begin() + slice.offset;
+    return MessageBuffer(first, first + slice.length);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "Splicing JSON payloads", "[Payload][Splicing]" )
+{
+GIVEN( "a JSON EVENT message with tricky header and payload contents" )
+{
+    auto message = toBuffer(
+        R"( [36, 1, 2, {"a":"],\"[{", "b":[1,{"c":2}]}, )"
+        R"([1,"x,y"] , {"k":[]} ] )");
+    EncodedSlice slice;
+    slice.count = 2;
+
+    WHEN( "locating the payload" )
+    {
+        REQUIRE( JsonSplicer::locate(message, 4, slice) );
+
+        THEN( "the slice spans the arguments only" )
+        {
+            CHECK( toString(slicedBytes(message, slice)) ==
+                   R"([1,"x,y"] , {"k":[]})" );
+        }
+
+        THEN( "the slice can be appended to a message header" )
+        {
+            auto publish = toBuffer(R"([16,3,{},"topic"])");
+            REQUIRE( JsonSplicer::append(publish, message, slice) );
+            CHECK( toString(publish) ==
+                   R"([16,3,{},"topic",[1,"x,y"] , {"k":[]}])" );
+        }
+    }
+
+    WHEN( "locating beyond the message's elements" )
+    {
+        THEN( "the payload is not found" )
+        {
+            CHECK_FALSE( JsonSplicer::locate(message, 6, slice) );
+            CHECK_FALSE( JsonSplicer::locate(toBuffer("[36,1,2,{}]"), 4,
+                                             slice) );
+            CHECK_FALSE( JsonSplicer::locate(toBuffer("{}"), 1, slice) );
+        }
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Splicing Msgpack payloads", "[Payload][Splicing]" )
+{
+GIVEN( "a Msgpack EVENT message with various header element types" )
+{
+    // [36, 300, -1, {"a": [nil, 1.0], "b": bin(3)}, ["x"], {"k": true}]
+    MessageBuffer message{
+        0x96, 0x24, 0xcd, 0x01, 0x2c, 0xff,
+        0x82, 0xa1, 'a', 0x92, 0xc0, 0xcb, 0x3f, 0xf0, 0, 0, 0, 0, 0, 0,
+              0xa1, 'b', 0xc4, 0x03, 1, 2, 3,
+        0x91, 0xa1, 'x',
+        0x81, 0xa1, 'k', 0xc3};
+    MessageBuffer payload{0x91, 0xa1, 'x', 0x81, 0xa1, 'k', 0xc3};
+
+    EncodedSlice slice;
+    slice.count = 2;
+
+    WHEN( "locating the payload" )
+    {
+        REQUIRE( MsgpackSplicer::locate(message, 4, slice) );
+
+        THEN( "the slice spans the arguments only" )
+        {
+            CHECK( slicedBytes(message, slice) == payload );
+        }
+
+        THEN( "the slice can be appended to a message header" )
+        {
+            // [70, 5, {}]
+            MessageBuffer yield{0x93, 0x46, 0x05, 0x80};
+            REQUIRE( MsgpackSplicer::append(yield, message, slice) );
+            MessageBuffer expected{0x95, 0x46, 0x05, 0x80};
+            expected.insert(expected.end(), payload.begin(), payload.end());
+            CHECK( yield == expected );
+        }
+
+        THEN( "headers are widened when the element count requires it" )
+        {
+            MessageBuffer big{0x9e};
+            for (int i=0; i<14; ++i)
+                big.push_back(0x00);
+            REQUIRE( MsgpackSplicer::append(big, message, slice) );
+            CHECK( big.size() == 3 + 14 + payload.size() );
+            CHECK( big[0] == 0xdc );
+            CHECK( big[1] == 0x00 );
+            CHECK( big[2] == 16 );
+        }
+    }
+
+    WHEN( "the element count does not match" )
+    {
+        slice.count = 1;
+        CHECK_FALSE( MsgpackSplicer::locate(message, 4, slice) );
+    }
+
+    WHEN( "the message is truncated" )
+    {
+        message.resize(12);
+        CHECK_FALSE( MsgpackSplicer::locate(message, 4, slice) );
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Splicing CBOR payloads", "[Payload][Splicing]" )
+{
+GIVEN( "a CBOR EVENT message with various header element types" )
+{
+    // [36, 500, -2, {_ "a": tag(1, 0), "b": (_ h'01', h'02')}, ["x"], {}]
+    MessageBuffer header{
+        0x18, 0x24, 0x19, 0x01, 0xf4, 0x21,
+        0xbf, 0x61, 'a', 0xc1, 0x00,
+              0x61, 'b', 0x5f, 0x41, 0x01, 0x41, 0x02, 0xff,
+        0xff};
+    MessageBuffer payload{0x81, 0x61, 'x', 0xa0};
+
+    EncodedSlice slice;
+    slice.count = 2;
+
+    WHEN( "the message array has a definite length" )
+    {
+        MessageBuffer message{0x86};
+        message.insert(message.end(), header.begin(), header.end());
+        message.insert(message.end(), payload.begin(), payload.end());
+        REQUIRE( CborSplicer::locate(message, 4, slice) );
+
+        THEN( "the slice spans the arguments only" )
+        {
+            CHECK( slicedBytes(message, slice) == payload );
+        }
+
+        THEN( "the slice can be appended to a definite-length header" )
+        {
+            // [70, 5, {}]
+            MessageBuffer yield{0x83, 0x18, 0x46, 0x05, 0xa0};
+            REQUIRE( CborSplicer::append(yield, message, slice) );
+            MessageBuffer expected{0x85, 0x18, 0x46, 0x05, 0xa0};
+            expected.insert(expected.end(), payload.begin(), payload.end());
+            CHECK( yield == expected );
+        }
+
+        THEN( "the slice can be appended to an indefinite-length header" )
+        {
+            // [_ 70, 5, {}]
+            MessageBuffer yield{0x9f, 0x18, 0x46, 0x05, 0xa0, 0xff};
+            REQUIRE( CborSplicer::append(yield, message, slice) );
+            MessageBuffer expected{0x9f, 0x18, 0x46, 0x05, 0xa0};
+            expected.insert(expected.end(), payload.begin(), payload.end());
+            expected.push_back(0xff);
+            CHECK( yield == expected );
+        }
+    }
+
+    WHEN( "the message array has an indefinite length" )
+    {
+        MessageBuffer message{0x9f};
+        message.insert(message.end(), header.begin(), header.end());
+        message.insert(message.end(), payload.begin(), payload.end());
+        message.push_back(0xff);
+        REQUIRE( CborSplicer::locate(message, 4, slice) );
+
+        THEN( "the slice excludes the terminating break code" )
+        {
+            CHECK( slicedBytes(message, slice) == payload );
+        }
+    }
+
+    WHEN( "the message is truncated" )
+    {
+        MessageBuffer message{0x86};
+        message.insert(message.end(), header.begin(), header.begin() + 12);
+        CHECK_FALSE( CborSplicer::locate(message, 4, slice) );
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Forwarding encoded payloads", "[Payload][Splicing]" )
+{
+GIVEN( "a lazy payload from a received JSON EVENT" )
+{
+    auto message = toBuffer(R"([36,1,2,{},[1,"two"],{"k":null}])");
+    auto lazy = std::make_shared<LazyPayload>(message, AnyBufferCodec{json},
+                                              KnownCodecIds::json(), 4, 2);
+
+    WHEN( "moving it to an outgoing YIELD message" )
+    {
+        YieldMessage yield(42);
+        yield.setEncodedPayload(lazy);
+
+        THEN( "the YIELD message holds empty placeholders" )
+        {
+            CHECK( yield.hasLazyPayload() );
+            CHECK( yield.fields() ==
+                   (Array{70, 42, Object{}, Array{}, Object{}}) );
+        }
+
+        THEN( "the arguments are decoded on demand" )
+        {
+            const auto& constYield = yield;
+            CHECK( constYield.args() == (Array{1, "two"}) );
+            CHECK( constYield.kwargs() == (Object{{"k", null}}) );
+        }
+
+        THEN( "the arguments are moved into place upon being loaded" )
+        {
+            yield.loadPayload();
+            CHECK_FALSE( yield.hasLazyPayload() );
+            CHECK( yield.fields() ==
+                   (Array{70, 42, Object{}, Array{1, "two"},
+                          Object{{"k", null}}}) );
+        }
+
+        THEN( "the encoded arguments can be spliced after the header" )
+        {
+            EncodedSlice slice;
+            REQUIRE( lazy->locateEncoded(slice) );
+            auto header = toBuffer(R"([70,42,{}])");
+            REQUIRE( appendEncodedPayload(KnownCodecIds::json(), header,
+                                          lazy->bytes(), slice) );
+            CHECK( toString(header) == R"([70,42,{},[1,"two"],{"k":null}])" );
+        }
+    }
+
+    WHEN( "transferring it between payload wrappers" )
+    {
+        Rpc rpc("procedure");
+        CHECK_FALSE( rpc.encodedPayload() );
+        rpc.withEncodedPayload(EncodedPayload{});
+        CHECK( rpc.args().empty() );
+        CHECK( rpc.kwargs().empty() );
+    }
+}
+}
@@ -21,6 +21,9 @@ Object testMap{{"a", null}, {"b", true}, {"c", 42}, {"d", "foo"}};
 struct TestPayload : public Payload<TestPayload, internal::ResultMessage>
 {};
 
+struct SharedPayload : public Payload<SharedPayload, internal::EventMessage>
+{};
+
 } // anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -318,3 +321,67 @@ GIVEN( "a Payload object with positional and keyword arguments" )
     }
 }
 }
+
+//------------------------------------------------------------------------------
+SCENARIO( "Copying shared Payloads", "[Variant][Payload]" )
+{
+GIVEN( "a payload whose message is shared between copies" )
+{
+    auto p = SharedPayload().withArgList(testList).withKwargs(testMap);
+
+    WHEN( "copying the payload" )
+    {
+        const auto c = p;
+
+        THEN( "the copy refers to the same arguments" )
+        {
+            CHECK( c.args() == testList );
+            CHECK( c.kwargs() == testMap );
+            CHECK( &c.args() == &p.args() );
+            CHECK( &c.kwargs() == &p.kwargs() );
+        }
+    }
+
+    WHEN( "modifying the original after copying it" )
+    {
+        const auto c = p;
+        p[0] = "changed";
+        p["e"] = 123;
+
+        THEN( "only the original is affected" )
+        {
+            CHECK( p[0] == "changed" );
+            CHECK( p["e"] == 123 );
+            CHECK( c.args() == testList );
+            CHECK( c.kwargs() == testMap );
+            CHECK( &c.args() != &p.args() );
+        }
+    }
+
+    WHEN( "moving the arguments out of a copy" )
+    {
+        auto c = p;
+        Array args = std::move(c).args();
+
+        THEN( "the original keeps its arguments" )
+        {
+            CHECK( args == testList );
+            CHECK( p.args() == testList );
+        }
+    }
+
+    WHEN( "moving the payload" )
+    {
+        auto m = std::move(p);
+        CHECK( m.args() == testList );
+
+        THEN( "the moved-from payload is left empty but usable" )
+        {
+            CHECK( p.args().empty() );
+            p.withArgs(42);
+            CHECK( p[0] == 42 );
+            CHECK( m.args() == testList );
+        }
+    }
+}
+}
@@ -0,0 +1,264 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cppwamp/wampdefs.hpp>
+#include <cppwamp/internal/messagetraits.hpp>
+#include <cppwamp/internal/requesttable.hpp>
+
+using namespace wamp;
+
+namespace
+{
+
+using internal::WampMsgType;
+using Key = std::pair<WampMsgType, RequestId>;
+using Handler = std::function<void (int)>;
+using Table = internal::RequestTable<Key, Handler>;
+
+//------------------------------------------------------------------------------
+template <typename TMap>
+void checkEntries(const TMap& map, const std::map<Key, int>& expected)
+{
+    CHECK( map.size() == expected.size() );
+    std::map<Key, int> actual;
+    for (const auto& kv: map)
+        actual.emplace(kv.first, kv.second);
+    CHECK( actual == expected );
+}
+
+//------------------------------------------------------------------------------
+template <typename TMap>
+void runInFlightCalls(TMap& map, RequestId& nextId, std::size_t inFlight,
+                      std::size_t rounds)
+{
+    // Keeps a sliding window of outstanding calls, where the oldest one is
+    // answered each time a new one is issued.
+    for (std::size_t i=0; i<inFlight; ++i)
+    {
+        ++nextId;
+        map.emplace(Key{WampMsgType::call, nextId}, [](int) {});
+    }
+
+    for (std::size_t i=0; i<rounds; ++i)
+    {
+        auto oldest = nextId - inFlight + 1;
+        auto kv = map.find(Key{WampMsgType::call, oldest});
+        REQUIRE( kv != map.end() );
+        auto handler = std::move(kv->second);
+        map.erase(kv);
+        handler(0);
+        ++nextId;
+        map.emplace(Key{WampMsgType::call, nextId}, [](int) {});
+    }
+
+    map.clear();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "Request table operations", "[RequestTable]" )
+{
+GIVEN( "an empty request table" )
+{
+    internal::RequestTable<Key, int> table;
+    CHECK( table.empty() );
+    CHECK( table.size() == 0 );
+    CHECK( table.begin() == table.end() );
+    CHECK( table.find(Key{WampMsgType::call, 1}) == table.end() );
+
+    WHEN( "inserting entries" )
+    {
+        auto result = table.emplace(Key{WampMsgType::call, 1}, 10);
+        CHECK( result.second );
+        CHECK( result.first->second == 10 );
+        table.emplace(Key{WampMsgType::subscribe, 2}, 20);
+        table.emplace(Key{WampMsgType::hello, 0}, 30);
+
+        THEN( "they can be looked up and iterated" )
+        {
+            CHECK_FALSE( table.empty() );
+            auto kv = table.find(Key{WampMsgType::subscribe, 2});
+            REQUIRE( kv != table.end() );
+            CHECK( kv->second == 20 );
+            CHECK( table.count(Key{WampMsgType::hello, 0}) == 1 );
+            CHECK( table.count(Key{WampMsgType::publish, 2}) == 0 );
+            checkEntries(table, {{Key{WampMsgType::call, 1}, 10},
+                                 {Key{WampMsgType::subscribe, 2}, 20},
+                                 {Key{WampMsgType::hello, 0}, 30}});
+        }
+
+        THEN( "inserting a duplicate key does not replace the entry" )
+        {
+            auto result = table.emplace(Key{WampMsgType::call, 1}, 99);
+            CHECK_FALSE( result.second );
+            CHECK( result.first->second == 10 );
+            CHECK( table.size() == 3 );
+        }
+
+        THEN( "entries can be erased" )
+        {
+            table.erase(table.find(Key{WampMsgType::call, 1}));
+            CHECK( table.erase(Key{WampMsgType::hello, 0}) == 1 );
+            CHECK( table.erase(Key{WampMsgType::hello, 0}) == 0 );
+            checkEntries(table, {{Key{WampMsgType::subscribe, 2}, 20}});
+        }
+
+        THEN( "the table can be cleared" )
+        {
+            table.clear();
+            CHECK( table.empty() );
+            CHECK( table.begin() == table.end() );
+            CHECK( table.find(Key{WampMsgType::call, 1}) == table.end() );
+        }
+    }
+
+    WHEN( "inserting and erasing many colliding and sequential entries" )
+    {
+        // Compare against std::map while interleaving inserts and erasures,
+        // including keys whose IDs wrap onto the same slots.
+        std::map<Key, int> expected;
+        for (int i=0; i<1000; ++i)
+        {
+            Key key{WampMsgType::call, RequestId(i) * 64};
+            Key seq{WampMsgType::publish, RequestId(i)};
+            table.emplace(key, i);
+            table.emplace(seq, -i);
+            expected.emplace(key, i);
+            expected.emplace(seq, -i);
+            if (i % 3 == 0)
+            {
+                Key old{WampMsgType::call, RequestId(i / 2) * 64};
+                CHECK( table.erase(old) == expected.erase(old) );
+            }
+        }
+
+        THEN( "the table contents match" )
+        {
+            checkEntries(table, expected);
+            for (const auto& kv: expected)
+            {
+                auto found = table.find(kv.first);
+                REQUIRE( found != table.end() );
+                CHECK( found->second == kv.second );
+            }
+        }
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Request table with move-only values", "[RequestTable]" )
+{
+    internal::RequestTable<Key, std::unique_ptr<int>> table;
+    for (int i=0; i<100; ++i)
+        table.emplace(Key{WampMsgType::call, RequestId(i)},
+                      std::unique_ptr<int>(new int(i)));
+
+    for (int i=0; i<100; i+=2)
+    {
+        auto kv = table.find(Key{WampMsgType::call, RequestId(i)});
+        REQUIRE( kv != table.end() );
+        REQUIRE( kv->second != nullptr );
+        CHECK( *kv->second == i );
+        auto value = std::move(kv->second);
+        table.erase(kv);
+    }
+
+    CHECK( table.size() == 50 );
+    for (const auto& kv: table)
+        CHECK( *kv.second == int(kv.first.second) );
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Request table with reentrant handlers", "[RequestTable]" )
+{
+    // Mimics how the session dispatches progressive responses, where a
+    // handler that remains in the table may issue or cancel other requests.
+    Table table;
+    std::vector<std::string> log;
+    auto tag = std::make_shared<std::string>("progress");
+    Key progressKey{WampMsgType::call, 1};
+    RequestId nextId = 1;
+
+    table.emplace(progressKey, [&table, &log, &nextId, tag](int n)
+    {
+        // Enough insertions to make the table grow and relocate its slots.
+        for (int i=0; i<100; ++i)
+        {
+            ++nextId;
+            table.emplace(Key{WampMsgType::call, nextId}, [](int) {});
+        }
+        table.erase(Key{WampMsgType::call, nextId});
+        log.push_back(*tag + std::to_string(n));
+    });
+
+    for (int n=0; n<3; ++n)
+    {
+        auto kv = table.find(progressKey);
+        REQUIRE( kv != table.end() );
+        auto handler = kv->second;
+        handler(n);
+    }
+
+    CHECK( log == (std::vector<std::string>{"progress0", "progress1",
+                                            "progress2"}) );
+    CHECK( table.size() == 1 + 3*99 );
+    auto kv = table.find(progressKey);
+    REQUIRE( kv != table.end() );
+    CHECK( tag.use_count() == 2 );
+
+    WHEN( "the handler erases its own entry" )
+    {
+        kv->second = [&table, &log, progressKey, tag](int)
+        {
+            table.erase(progressKey);
+            log.push_back(*tag);
+        };
+        auto handler = kv->second;
+        handler(0);
+
+        THEN( "the copied handler outlives the erased entry" )
+        {
+            CHECK( log.back() == "progress" );
+            CHECK( table.count(progressKey) == 0 );
+            CHECK( tag.use_count() == 2 );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Request table in-flight call throughput",
+           "[RequestTable][.benchmark]" )
+{
+    const std::size_t rounds = 100000;
+
+    for (std::size_t inFlight: {100, 10000})
+    {
+        BENCHMARK( "std::map, " + std::to_string(inFlight) + " in flight" )
+        {
+            std::map<Key, Handler> map;
+            RequestId nextId = 0;
+            runInFlightCalls(map, nextId, inFlight, rounds);
+            return nextId;
+        };
+
+        BENCHMARK( "RequestTable, " + std::to_string(inFlight) + " in flight" )
+        {
+            Table table;
+            RequestId nextId = 0;
+            runInFlightCalls(table, nextId, inFlight, rounds);
+            return nextId;
+        };
+    }
+}
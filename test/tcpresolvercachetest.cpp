@@ -0,0 +1,276 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <thread>
+#include <catch2/catch.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <cppwamp/asiodefs.hpp>
+#include <cppwamp/tcphost.hpp>
+#include <cppwamp/tcpresolvercache.hpp>
+#include <cppwamp/internal/tcpopener.hpp>
+
+using namespace wamp;
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+using Endpoint = TcpResolverCache::Endpoint;
+using EndpointList = TcpResolverCache::EndpointList;
+constexpr unsigned short tcpTestPort = 9090;
+constexpr const char tcpLoopbackAddr[] = "127.0.0.1";
+const auto loopback = boost::asio::ip::make_address(tcpLoopbackAddr);
+
+//------------------------------------------------------------------------------
+struct CacheFixture
+{
+    explicit CacheFixture(
+        TcpResolverCache::Duration ttl = TcpResolverCache::defaultTtl())
+        : strand(ioctx.get_executor()),
+          cache(TcpResolverCache::create(ioctx.get_executor(), ttl))
+    {}
+
+    ErrorOr<EndpointList> lookup(const std::string& host,
+                                 const std::string& service)
+    {
+        ErrorOr<EndpointList> result;
+        bool done = false;
+        cache->lookup(host, service, strand,
+                      [&](ErrorOr<EndpointList> e)
+                      {
+                          result = std::move(e);
+                          done = true;
+                      });
+        ioctx.restart();
+        ioctx.run();
+        CHECK( done );
+        return result;
+    }
+
+    IoContext ioctx;
+    IoStrand strand;
+    TcpResolverCache::Ptr cache;
+};
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "Caching resolved TCP endpoints", "[Transport][Tcp]" )
+{
+GIVEN( "a static entry" )
+{
+    CacheFixture f;
+    EndpointList endpoints{Endpoint{loopback, 12345}};
+    f.cache->addStatic("wamp.test", "wamp", endpoints);
+
+    WHEN( "looking it up" )
+    {
+        auto result = f.lookup("wamp.test", "wamp");
+
+        THEN( "the static endpoints are emitted without resolution" )
+        {
+            REQUIRE( result.has_value() );
+            CHECK( *result == endpoints );
+            CHECK( f.cache->stats().hits == 1 );
+            CHECK( f.cache->stats().resolutions == 0 );
+        }
+    }
+
+    WHEN( "invalidating it" )
+    {
+        f.cache->invalidate("wamp.test", "wamp");
+
+        THEN( "the static entry is retained" )
+        {
+            CHECK( f.cache->find("wamp.test", "wamp") == endpoints );
+        }
+    }
+
+    WHEN( "removing it" )
+    {
+        f.cache->remove("wamp.test", "wamp");
+
+        THEN( "the entry is gone" )
+        {
+            CHECK( f.cache->find("wamp.test", "wamp").empty() );
+            CHECK( f.cache->size() == 0 );
+        }
+    }
+}
+
+GIVEN( "concurrent lookups of the same host" )
+{
+    CacheFixture f;
+    int count = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        f.cache->lookup(tcpLoopbackAddr, "9090", f.strand,
+                        [&](ErrorOr<EndpointList> e)
+                        {
+                            REQUIRE( e.has_value() );
+                            REQUIRE( e->size() == 1 );
+                            CHECK( e->front().port() == 9090 );
+                            ++count;
+                        });
+    }
+    f.ioctx.run();
+
+    THEN( "a single resolver query serves them all" )
+    {
+        CHECK( count == 10 );
+        CHECK( f.cache->stats().misses == 10 );
+        CHECK( f.cache->stats().resolutions == 1 );
+    }
+
+    AND_WHEN( "looking it up again" )
+    {
+        auto result = f.lookup(tcpLoopbackAddr, "9090");
+
+        THEN( "the lookup is served from the cache" )
+        {
+            CHECK( result.has_value() );
+            CHECK( f.cache->stats().hits == 1 );
+            CHECK( f.cache->stats().resolutions == 1 );
+        }
+    }
+
+    AND_WHEN( "invalidating the entry" )
+    {
+        f.cache->invalidate(tcpLoopbackAddr, "9090");
+        CHECK( f.cache->find(tcpLoopbackAddr, "9090").empty() );
+        auto result = f.lookup(tcpLoopbackAddr, "9090");
+
+        THEN( "the host is resolved again" )
+        {
+            CHECK( result.has_value() );
+            CHECK( f.cache->stats().resolutions == 2 );
+        }
+    }
+}
+
+GIVEN( "a short time-to-live" )
+{
+    CacheFixture f(std::chrono::milliseconds(1));
+    CHECK( f.lookup(tcpLoopbackAddr, "9090").has_value() );
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    THEN( "expired entries are resolved again" )
+    {
+        CHECK( f.cache->find(tcpLoopbackAddr, "9090").empty() );
+        CHECK( f.lookup(tcpLoopbackAddr, "9090").has_value() );
+        CHECK( f.cache->stats().misses == 2 );
+        CHECK( f.cache->stats().resolutions == 2 );
+    }
+}
+
+GIVEN( "a refresh margin exceeding the time-to-live" )
+{
+    CacheFixture f(std::chrono::hours(1));
+    f.cache->setRefreshMargin(std::chrono::hours(2));
+    f.cache->preresolve(tcpLoopbackAddr, "9090");
+    f.ioctx.run();
+    CHECK( f.cache->stats().resolutions == 1 );
+
+    WHEN( "looking up the entry" )
+    {
+        auto result = f.lookup(tcpLoopbackAddr, "9090");
+
+        THEN( "it is served from the cache and refreshed in the background" )
+        {
+            CHECK( result.has_value() );
+            CHECK( f.cache->stats().hits == 1 );
+            CHECK( f.cache->stats().resolutions == 2 );
+        }
+    }
+}
+
+GIVEN( "an unresolvable service name" )
+{
+    CacheFixture f;
+    auto result = f.lookup(tcpLoopbackAddr, "no-such-service-cppwamp");
+
+    THEN( "the failure is emitted and not cached" )
+    {
+        CHECK_FALSE( result.has_value() );
+        CHECK( f.cache->stats().failures == 1 );
+        CHECK( f.cache->size() == 0 );
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Connecting via cached TCP endpoints", "[Transport][Tcp]" )
+{
+    using Opener = internal::TcpOpener;
+
+    CacheFixture f;
+    ErrorOr<Opener::SocketPtr> socket;
+    bool done = false;
+    auto onEstablished = [&](ErrorOr<Opener::SocketPtr> s)
+    {
+        socket = std::move(s);
+        done = true;
+    };
+
+    GIVEN( "a listening socket reachable via a static entry" )
+    {
+        boost::asio::ip::tcp::acceptor acceptor{
+            f.ioctx, Endpoint{loopback, tcpTestPort}};
+        boost::asio::ip::tcp::socket server{f.ioctx};
+        acceptor.async_accept(server, [](boost::system::error_code) {});
+        f.cache->addStatic("wamp.test", "9090",
+                           {Endpoint{loopback, tcpTestPort}});
+
+        WHEN( "establishing a connection" )
+        {
+            Opener opener{f.strand, TcpHost{"wamp.test", tcpTestPort}
+                                        .withResolverCache(f.cache)};
+            opener.establish(onEstablished);
+            f.ioctx.run();
+
+            THEN( "the cached endpoint is connected to" )
+            {
+                CHECK( done );
+                REQUIRE( socket.has_value() );
+                CHECK( (*socket)->remote_endpoint().port() == tcpTestPort );
+                CHECK( f.cache->stats().hits == 1 );
+            }
+        }
+    }
+
+    GIVEN( "a resolved endpoint that refuses connections" )
+    {
+        Opener opener{f.strand, TcpHost{tcpLoopbackAddr, tcpTestPort}
+                                    .withResolverCache(f.cache)};
+        opener.establish(onEstablished);
+        f.ioctx.run();
+
+        THEN( "the failed entry is invalidated" )
+        {
+            CHECK( done );
+            CHECK_FALSE( socket.has_value() );
+            CHECK( f.cache->stats().resolutions == 1 );
+            CHECK( f.cache->find(tcpLoopbackAddr, "9090").empty() );
+        }
+    }
+
+    GIVEN( "a connection attempt cancelled during lookup" )
+    {
+        Opener opener{f.strand, TcpHost{tcpLoopbackAddr, tcpTestPort}
+                                    .withResolverCache(f.cache)};
+        opener.establish(onEstablished);
+        opener.cancel();
+        f.ioctx.run();
+
+        THEN( "the attempt is aborted" )
+        {
+            CHECK( done );
+            CHECK( socket == makeUnexpectedError(
+                                 std::errc::operation_canceled) );
+        }
+    }
+}
@@ -184,13 +184,12 @@ struct CannedHandshakeConfig : internal::DefaultRawsockClientConfig
 //------------------------------------------------------------------------------
 struct BadMsgTypeTransportConfig : internal::DefaultRawsockTransportConfig
 {
-    static internal::RawsockFrame::Ptr enframe(internal::RawsockMsgType type,
-                                               MessageBuffer&& payload)
+    static void enframe(internal::RawsockFrame& frame,
+                        internal::RawsockMsgType type, MessageBuffer&& payload)
     {
         auto badType = internal::RawsockMsgType(
             (int)internal::RawsockMsgType::pong + 1);
-        return std::make_shared<internal::RawsockFrame>(badType,
-                                                        std::move(payload));
+        frame.prepare(badType, std::move(payload));
     }
 };
 
@@ -352,6 +351,25 @@ void checkConsecutiveSendReceive(TFixture& f, Transporting::Ptr& sender,
     CHECK_NOTHROW( f.run() );
 }
 
+//------------------------------------------------------------------------------
+template <typename TFixture>
+void checkBatchedSendReceive(TFixture& f, Transporting::Ptr& sender,
+                             Transporting::Ptr& receiver)
+{
+    using Transport = typename TFixture::Transport;
+    auto transport = std::dynamic_pointer_cast<Transport>(sender);
+    REQUIRE( transport );
+
+    checkConsecutiveSendReceive(f, sender, receiver);
+
+    // Messages queued while a write is in progress must have been merged
+    // into fewer writes, within the configured frame limit.
+    INFO( "Writes: " << transport->txWriteCount() );
+    CHECK( transport->txWriteCount() < 100 );
+    CHECK( transport->txBatchHighWater() > 1 );
+    CHECK( transport->txBatchHighWater() <= 16 );
+}
+
 //------------------------------------------------------------------------------
 template <typename TFixture>
 void checkUnsupportedSerializer(TFixture& f)
@@ -662,6 +680,461 @@ TEMPLATE_TEST_CASE( "Consecutive send/receive", "[Transport]",
     }
 }
 
+//------------------------------------------------------------------------------
+SCENARIO( "Batched transmission", "[Transport]" )
+{
+    using TcpFixture = LoopbackFixture<TcpRawsockConnector, TcpRawsockListener>;
+    using UdsFixture = LoopbackFixture<UdsRawsockConnector, UdsRawsockListener>;
+
+    auto batching = RawsockOptions{}.withTxBatching(16, 1024);
+    auto tcpClient = TcpHost{tcpLoopbackAddr, tcpTestPort}
+                         .withMaxRxLength(RML::kB_64)
+                         .withRawsockOptions(batching);
+    auto tcpServer = TcpEndpoint{tcpTestPort}.withMaxRxLength(RML::kB_64)
+                                             .withRawsockOptions(batching);
+    auto udsSettings = UdsPath{udsTestPath}.withMaxRxLength(RML::kB_64)
+                                           .withRawsockOptions(batching);
+
+    GIVEN( "a TCP connector/listener pair with batching enabled" )
+    {
+        {
+            TcpFixture f(tcpClient, jsonId, tcpServer, CodecIds{jsonId});
+            checkBatchedSendReceive(f, f.client, f.server);
+        }
+        {
+            TcpFixture f(tcpClient, jsonId, tcpServer, CodecIds{jsonId});
+            checkBatchedSendReceive(f, f.server, f.client);
+        }
+    }
+
+    GIVEN( "a UDS connector/listener pair with batching enabled" )
+    {
+        {
+            UdsFixture f(udsSettings, jsonId, udsSettings, CodecIds{jsonId});
+            checkBatchedSendReceive(f, f.client, f.server);
+        }
+        {
+            UdsFixture f(udsSettings, jsonId, udsSettings, CodecIds{jsonId});
+            checkBatchedSendReceive(f, f.server, f.client);
+        }
+    }
+
+    GIVEN( "a batch byte limit smaller than a single message" )
+    {
+        auto tinyBatch = RawsockOptions{}.withTxBatching(16, 1);
+        UdsFixture f(UdsPath{udsSettings}.withRawsockOptions(tinyBatch), jsonId,
+                     UdsPath{udsSettings}.withRawsockOptions(tinyBatch),
+                     CodecIds{jsonId});
+        const MessageBuffer message(f.client->info().maxRxLength, 'm');
+        const MessageBuffer reply(f.server->info().maxRxLength, 'r');
+        checkSendReply(f, message, reply);
+    }
+
+    GIVEN( "a batch frame limit of one" )
+    {
+        auto unbatched = RawsockOptions{}.withTxBatching(1, 1024);
+        UdsFixture f(UdsPath{udsSettings}.withRawsockOptions(unbatched),
+                     jsonId,
+                     UdsPath{udsSettings}.withRawsockOptions(unbatched),
+                     CodecIds{jsonId});
+        auto transport =
+            std::dynamic_pointer_cast<UdsFixture::Transport>(f.client);
+        REQUIRE( transport );
+        checkConsecutiveSendReceive(f, f.client, f.server);
+
+        THEN( "every frame is written separately" )
+        {
+            CHECK( transport->txWriteCount() == 100 );
+            CHECK( transport->txBatchHighWater() == 1 );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Transmit watermarks", "[Transport]" )
+{
+GIVEN( "a connected UDS transport pair with frame watermarks" )
+{
+    UdsLoopbackFixture f;
+    f.client->setTxWatermarks(TxWatermarks{}.withFrames(2, 0));
+    const std::vector<MessageBuffer> messages{
+        MessageBuffer(4, 'a'), MessageBuffer(4, 'b'), MessageBuffer(4, 'c')};
+    f.client->start([](ErrorOr<MessageBuffer>) {});
+    f.server->start([](ErrorOr<MessageBuffer>) {});
+
+    bool notified = false;
+    std::error_code spaceEc = make_error_code(TransportErrc::failed);
+    auto onSpace = [&](std::error_code ec)
+    {
+        notified = true;
+        spaceEc = ec;
+        CHECK_FALSE( f.client->isTxBlocked() );
+        f.disconnect();
+    };
+
+    WHEN( "not exceeding the high watermark" )
+    {
+        f.client->send(messages.at(0));
+        f.client->send(messages.at(1));
+        CHECK_FALSE( f.client->isTxBlocked() );
+        CHECK( f.client->txQueuedFrames() == 2 );
+        CHECK( f.client->txQueuedBytes() == 16 );
+        f.client->awaitTxSpace(onSpace);
+        CHECK_NOTHROW( f.run() );
+
+        THEN( "awaiting space completes immediately" )
+        {
+            CHECK( notified );
+            CHECK( !spaceEc );
+        }
+    }
+
+    WHEN( "exceeding the high watermark" )
+    {
+        for (const auto& msg: messages)
+            f.client->send(msg);
+        CHECK( f.client->isTxBlocked() );
+        CHECK( f.client->txQueuedFrames() == 3 );
+        f.client->awaitTxSpace(
+            [&](std::error_code ec)
+            {
+                CHECK( f.client->txQueuedFrames() == 0 );
+                CHECK( f.client->txQueuedBytes() == 0 );
+                onSpace(ec);
+            });
+        CHECK_FALSE( notified );
+        CHECK_NOTHROW( f.run() );
+
+        THEN( "awaiting space completes once the queue drains" )
+        {
+            CHECK( notified );
+            CHECK( !spaceEc );
+        }
+    }
+
+    WHEN( "closing the transport while blocked" )
+    {
+        for (const auto& msg: messages)
+            f.client->send(msg);
+        REQUIRE( f.client->isTxBlocked() );
+        f.client->awaitTxSpace(onSpace);
+        f.client->close();
+        CHECK_NOTHROW( f.run() );
+
+        THEN( "awaiting space is aborted" )
+        {
+            CHECK( notified );
+            CHECK( spaceEc == TransportErrc::aborted );
+        }
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Prioritized transmission", "[Transport]" )
+{
+GIVEN( "a connected UDS transport pair" )
+{
+    UdsLoopbackFixture f;
+    const MessageBuffer first(4, 'a');
+    const MessageBuffer bulk1(4, 'b');
+    const MessageBuffer bulk2(4, 'c');
+    const MessageBuffer rpc(4, 'd');
+    const MessageBuffer control(4, 'e');
+    std::vector<MessageBuffer> received;
+
+    f.client->start([](ErrorOr<MessageBuffer>) {});
+    f.server->start(
+        [&](ErrorOr<MessageBuffer> buf)
+        {
+            if (!buf.has_value())
+                return;
+            received.push_back(std::move(*buf));
+            if (received.size() == 5)
+                f.disconnect();
+        });
+
+    WHEN( "queueing messages of various priorities behind a write" )
+    {
+        f.client->send(first, TxPriority::bulk);
+        f.client->send(bulk1, TxPriority::bulk);
+        f.client->send(bulk2, TxPriority::bulk);
+        f.client->send(rpc, TxPriority::rpc);
+        f.client->send(control, TxPriority::control);
+        CHECK_NOTHROW( f.run() );
+
+        THEN( "higher-priority messages overtake queued bulk messages" )
+        {
+            REQUIRE( received.size() == 5 );
+            CHECK( received[0] == first );
+            CHECK( received[1] == control );
+            CHECK( received[2] == rpc );
+            CHECK( received[3] == bulk1 );
+            CHECK( received[4] == bulk2 );
+        }
+    }
+
+    WHEN( "queueing messages of the same priority" )
+    {
+        f.client->send(first);
+        f.client->send(bulk1);
+        f.client->send(bulk2);
+        f.client->send(rpc);
+        f.client->send(control);
+        CHECK_NOTHROW( f.run() );
+
+        THEN( "they are sent in order" )
+        {
+            REQUIRE( received.size() == 5 );
+            CHECK( received[0] == first );
+            CHECK( received[1] == bulk1 );
+            CHECK( received[2] == bulk2 );
+            CHECK( received[3] == rpc );
+            CHECK( received[4] == control );
+        }
+    }
+}
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Read-ahead reception", "[Transport]" )
+{
+    using TcpFixture = LoopbackFixture<TcpRawsockConnector, TcpRawsockListener>;
+    using UdsFixture = LoopbackFixture<UdsRawsockConnector, UdsRawsockListener>;
+
+    // Batching on the sending side makes it likely that several frames,
+    // including partial ones, arrive within the same read.
+    auto opts = RawsockOptions{}.withRxBuffering(256).withTxBatching(16, 4096);
+    auto tcpClient = TcpHost{tcpLoopbackAddr, tcpTestPort}
+                         .withMaxRxLength(RML::kB_64)
+                         .withRawsockOptions(opts);
+    auto tcpServer = TcpEndpoint{tcpTestPort}.withMaxRxLength(RML::kB_64)
+                                             .withRawsockOptions(opts);
+    auto udsSettings = UdsPath{udsTestPath}.withMaxRxLength(RML::kB_64)
+                                           .withRawsockOptions(opts);
+
+    GIVEN( "a TCP connector/listener pair with read-ahead enabled" )
+    {
+        WHEN( "sending consecutive small messages" )
+        {
+            {
+                TcpFixture f(tcpClient, jsonId, tcpServer, CodecIds{jsonId});
+                checkConsecutiveSendReceive(f, f.client, f.server);
+            }
+            {
+                TcpFixture f(tcpClient, jsonId, tcpServer, CodecIds{jsonId});
+                checkConsecutiveSendReceive(f, f.server, f.client);
+            }
+        }
+        WHEN( "sending messages larger than the receive buffer" )
+        {
+            TcpFixture f(tcpClient, jsonId, tcpServer, CodecIds{jsonId});
+            const MessageBuffer message(f.client->info().maxRxLength, 'm');
+            const MessageBuffer reply(f.server->info().maxRxLength, 'r');
+            checkSendReply(f, message, reply);
+        }
+        WHEN( "sending zero length messages" )
+        {
+            TcpFixture f(tcpClient, jsonId, tcpServer, CodecIds{jsonId});
+            checkSendReply(f, MessageBuffer{}, MessageBuffer{});
+        }
+    }
+
+    GIVEN( "a UDS connector/listener pair with read-ahead enabled" )
+    {
+        WHEN( "sending consecutive small messages" )
+        {
+            {
+                UdsFixture f(udsSettings, jsonId, udsSettings,
+                             CodecIds{jsonId});
+                checkConsecutiveSendReceive(f, f.client, f.server);
+            }
+            {
+                UdsFixture f(udsSettings, jsonId, udsSettings,
+                             CodecIds{jsonId});
+                checkConsecutiveSendReceive(f, f.server, f.client);
+            }
+        }
+        WHEN( "sending messages larger than the receive buffer" )
+        {
+            UdsFixture f(udsSettings, jsonId, udsSettings, CodecIds{jsonId});
+            const MessageBuffer message(f.client->info().maxRxLength, 'm');
+            const MessageBuffer reply(f.server->info().maxRxLength, 'r');
+            checkSendReply(f, message, reply);
+        }
+        WHEN( "sending ping messages" )
+        {
+            UdsFixture f(udsSettings, jsonId, udsSettings, CodecIds{jsonId});
+            bool ponged = false;
+            f.client->start([](ErrorOr<MessageBuffer>) {});
+            f.server->start([](ErrorOr<MessageBuffer>) {});
+            f.client->ping(makeMessageBuffer("hello"),
+                [&](float elapsed)
+                {
+                    ponged = true;
+                    CHECK( elapsed >= 0 );
+                    f.disconnect();
+                });
+            CHECK_NOTHROW( f.run() );
+            CHECK( ponged );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEMPLATE_TEST_CASE( "Frame reuse during steady-state sends", "[Transport]",
+                    TcpLoopbackFixture, UdsLoopbackFixture )
+{
+    using Transport = typename TestType::Transport;
+
+    TestType f;
+    Transporting::Ptr sender = f.client;
+    auto transport = std::dynamic_pointer_cast<Transport>(sender);
+    REQUIRE( transport );
+    const auto message = makeMessageBuffer("Hello");
+    const size_t messageCount = 100;
+    size_t count = 0;
+
+    sender->start(
+        [&](ErrorOr<MessageBuffer> buf)
+        {
+            REQUIRE( !buf );
+            CHECK( buf.error() == TransportErrc::aborted );
+        });
+
+    f.server->start(
+        [&](ErrorOr<MessageBuffer> buf)
+        {
+            if (buf.has_value())
+            {
+                CHECK( message == *buf );
+                if (++count == messageCount)
+                    f.disconnect();
+                else
+                    sender->send(message);
+            }
+            else
+            {
+                CHECK( buf.error() == TransportErrc::aborted );
+            }
+        });
+
+    sender->send(message);
+    CHECK_NOTHROW( f.run() );
+
+    // Only the first frame(s) should need to be allocated; the rest are
+    // recycled from the pool once their writes complete.
+    CHECK( count == messageCount );
+    const auto& pool = transport->framePool();
+    CHECK( pool.allocationCount() <= 2 );
+    CHECK( pool.idleCount() <= pool.capacity() );
+}
+
+//------------------------------------------------------------------------------
+TEMPLATE_TEST_CASE( "Receive buffer reuse during steady-state receives",
+                    "[Transport]", TcpLoopbackFixture, UdsLoopbackFixture )
+{
+    using Transport = typename TestType::Transport;
+
+    TestType f;
+    Transporting::Ptr sender = f.client;
+    Transporting::Ptr receiver = f.server;
+    auto transport = std::dynamic_pointer_cast<Transport>(receiver);
+    REQUIRE( transport );
+    const auto message = makeMessageBuffer("Hello");
+    const size_t messageCount = 100;
+    size_t count = 0;
+
+    sender->start(
+        [&](ErrorOr<MessageBuffer> buf)
+        {
+            REQUIRE( !buf );
+            CHECK( buf.error() == TransportErrc::aborted );
+        });
+
+    receiver->start(
+        [&](ErrorOr<MessageBuffer> buf)
+        {
+            if (buf.has_value())
+            {
+                CHECK( message == *buf );
+                receiver->recycle(std::move(*buf));
+                if (++count == messageCount)
+                    f.disconnect();
+                else
+                    sender->send(message);
+            }
+            else
+            {
+                CHECK( buf.error() == TransportErrc::aborted );
+            }
+        });
+
+    sender->send(message);
+    CHECK_NOTHROW( f.run() );
+
+    // Once the first payload is recycled, subsequent messages should be
+    // received into that same storage.
+    CHECK( count == messageCount );
+    CHECK( transport->rxAllocationCount() <= 2 );
+}
+
+//------------------------------------------------------------------------------
+TEMPLATE_TEST_CASE( "Outbound buffer reuse during steady-state sends",
+                    "[Transport]", TcpLoopbackFixture, UdsLoopbackFixture )
+{
+    using Transport = typename TestType::Transport;
+
+    TestType f;
+    Transporting::Ptr sender = f.client;
+    auto transport = std::dynamic_pointer_cast<Transport>(sender);
+    REQUIRE( transport );
+    const auto message = makeMessageBuffer("Hello");
+    const size_t messageCount = 100;
+    size_t count = 0;
+
+    auto send = [&]()
+    {
+        auto buffer = sender->acquireBuffer();
+        CHECK( buffer.empty() );
+        CHECK( buffer.capacity() >= message.size() );
+        buffer.insert(buffer.end(), message.begin(), message.end());
+        sender->send(std::move(buffer));
+    };
+
+    sender->start(
+        [&](ErrorOr<MessageBuffer> buf)
+        {
+            REQUIRE( !buf );
+            CHECK( buf.error() == TransportErrc::aborted );
+        });
+
+    f.server->start(
+        [&](ErrorOr<MessageBuffer> buf)
+        {
+            if (buf.has_value())
+            {
+                CHECK( message == *buf );
+                if (++count == messageCount)
+                    f.disconnect();
+                else
+                    send();
+            }
+            else
+            {
+                CHECK( buf.error() == TransportErrc::aborted );
+            }
+        });
+
+    send();
+    CHECK_NOTHROW( f.run() );
+
+    // Buffers handed back after each write completes should be reused by
+    // subsequent calls to acquireBuffer.
+    CHECK( count == messageCount );
+    CHECK( transport->txAllocationCount() <= 2 );
+}
+
 //------------------------------------------------------------------------------
 TEMPLATE_TEST_CASE( "Maximum length messages", "[Transport]",
                     TcpLoopbackFixture, UdsLoopbackFixture )
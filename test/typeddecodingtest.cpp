@@ -0,0 +1,328 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cppwamp/cbor.hpp>
+#include <cppwamp/json.hpp>
+#include <cppwamp/msgpack.hpp>
+#include <cppwamp/peerdata.hpp>
+#include <cppwamp/typedencoding.hpp>
+#include <cppwamp/unpacker.hpp>
+#include <cppwamp/types/tuple.hpp>
+
+using namespace wamp;
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+struct Dto
+{
+    bool b = false;
+    int n = 0;
+    double x = 0.0;
+    std::string s;
+    std::vector<int> list;
+
+    bool operator==(const Dto& rhs) const
+    {
+        return b == rhs.b && n == rhs.n && x == rhs.x && s == rhs.s &&
+               list == rhs.list;
+    }
+};
+
+template <typename TConverter>
+void convert(TConverter& conv, Dto& dto)
+{
+    conv ("b", dto.b) ("n", dto.n) ("x", dto.x) ("s", dto.s)
+         ("list", dto.list, std::vector<int>{});
+}
+
+//------------------------------------------------------------------------------
+struct NestedDto
+{
+    std::vector<Dto> items;
+    std::map<String, Dto> byName;
+
+    bool operator==(const NestedDto& rhs) const
+    {
+        return items == rhs.items && byName == rhs.byName;
+    }
+
+private:
+    template <typename TConverter>
+    void convert(TConverter& conv)
+    {
+        conv ("items", items) ("byName", byName);
+    }
+
+    friend class wamp::ConversionAccess;
+};
+
+//------------------------------------------------------------------------------
+struct PointDto
+{
+    int x = 0;
+    int y = 0;
+
+    bool operator==(const PointDto& rhs) const
+    {
+        return x == rhs.x && y == rhs.y;
+    }
+};
+
+template <typename TConverter>
+void convert(TConverter& conv, PointDto& p)
+{
+    conv[p.x][p.y];
+}
+
+//------------------------------------------------------------------------------
+enum class Color {red, green, blue};
+
+//------------------------------------------------------------------------------
+template <typename TFormat, typename... Ts>
+Event makeEvent(const Ts&... args)
+{
+    Event event;
+    event.withEncodedPayload(encodeArgs<TFormat>(args...));
+    return event;
+}
+
+//------------------------------------------------------------------------------
+template <typename TFormat, typename... Ts>
+Invocation makeInvocation(const Ts&... args)
+{
+    Invocation inv;
+    inv.withEncodedPayload(encodeArgs<TFormat>(args...));
+    return inv;
+}
+
+//------------------------------------------------------------------------------
+template <typename TFormat>
+void checkUnpacking()
+{
+    Dto dto;
+    dto.b = true;
+    dto.n = 42;
+    dto.x = 1.5;
+    dto.s = "dto";
+    dto.list = {1, 2, 3};
+
+    NestedDto nested;
+    nested.items = {dto, Dto{}};
+    nested.byName = {{"a", dto}};
+
+    std::vector<PointDto> points{{1, 2}, {3, 4}};
+
+    WHEN( "unpacking event arguments" )
+    {
+        auto event = makeEvent<TFormat>(42, "hello", dto, nested, points,
+                                        Color::blue, Blob{0x01, 0xff});
+        bool called = false;
+        auto slot = unpackedEvent<int, std::string, Dto, NestedDto,
+                                  std::vector<PointDto>, Color, Blob>(
+            [&](Event ev, int n, std::string s, Dto d, NestedDto nd,
+                std::vector<PointDto> p, Color c, Blob b)
+            {
+                called = true;
+                CHECK( n == 42 );
+                CHECK( s == "hello" );
+                CHECK( d == dto );
+                CHECK( nd == nested );
+                CHECK( p == points );
+                CHECK( c == Color::blue );
+                CHECK( b == Blob{0x01, 0xff} );
+
+                // The arguments remain available in their encoded form
+                CHECK( ev.encodedPayload() );
+                CHECK( ev.args().size() == 7 );
+            });
+        slot(std::move(event));
+        CHECK( called );
+    }
+
+    WHEN( "unpacking event arguments to Variant types" )
+    {
+        auto event = makeEvent<TFormat>(null, Array{1, "two"},
+                                        Object{{"three", 3}}, 4u);
+        bool called = false;
+        auto slot = simpleEvent<Variant, Array, Object, Variant>(
+            [&](Variant v, Array a, Object o, Variant u)
+            {
+                called = true;
+                CHECK( v.is<Null>() );
+                CHECK( a == (Array{1, "two"}) );
+                CHECK( o == (Object{{"three", 3}}) );
+                CHECK( u == 4u );
+            });
+        slot(std::move(event));
+        CHECK( called );
+    }
+
+    WHEN( "unpacking extra event arguments" )
+    {
+        auto event = makeEvent<TFormat>(1, 2, 3);
+        bool called = false;
+        auto slot = simpleEvent<int, int>(
+            [&](int a, int b)
+            {
+                called = true;
+                CHECK( a == 1 );
+                CHECK( b == 2 );
+            });
+        slot(std::move(event));
+        CHECK( called );
+    }
+
+    WHEN( "unpacking invocation arguments" )
+    {
+        auto inv = makeInvocation<TFormat>(dto, std::string("name"));
+        auto slot = unpackedRpc<Dto, std::string>(
+            [&](Invocation, Dto d, std::string s) -> Outcome
+            {
+                CHECK( d == dto );
+                return {s};
+            });
+        auto outcome = slot(std::move(inv));
+        REQUIRE( outcome.type() == Outcome::Type::result );
+        CHECK( outcome.asResult().args() == Array{"name"} );
+    }
+
+    WHEN( "unpacking invocation arguments for a simple RPC" )
+    {
+        auto inv = makeInvocation<TFormat>(3, 4.5);
+        auto slot = simpleRpc<double, int, double>(
+            [](int a, double b) {return a + b;});
+        auto outcome = slot(std::move(inv));
+        REQUIRE( outcome.type() == Outcome::Type::result );
+        CHECK( outcome.asResult().args() == Array{7.5} );
+    }
+
+    WHEN( "unpacking an optional member that is missing" )
+    {
+        auto event = makeEvent<TFormat>(
+            Object{{"b", true}, {"n", 1}, {"x", 2.0}, {"s", "s"},
+                   {"unexpected", Array{Object{}}}});
+        Dto expected;
+        expected.b = true;
+        expected.n = 1;
+        expected.x = 2.0;
+        expected.s = "s";
+        bool called = false;
+        auto slot = simpleEvent<Dto>(
+            [&](Dto d)
+            {
+                called = true;
+                CHECK( d == expected );
+            });
+        slot(std::move(event));
+        CHECK( called );
+    }
+
+    WHEN( "unpacking too few arguments" )
+    {
+        auto event = makeEvent<TFormat>(1);
+        auto slot = simpleEvent<int, int>([](int, int) {FAIL();});
+        CHECK_THROWS_AS( slot(std::move(event)), Error );
+    }
+
+    WHEN( "unpacking arguments of the wrong type" )
+    {
+        auto event = makeEvent<TFormat>(1, "two");
+        auto slot = simpleEvent<int, int>([](int, int) {FAIL();});
+        CHECK_THROWS_AS( slot(std::move(event)), Error );
+    }
+
+    WHEN( "unpacking an object with a missing member" )
+    {
+        auto event = makeEvent<TFormat>(Object{{"b", true}});
+        auto slot = simpleEvent<Dto>([](Dto) {FAIL();});
+        CHECK_THROWS_AS( slot(std::move(event)), Error );
+    }
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "Typed decoding of unpacked arguments", "[Payload][Codec][Typed]" )
+{
+    GIVEN( "JSON encoded arguments" )
+    {
+        checkUnpacking<Json>();
+    }
+
+    GIVEN( "Msgpack encoded arguments" )
+    {
+        checkUnpacking<Msgpack>();
+    }
+
+    GIVEN( "CBOR encoded arguments" )
+    {
+        checkUnpacking<Cbor>();
+    }
+
+    GIVEN( "decoded arguments" )
+    {
+        Dto dto;
+        dto.n = 7;
+        Event event;
+        event.withArgs(1, dto);
+
+        bool called = false;
+        auto slot = simpleEvent<int, Dto>(
+            [&](int n, Dto d)
+            {
+                called = true;
+                CHECK( n == 1 );
+                CHECK( d == dto );
+            });
+        slot(std::move(event));
+        CHECK( called );
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Typed decoding cost", "[Codec][Typed][.benchmark]" )
+{
+    Dto dto;
+    dto.b = true;
+    dto.n = 42;
+    dto.x = 1.5;
+    dto.s = "The quick brown fox";
+    dto.list = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<Dto> dtos(16, dto);
+
+    using Args = std::tuple<std::vector<Dto>, std::string, int>;
+
+    BENCHMARK( "Via Variant" )
+    {
+        // Re-wraps the bytes so that the arguments are decoded every time.
+        Event event;
+        event.withEncodedPayload(encodeArgs<Json>(dtos, "label", 123));
+        Args args;
+        event.convertToTuple(args);
+        return args;
+    };
+
+    BENCHMARK( "Typed" )
+    {
+        Event event;
+        event.withEncodedPayload(encodeArgs<Json>(dtos, "label", 123));
+        Args args;
+        internal::unpackArgs(event, args);
+        return args;
+    };
+
+    BENCHMARK( "Encoding only" )
+    {
+        return encodeArgs<Json>(dtos, "label", 123);
+    };
+}
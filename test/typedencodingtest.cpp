@@ -0,0 +1,280 @@
+/*------------------------------------------------------------------------------
+    Copyright Butterfly Energy Systems 2022.
+    Distributed under the Boost Software License, Version 1.0.
+    http://www.boost.org/LICENSE_1_0.txt
+------------------------------------------------------------------------------*/
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cppwamp/cbor.hpp>
+#include <cppwamp/json.hpp>
+#include <cppwamp/msgpack.hpp>
+#include <cppwamp/peerdata.hpp>
+#include <cppwamp/typedencoding.hpp>
+#include <cppwamp/types/tuple.hpp>
+
+using namespace wamp;
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+struct FreeDto
+{
+    bool b;
+    int n;
+    double x;
+    std::string s;
+};
+
+template <typename TConverter>
+void convert(TConverter& conv, FreeDto& dto)
+{
+    conv ("b", dto.b) ("n", dto.n) ("x", dto.x) ("s", dto.s);
+}
+
+//------------------------------------------------------------------------------
+struct IntrusiveDto
+{
+    std::vector<FreeDto> items;
+    std::map<String, unsigned> counts;
+
+private:
+    template <typename TConverter>
+    void convert(TConverter& conv)
+    {
+        conv ("items", items) ("counts", counts);
+    }
+
+    friend class wamp::ConversionAccess;
+};
+
+//------------------------------------------------------------------------------
+struct PointDto
+{
+    int x;
+    int y;
+};
+
+template <typename TConverter>
+void convert(TConverter& conv, PointDto& p)
+{
+    conv.size(2);
+    conv[p.x][p.y];
+}
+
+//------------------------------------------------------------------------------
+struct SplitDto
+{
+    int n;
+};
+
+void convertFrom(FromVariantConverter& conv, SplitDto& dto)
+{
+    conv("n", dto.n);
+}
+
+void convertTo(ToVariantConverter& conv, const SplitDto& dto)
+{
+    conv("n", dto.n)("split", true);
+}
+
+CPPWAMP_CONVERSION_SPLIT_FREE(SplitDto)
+
+//------------------------------------------------------------------------------
+enum class Color {red, green, blue};
+
+//------------------------------------------------------------------------------
+template <typename TFormat, typename T>
+void checkTypedAs(const T& value, bool sameBytes)
+{
+    MessageBuffer expected;
+    encode<TFormat>(Variant::from(value), expected);
+    MessageBuffer typed;
+    encodeTyped<TFormat>(value, typed);
+
+    // Members of custom types are not sorted like those of Object.
+    if (sameBytes)
+        CHECK( typed == expected );
+
+    Variant v;
+    Variant w;
+    REQUIRE( !decode<TFormat>(expected, v) );
+    REQUIRE( !decode<TFormat>(typed, w) );
+    CHECK( w == v );
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void checkTyped(const T& value, bool sameBytes = true)
+{
+    INFO( "For value " << Variant::from(value) );
+    {
+        INFO( "Using JSON" );
+        checkTypedAs<Json>(value, sameBytes);
+    }
+    {
+        INFO( "Using Msgpack" );
+        checkTypedAs<Msgpack>(value, sameBytes);
+    }
+    {
+        INFO( "Using CBOR" );
+        checkTypedAs<Cbor>(value, sameBytes);
+    }
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SCENARIO( "Typed encoding", "[Variant][Codec][Typed]" )
+{
+    WHEN( "encoding values having a direct Variant counterpart" )
+    {
+        checkTyped(null);
+        checkTyped(false);
+        checkTyped(true);
+        checkTyped(0);
+        checkTyped(-42);
+        checkTyped(42u);
+        checkTyped(std::numeric_limits<Int>::min());
+        checkTyped(std::numeric_limits<UInt>::max());
+        checkTyped(short(-1));
+        checkTyped(1.5f);
+        checkTyped(-3.25);
+        checkTyped("");
+        checkTyped("Hello");
+        checkTyped(std::string("World"));
+        checkTyped(Blob{});
+        checkTyped(Blob{0x00, 0x01, 0xfe, 0xff});
+        checkTyped(Variant{Array{null, 1, "two", Object{{"three", 3.0}}}});
+    }
+
+    WHEN( "encoding standard containers" )
+    {
+        checkTyped(std::vector<int>{});
+        checkTyped(std::vector<int>{1, -2, 3});
+        checkTyped(std::vector<bool>{true, false, true});
+        checkTyped(std::vector<std::vector<String>>{{"a"}, {}, {"b", "c"}});
+        checkTyped(std::map<String, int>{});
+        checkTyped(std::map<String, double>{{"x", 1.0}, {"y", 2.0}});
+        checkTyped(std::make_tuple());
+        checkTyped(std::make_tuple(1, "two", 3.0, Blob{0x04}));
+        checkTyped(std::make_tuple(std::make_tuple(null), Array{true}));
+    }
+
+    WHEN( "encoding enumerators" )
+    {
+        checkTyped(Color::blue);
+    }
+
+    WHEN( "encoding custom types having generic conversions" )
+    {
+        FreeDto free{true, -7, 0.5, "free"};
+        IntrusiveDto intrusive;
+        intrusive.items.push_back(free);
+        intrusive.items.push_back({false, 8, -0.5, "other"});
+        intrusive.counts = {{"a", 1}, {"b", 2}};
+
+        checkTyped(free, false);
+        checkTyped(intrusive, false);
+        checkTyped(PointDto{3, -4});
+        checkTyped(std::vector<PointDto>{{1, 2}, {3, 4}});
+        checkTyped(std::make_tuple(PointDto{5, 6}, free), false);
+    }
+
+    WHEN( "encoding custom types having split conversions" )
+    {
+        checkTyped(SplitDto{12});
+        checkTyped(std::vector<SplitDto>{{1}, {2}});
+    }
+
+    WHEN( "encoding to a string" )
+    {
+        std::string text = "prefix:";
+        encodeTyped<Json>(std::make_tuple(1, "two"), text);
+        CHECK( text == R"(prefix:[1,"two"])" );
+    }
+}
+
+//------------------------------------------------------------------------------
+SCENARIO( "Typed payloads", "[Payload][Codec][Typed]" )
+{
+    FreeDto dto{true, 42, 1.5, "dto"};
+    Variant dtoVariant = Variant::from(dto);
+
+    WHEN( "setting typed positional arguments" )
+    {
+        Rpc rpc("procedure");
+        rpc.withEncodedPayload(encodeArgs<Json>(1, "two", dto));
+
+        THEN( "the arguments are decoded on demand" )
+        {
+            CHECK( rpc.encodedPayload() );
+            CHECK( rpc.args() == (Array{1, "two", dtoVariant}) );
+            CHECK( rpc.kwargs().empty() );
+        }
+    }
+
+    WHEN( "setting typed positional and keyword arguments" )
+    {
+        for (int codecId: {KnownCodecIds::json(), KnownCodecIds::msgpack(),
+                           KnownCodecIds::cbor()})
+        {
+            INFO( "For codec ID " << codecId );
+            auto args = std::make_tuple(PointDto{1, 2}, Color::green);
+            std::map<String, FreeDto> kwargs{{"dto", dto}};
+
+            EncodedPayload payload;
+            if (codecId == KnownCodecIds::json())
+                payload = encodeArgsTuple<Json>(args, kwargs);
+            else if (codecId == KnownCodecIds::msgpack())
+                payload = encodeArgsTuple<Msgpack>(args, kwargs);
+            else
+                payload = encodeArgsTuple<Cbor>(args, kwargs);
+
+            Event event;
+            event.withEncodedPayload(payload);
+            CHECK( event.args() == (Array{Array{1, 2}, 1}) );
+            CHECK( event.kwargs() == (Object{{"dto", dtoVariant}}) );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST_CASE( "Typed encoding cost", "[Codec][Typed][.benchmark]" )
+{
+    const std::string text = "The quick brown fox";
+    FreeDto dto{true, 42, 1.5, text};
+
+    BENCHMARK( "Variant args" )
+    {
+        MessageBuffer buffer;
+        encode<Json>(Array{Array{42, 3.14, text}}, buffer);
+        return buffer;
+    };
+
+    BENCHMARK( "Typed args" )
+    {
+        MessageBuffer buffer;
+        encodeTyped<Json>(std::make_tuple(std::make_tuple(42, 3.14, text)),
+                          buffer);
+        return buffer;
+    };
+
+    BENCHMARK( "Variant struct" )
+    {
+        MessageBuffer buffer;
+        encode<Json>(Array{Array{Variant::from(dto)}}, buffer);
+        return buffer;
+    };
+
+    BENCHMARK( "Typed struct" )
+    {
+        MessageBuffer buffer;
+        encodeTyped<Json>(std::make_tuple(std::make_tuple(dto)), buffer);
+        return buffer;
+    };
+}